@@ -31,6 +31,10 @@ echo copy PluginRSP
 xcopy "%base_dir%/Source/Android/PluginRSP" "%base_dir%/Android/jni/PluginRSP/" /D /I /F /Y /E
 IF %ERRORLEVEL% NEQ 0 (exit /B 1)
 
+echo copy Project64-bench
+xcopy "%base_dir%/Source/Android/Bench" "%base_dir%/Android/jni/Project64-bench/" /D /I /F /Y /E
+IF %ERRORLEVEL% NEQ 0 (exit /B 1)
+
 echo copy Project64-bridge
 xcopy "%base_dir%/Source/Android/Bridge" "%base_dir%/Android/jni/Project64-bridge/" /D /I /F /Y /E
 IF %ERRORLEVEL% NEQ 0 (exit /B 1)
@@ -24,6 +24,7 @@ include $(JNI_LOCAL_PATH)/Common/common.mk
 include $(JNI_LOCAL_PATH)/PluginInput/PluginInput.mk
 include $(JNI_LOCAL_PATH)/PluginRSP/PluginRSP.mk
 include $(JNI_LOCAL_PATH)/Project64-audio/Project64-audio.mk
+include $(JNI_LOCAL_PATH)/Project64-bench/Project64-bench.mk
 include $(JNI_LOCAL_PATH)/Project64-bridge/Project64-bridge.mk
 include $(JNI_LOCAL_PATH)/Project64-core/Project64-core.mk
 include $(JNI_LOCAL_PATH)/Project64-video/Project64-video.mk
@@ -11,6 +11,7 @@ LOCAL_C_INCLUDES := ../     \
     $(SDL_INCLUDES)         \
                
 LOCAL_SRC_FILES := \
+    $(SRCDIR)/ByteSwap.cpp               \
     $(SRCDIR)/CriticalSection.cpp        \
     $(SRCDIR)/DateTimeClass.cpp          \
     $(SRCDIR)/FileClass.cpp              \
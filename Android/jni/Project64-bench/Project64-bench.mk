@@ -0,0 +1,68 @@
+######################
+# Project64-bench
+######################
+include $(CLEAR_VARS)
+LOCAL_PATH := $(JNI_LOCAL_PATH)
+SRCDIR := ./Project64-bench
+
+LOCAL_MODULE := Project64-bench
+LOCAL_STATIC_LIBRARIES := common  \
+      Project64-core              \
+      zlib                        \
+
+LOCAL_C_INCLUDES :=
+
+LOCAL_SRC_FILES :=                   \
+    $(SRCDIR)/main.cpp               \
+    $(SRCDIR)/Notification.cpp       \
+
+LOCAL_CFLAGS := $(COMMON_CFLAGS)
+
+LOCAL_CPPFLAGS := $(COMMON_CPPFLAGS)
+
+LOCAL_LDLIBS :=         \
+    -llog               \
+    -ldl                \
+    -latomic            \
+
+include $(BUILD_EXECUTABLE)
+
+######################
+# Project64-gfx-null
+######################
+include $(CLEAR_VARS)
+LOCAL_PATH := $(JNI_LOCAL_PATH)
+SRCDIR := ./Project64-bench
+
+LOCAL_MODULE := Project64-gfx-null
+
+LOCAL_C_INCLUDES :=
+
+LOCAL_SRC_FILES :=             \
+    $(SRCDIR)/NullGfx.cpp      \
+
+LOCAL_CFLAGS := $(COMMON_CFLAGS)
+
+LOCAL_CPPFLAGS := $(COMMON_CPPFLAGS)
+
+include $(BUILD_SHARED_LIBRARY)
+
+######################
+# Project64-audio-null
+######################
+include $(CLEAR_VARS)
+LOCAL_PATH := $(JNI_LOCAL_PATH)
+SRCDIR := ./Project64-bench
+
+LOCAL_MODULE := Project64-audio-null
+
+LOCAL_C_INCLUDES :=
+
+LOCAL_SRC_FILES :=             \
+    $(SRCDIR)/NullAudio.cpp    \
+
+LOCAL_CFLAGS := $(COMMON_CFLAGS)
+
+LOCAL_CPPFLAGS := $(COMMON_CPPFLAGS)
+
+include $(BUILD_SHARED_LIBRARY)
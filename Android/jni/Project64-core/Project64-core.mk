@@ -39,12 +39,15 @@ LOCAL_SRC_FILES :=                                                     \
     $(SRCDIR)/N64System/Mips/Rumblepak.cpp                             \
     $(SRCDIR)/N64System/Mips/Transferpak.cpp                           \
     $(SRCDIR)/N64System/Mips/Sram.cpp                                  \
+    $(SRCDIR)/N64System/Mips/SaveChip.cpp                              \
     $(SRCDIR)/N64System/Mips/SystemEvents.cpp                          \
     $(SRCDIR)/N64System/Mips/SystemTiming.cpp                          \
     $(SRCDIR)/N64System/Mips/TLBclass.cpp                              \
     $(SRCDIR)/N64System/Recompiler/CodeBlock.cpp                       \
     $(SRCDIR)/N64System/Recompiler/CodeSection.cpp                     \
+    $(SRCDIR)/N64System/Recompiler/CompiledFuncList.cpp                \
     $(SRCDIR)/N64System/Recompiler/SectionInfo.cpp                     \
+    $(SRCDIR)/N64System/Recompiler/BlockProfiler.cpp                   \
     $(SRCDIR)/N64System/Recompiler/FunctionInfo.cpp                    \
     $(SRCDIR)/N64System/Recompiler/FunctionMapClass.cpp                \
     $(SRCDIR)/N64System/Recompiler/LoopAnalysis.cpp                    \
@@ -62,6 +65,9 @@ LOCAL_SRC_FILES :=                                                     \
     $(SRCDIR)/N64System/FramePerSecondClass.cpp                        \
     $(SRCDIR)/N64System/N64Class.cpp                                   \
     $(SRCDIR)/N64System/N64RomClass.cpp                                \
+    $(SRCDIR)/N64System/SaveStateBase.cpp                              \
+    $(SRCDIR)/N64System/SaveStateWriter.cpp                            \
+    $(SRCDIR)/N64System/RewindBuffer.cpp                               \
     $(SRCDIR)/N64System/ProfilingClass.cpp                             \
     $(SRCDIR)/N64System/SpeedLimiterClass.cpp                          \
     $(SRCDIR)/N64System/SystemGlobals.cpp                              \
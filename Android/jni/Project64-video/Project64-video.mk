@@ -1,21 +1,7 @@
 ###############################
-# Project64-gfx-Project64
+# Sources shared by the GLES and headless renderers
 ###############################
-include $(CLEAR_VARS)
-LOCAL_PATH := $(JNI_LOCAL_PATH)
-SRCDIR := ./
-
-LOCAL_MODULE := Project64-gfx
-LOCAL_STATIC_LIBRARIES := common                \
-                          zlib                  \
-                          Settings              \
-                          png                   \
-
-LOCAL_C_INCLUDES :=                             \
-    $(LOCAL_PATH)/$(SRCDIR)/Project64-video/Renderer/inc        \
-    $(LOCAL_PATH)/$(SRCDIR)/3rdParty            \
-
-LOCAL_SRC_FILES :=                              \
+VIDEO_SRC_FILES =                              \
     $(SRCDIR)/Project64-video/3dmath.cpp                \
     $(SRCDIR)/Project64-video/Android.cpp               \
     $(SRCDIR)/Project64-video/Combine.cpp               \
@@ -48,12 +34,6 @@ LOCAL_SRC_FILES :=                              \
     $(SRCDIR)/Project64-video/ucodeFB.cpp                  \
     $(SRCDIR)/Project64-video/Util.cpp                  \
     $(SRCDIR)/Project64-video/Ext_TxFilter.cpp          \
-    $(SRCDIR)/Project64-video/Renderer/OGLEScombiner.cpp        \
-    $(SRCDIR)/Project64-video/Renderer/OGLESgeometry.cpp        \
-    $(SRCDIR)/Project64-video/Renderer/OGLESglitchmain.cpp      \
-    $(SRCDIR)/Project64-video/Renderer/OGLEStextures.cpp        \
-    $(SRCDIR)/Project64-video/Renderer/OGLESwrappers.cpp        \
-    $(SRCDIR)/Project64-video/Renderer/Renderer.cpp        \
     $(SRCDIR)/Project64-video/TextureEnhancer/TxFilterExport.cpp        \
     $(SRCDIR)/Project64-video/TextureEnhancer/TxFilter.cpp              \
     $(SRCDIR)/Project64-video/TextureEnhancer/TxCache.cpp               \
@@ -73,6 +53,32 @@ LOCAL_SRC_FILES :=                              \
     $(SRCDIR)/Project64-video/TextureEnhancer/tc-1.1+/wrapper.c         \
     $(SRCDIR)/Project64-video/TextureEnhancer/tc-1.1+/texstore.c        \
 
+###############################
+# Project64-gfx-Project64
+###############################
+include $(CLEAR_VARS)
+LOCAL_PATH := $(JNI_LOCAL_PATH)
+SRCDIR := ./
+
+LOCAL_MODULE := Project64-gfx
+LOCAL_STATIC_LIBRARIES := common                \
+                          zlib                  \
+                          Settings              \
+                          png                   \
+
+LOCAL_C_INCLUDES :=                             \
+    $(LOCAL_PATH)/$(SRCDIR)/Project64-video/Renderer/inc        \
+    $(LOCAL_PATH)/$(SRCDIR)/3rdParty            \
+
+LOCAL_SRC_FILES :=                              \
+    $(VIDEO_SRC_FILES)                                  \
+    $(SRCDIR)/Project64-video/Renderer/OGLEScombiner.cpp        \
+    $(SRCDIR)/Project64-video/Renderer/OGLESgeometry.cpp        \
+    $(SRCDIR)/Project64-video/Renderer/OGLESglitchmain.cpp      \
+    $(SRCDIR)/Project64-video/Renderer/OGLEStextures.cpp        \
+    $(SRCDIR)/Project64-video/Renderer/OGLESwrappers.cpp        \
+    $(SRCDIR)/Project64-video/Renderer/Renderer.cpp        \
+
 LOCAL_CFLAGS :=         \
     $(COMMON_CFLAGS)    \
     -DUSE_FRAMESKIPPER  \
@@ -97,4 +103,50 @@ ifeq ($(TARGET_ARCH_ABI), armeabi-v7a)
     
 endif
 
-include $(BUILD_SHARED_LIBRARY)
\ No newline at end of file
+include $(BUILD_SHARED_LIBRARY)
+
+###############################
+# Project64-gfx-headless
+###############################
+include $(CLEAR_VARS)
+LOCAL_PATH := $(JNI_LOCAL_PATH)
+SRCDIR := ./
+
+LOCAL_MODULE := Project64-gfx-headless
+LOCAL_STATIC_LIBRARIES := common                \
+                          zlib                  \
+                          Settings              \
+                          png                   \
+
+LOCAL_C_INCLUDES :=                             \
+    $(LOCAL_PATH)/$(SRCDIR)/Project64-video/Renderer/inc        \
+    $(LOCAL_PATH)/$(SRCDIR)/3rdParty            \
+
+LOCAL_SRC_FILES :=                              \
+    $(VIDEO_SRC_FILES)                                  \
+    $(SRCDIR)/Project64-video/Renderer/HeadlessRenderer.cpp     \
+    $(SRCDIR)/Project64-video/Renderer/Renderer.cpp        \
+
+LOCAL_CFLAGS :=         \
+    $(COMMON_CFLAGS)    \
+    -DUSE_FRAMESKIPPER  \
+    -DNOSSE             \
+    -fsigned-char       \
+    
+LOCAL_CPPFLAGS := $(COMMON_CPPFLAGS)
+    
+LOCAL_CPP_FEATURES := exceptions
+
+LOCAL_LDLIBS :=         \
+    -ldl                \
+    -llog               \
+    -latomic            \
+
+ifeq ($(TARGET_ARCH_ABI), armeabi-v7a)
+    # Use for ARM7a:
+    LOCAL_CFLAGS += -mfpu=vfp
+    LOCAL_CFLAGS += -mfloat-abi=softfp
+    
+endif
+
+include $(BUILD_SHARED_LIBRARY)
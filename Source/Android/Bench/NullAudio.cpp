@@ -0,0 +1,56 @@
+// Audio plugin that discards all samples, buffers complete immediately
+
+#include "NullPlugins.h"
+#include <string.h>
+#include <stdio.h>
+
+static AUDIO_INFO g_AudioInfo;
+
+EXPORT void CALL GetDllInfo(PLUGIN_INFO * PluginInfo)
+{
+    PluginInfo->Version = 0x0101;
+    PluginInfo->Type = PLUGIN_TYPE_AUDIO;
+    snprintf(PluginInfo->Name, sizeof(PluginInfo->Name), "Null Audio Plugin");
+    PluginInfo->NormalMemory = false;
+    PluginInfo->MemoryBswaped = true;
+}
+
+EXPORT int32_t CALL InitiateAudio(AUDIO_INFO Audio_Info)
+{
+    g_AudioInfo = Audio_Info;
+    return true;
+}
+
+EXPORT void CALL AiDacrateChanged(int32_t /*SystemType*/)
+{
+}
+
+EXPORT void CALL AiLenChanged(void)
+{
+}
+
+EXPORT uint32_t CALL AiReadLength(void)
+{
+    return 0;
+}
+
+EXPORT void CALL AiUpdate(int32_t /*Wait*/)
+{
+}
+
+EXPORT void CALL CloseDLL(void)
+{
+    memset(&g_AudioInfo, 0, sizeof(g_AudioInfo));
+}
+
+EXPORT void CALL ProcessAList(void)
+{
+}
+
+EXPORT void CALL RomClosed(void)
+{
+}
+
+EXPORT void CALL RomOpen(void)
+{
+}
@@ -0,0 +1,63 @@
+// Graphics plugin that draws nothing, so benchmarks measure the core and not the renderer
+
+#include "NullPlugins.h"
+#include <string.h>
+#include <stdio.h>
+
+static GFX_INFO g_GfxInfo;
+
+EXPORT void CALL GetDllInfo(PLUGIN_INFO * PluginInfo)
+{
+    PluginInfo->Version = 0x0103;
+    PluginInfo->Type = PLUGIN_TYPE_GFX;
+    snprintf(PluginInfo->Name, sizeof(PluginInfo->Name), "Null Graphics Plugin");
+    PluginInfo->NormalMemory = false;
+    PluginInfo->MemoryBswaped = true;
+}
+
+EXPORT int32_t CALL InitiateGFX(GFX_INFO Gfx_Info)
+{
+    g_GfxInfo = Gfx_Info;
+    return true;
+}
+
+EXPORT void CALL CaptureScreen(const char * /*Directory*/)
+{
+}
+
+EXPORT void CALL ChangeWindow(void)
+{
+}
+
+EXPORT void CALL CloseDLL(void)
+{
+    memset(&g_GfxInfo, 0, sizeof(g_GfxInfo));
+}
+
+// Display lists are dropped, the full sync interrupt is still raised so the game keeps running
+EXPORT void CALL ProcessDList(void)
+{
+    *g_GfxInfo.MI_INTR_REG |= MI_INTR_DP;
+    g_GfxInfo.CheckInterrupts();
+}
+
+EXPORT void CALL ProcessRDPList(void)
+{
+    *g_GfxInfo.DPC_CURRENT_REG = *g_GfxInfo.DPC_END_REG;
+}
+
+EXPORT void CALL RomClosed(void)
+{
+}
+
+EXPORT void CALL RomOpen(void)
+{
+}
+
+EXPORT void CALL ShowCFB(void)
+{
+}
+
+EXPORT void CALL UpdateScreen(void)
+{
+}
@@ -0,0 +1,101 @@
+// Minimal graphics 1.3 and audio 1.1 plugin specs, only what the null plugins use
+
+#pragma once
+
+#include <stdint.h>
+
+enum
+{
+    PLUGIN_TYPE_GFX = 2,
+    PLUGIN_TYPE_AUDIO = 3,
+};
+
+#if defined(_WIN32)
+#define EXPORT      extern "C" __declspec(dllexport)
+#define CALL        __cdecl
+#else
+#define EXPORT      extern "C" __attribute__((visibility("default")))
+#define CALL
+#endif
+
+enum
+{
+    MI_INTR_AI = 0x04,      // Bit 2: AI INTR
+    MI_INTR_DP = 0x20,      // Bit 5: DP INTR
+};
+
+typedef struct
+{
+    uint16_t Version;        // Set to 0x0103 for graphics, 0x0101 for audio
+    uint16_t Type;           // Set to PLUGIN_TYPE_GFX or PLUGIN_TYPE_AUDIO
+    char Name[100];          // Name of the DLL
+    int32_t NormalMemory;
+    int32_t MemoryBswaped;
+} PLUGIN_INFO;
+
+typedef struct
+{
+    void * hWnd;            // Render window
+    void * hStatusBar;      // If render window does not have a status bar then this is NULL
+
+    int32_t MemoryBswaped;
+
+    uint8_t * HEADER;
+    uint8_t * RDRAM;
+    uint8_t * DMEM;
+    uint8_t * IMEM;
+
+    uint32_t * MI_INTR_REG;
+
+    uint32_t * DPC_START_REG;
+    uint32_t * DPC_END_REG;
+    uint32_t * DPC_CURRENT_REG;
+    uint32_t * DPC_STATUS_REG;
+    uint32_t * DPC_CLOCK_REG;
+    uint32_t * DPC_BUFBUSY_REG;
+    uint32_t * DPC_PIPEBUSY_REG;
+    uint32_t * DPC_TMEM_REG;
+
+    uint32_t * VI_STATUS_REG;
+    uint32_t * VI_ORIGIN_REG;
+    uint32_t * VI_WIDTH_REG;
+    uint32_t * VI_INTR_REG;
+    uint32_t * VI_V_CURRENT_LINE_REG;
+    uint32_t * VI_TIMING_REG;
+    uint32_t * VI_V_SYNC_REG;
+    uint32_t * VI_H_SYNC_REG;
+    uint32_t * VI_LEAP_REG;
+    uint32_t * VI_H_START_REG;
+    uint32_t * VI_V_START_REG;
+    uint32_t * VI_V_BURST_REG;
+    uint32_t * VI_X_SCALE_REG;
+    uint32_t * VI_Y_SCALE_REG;
+
+    void(CALL *CheckInterrupts)(void);
+#ifdef ANDROID
+    void(CALL *SwapBuffers)(void);
+#endif
+} GFX_INFO;
+
+typedef struct
+{
+    void * hwnd;
+    void * hinst;
+
+    int32_t MemoryBswaped;
+    uint8_t * HEADER;
+    uint8_t * RDRAM;
+    uint8_t * DMEM;
+    uint8_t * IMEM;
+
+    uint32_t * MI_INTR_REG;
+
+    uint32_t * AI_DRAM_ADDR_REG;
+    uint32_t * AI_LEN_REG;
+    uint32_t * AI_CONTROL_REG;
+    uint32_t * AI_STATUS_REG;
+    uint32_t * AI_DACRATE_REG;
+    uint32_t * AI_BITRATE_REG;
+
+    void(CALL *CheckInterrupts)(void);
+} AUDIO_INFO;
@@ -0,0 +1,503 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <map>
+#include <vector>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#include "Notification.h"
+#include <Project64-core/AppInit.h>
+#include <Project64-core/Settings.h>
+#include <Project64-core/Settings/GameSettings.h>
+#include <Project64-core/N64System/N64System.h>
+#include <Project64-core/N64System/SystemGlobals.h>
+#include <Common/ByteSwap.h>
+#include <Common/HighResTimeStamp.h>
+#include <Common/StdString.h>
+#include <Common/Util.h>
+
+// Runs a ROM without a window for a fixed number of frames or timer cycles and reports
+// emulation speed, so changes to the CPU cores can be compared from the command line.
+
+class CHostInstructionCounter
+{
+public:
+    CHostInstructionCounter() :
+        m_fd(-1)
+    {
+        perf_event_attr Attr;
+        memset(&Attr, 0, sizeof(Attr));
+        Attr.type = PERF_TYPE_HARDWARE;
+        Attr.size = sizeof(Attr);
+        Attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+        Attr.disabled = 1;
+        Attr.inherit = 1; // Count the emulation threads started after this
+        Attr.exclude_kernel = 1;
+        Attr.exclude_hv = 1;
+        m_fd = (int)syscall(__NR_perf_event_open, &Attr, 0, -1, -1, 0);
+    }
+
+    ~CHostInstructionCounter()
+    {
+        if (m_fd != -1)
+        {
+            close(m_fd);
+        }
+    }
+
+    bool Available() const { return m_fd != -1; }
+    void Start() { if (m_fd != -1) { ioctl(m_fd, PERF_EVENT_IOC_RESET, 0); ioctl(m_fd, PERF_EVENT_IOC_ENABLE, 0); } }
+    void Stop() { if (m_fd != -1) { ioctl(m_fd, PERF_EVENT_IOC_DISABLE, 0); } }
+
+    uint64_t Count() const
+    {
+        uint64_t Value = 0;
+        if (m_fd == -1 || read(m_fd, &Value, sizeof(Value)) != sizeof(Value))
+        {
+            return 0;
+        }
+        return Value;
+    }
+
+private:
+    CHostInstructionCounter(const CHostInstructionCounter&);
+    CHostInstructionCounter& operator=(const CHostInstructionCounter&);
+
+    int m_fd;
+};
+
+static void Usage(const char * Program)
+{
+    fprintf(stderr, "Usage: %s [options] <rom>\n", Program);
+    fprintf(stderr, "  -cpu interpreter|recompiler   CPU core to benchmark (default recompiler)\n");
+    fprintf(stderr, "  -frames <count>               Stop after this many vertical interrupts (default 1800)\n");
+    fprintf(stderr, "  -cycles <count>               Stop after this many timer cycles\n");
+    fprintf(stderr, "  -rewind <interval>            Capture a rewind snapshot every <interval> VIs\n");
+    fprintf(stderr, "  -rewindtest                   Halfway through the frame budget rewind three snapshots one at a time, checking PC and RDRAM against each (needs -rewind)\n");
+    fprintf(stderr, "  -gfx null|headless            Video plugin, headless runs the display lists and checksums each frame (default null)\n");
+    fprintf(stderr, "  -basedir <dir>                Directory holding Config, Plugin and Save (default current)\n");
+    fprintf(stderr, "  -verbose                      Print emulator messages\n");
+    fprintf(stderr, "  -funcindex                    After the run, time compiled block lookups against a std::map of the same blocks\n");
+    fprintf(stderr, "  -byteswap                     Time the byte swap kernels on a 64 MB image instead of running a ROM\n");
+}
+
+static int ByteSwapBenchmark(void)
+{
+    enum { ImageSize = 64 * 1024 * 1024, Passes = 8 };
+    std::vector<uint8_t> Image(ImageSize);
+    for (size_t i = 0; i < Image.size(); i++)
+    {
+        Image[i] = (uint8_t)i;
+    }
+
+    const BYTESWAP_KERNEL * Kernels;
+    size_t Count = ByteSwapKernels(&Kernels);
+    for (size_t i = 0; i < Count; i++)
+    {
+        for (int Half = 0; Half < 2; Half++)
+        {
+            HighResTimeStamp StartTime, EndTime;
+            StartTime.SetToNow();
+            for (int Pass = 0; Pass < Passes; Pass++)
+            {
+                (Half ? Kernels[i].HalfSwap32 : Kernels[i].ByteSwap32)(&Image[0], Image.size());
+            }
+            EndTime.SetToNow();
+
+            uint64_t ElapsedTime = EndTime.GetMicroSeconds() - StartTime.GetMicroSeconds();
+            printf("%-8s%-12s%8.1f MB/s\n", Kernels[i].Name, Half ? "HalfSwap32" : "ByteSwap32", ElapsedTime != 0 ? (double)ImageSize * Passes / ElapsedTime : 0.0);
+        }
+    }
+    printf("Default: %s\n", Kernels[Count - 1].Name);
+    return 0;
+}
+
+static void FunctionIndexBenchmark(const CCompiledFuncList & Functions)
+{
+    enum { Passes = 64 };
+
+    // The same entry addresses in the layout the list replaced, plus one miss per block
+    std::vector<uint32_t> Lookups;
+    std::map<uint32_t, CCompiledFunc *> FunctionMap;
+    for (uint32_t i = 0, n = Functions.Capacity(); i < n; i++)
+    {
+        CCompiledFunc * Func = Functions.Chain(i);
+        if (Func != nullptr)
+        {
+            FunctionMap[Func->EnterPC()] = Func;
+            Lookups.push_back(Func->EnterPC());
+            Lookups.push_back(Func->EnterPC() + 2);
+        }
+    }
+    if (Lookups.empty())
+    {
+        printf("Func index:    no compiled blocks\n");
+        return;
+    }
+    for (size_t i = Lookups.size() - 1; i > 0; i--)
+    {
+        size_t j = (size_t)rand() % (i + 1);
+        uint32_t Temp = Lookups[i];
+        Lookups[i] = Lookups[j];
+        Lookups[j] = Temp;
+    }
+
+    size_t Found = 0;
+    HighResTimeStamp StartTime, EndTime;
+    StartTime.SetToNow();
+    for (int Pass = 0; Pass < Passes; Pass++)
+    {
+        for (size_t i = 0, n = Lookups.size(); i < n; i++)
+        {
+            Found += Functions.Find(Lookups[i]) != nullptr ? 1 : 0;
+        }
+    }
+    EndTime.SetToNow();
+    uint64_t ListTime = EndTime.GetMicroSeconds() - StartTime.GetMicroSeconds();
+
+    StartTime.SetToNow();
+    for (int Pass = 0; Pass < Passes; Pass++)
+    {
+        for (size_t i = 0, n = Lookups.size(); i < n; i++)
+        {
+            Found += FunctionMap.find(Lookups[i]) != FunctionMap.end() ? 1 : 0;
+        }
+    }
+    EndTime.SetToNow();
+    uint64_t MapTime = EndTime.GetMicroSeconds() - StartTime.GetMicroSeconds();
+
+    double Count = (double)Lookups.size() * Passes;
+    printf("Func index:    %d blocks, %d found\n", (uint32_t)FunctionMap.size(), (uint32_t)(Found / (2 * Passes)));
+    printf("  hash table:  %.1f ns per lookup\n", ListTime * 1000.0 / Count);
+    printf("  std::map:    %.1f ns per lookup\n", MapTime * 1000.0 / Count);
+}
+
+struct REWIND_TEST_STATE
+{
+    uint32_t PC;
+    std::vector<uint8_t> Rdram;
+};
+
+// Waits until the CPU is paused with at least Rewinds rewinds done, false if emulation stopped or it took too long
+static bool WaitForRewindPause(uint32_t Rewinds)
+{
+    const CRewindBuffer & Buffer = g_BaseSystem->RewindBuffer();
+    for (uint32_t Wait = 0; Wait < 10000; Wait++)
+    {
+        if (!g_Settings->LoadBool(GameRunning_CPU_Running))
+        {
+            return false;
+        }
+        if (Buffer.Rewinds() >= Rewinds && g_Settings->LoadBool(GameRunning_CPU_Paused))
+        {
+            return true;
+        }
+        pjutil::Sleep(1);
+    }
+    return false;
+}
+
+// From a pause, rewinds and pauses again straight after the snapshot is loaded. The pause is queued first as the
+// rest of the event batch is skipped once a state has been loaded.
+static bool RewindFromPause(uint32_t Frames)
+{
+    uint32_t Rewinds = g_BaseSystem->RewindBuffer().Rewinds();
+    g_BaseSystem->ExternalEvent(SysEvent_PauseCPU_FromMenu);
+    g_BaseSystem->Rewind(Frames);
+    g_BaseSystem->ExternalEvent(SysEvent_ResumeCPU_FromMenu);
+    return WaitForRewindPause(Rewinds + 1);
+}
+
+static void ReadRewindTestState(REWIND_TEST_STATE & State)
+{
+    State.PC = g_Reg->m_PROGRAM_COUNTER;
+    State.Rdram.assign(g_MMU->Rdram(), g_MMU->Rdram() + g_Settings->LoadDword(Game_RDRamSize));
+}
+
+// Records the state held in Steps + 1 consecutive snapshots by loading each while it is the newest, then steps
+// back through them one rewind at a time and checks PC and RDRAM match what was recorded for that snapshot
+static bool RunRewindTest(uint32_t RewindInterval, uint32_t Steps, std::string & Result)
+{
+    const CRewindBuffer & Buffer = g_BaseSystem->RewindBuffer();
+    std::vector<REWIND_TEST_STATE> States;
+    uint32_t Captures = 0;
+
+    g_BaseSystem->ExternalEvent(SysEvent_PauseCPU_FromMenu);
+    bool Paused = WaitForRewindPause(0);
+    while (Paused)
+    {
+        // Rewinding a single interval reloads the newest snapshot without dropping it
+        if (!RewindFromPause(RewindInterval))
+        {
+            Paused = false;
+            break;
+        }
+        if (!States.empty() && Buffer.Captures() != Captures + 1)
+        {
+            // A snapshot was taken while the pause was pending, start again from this one
+            States.clear();
+        }
+        Captures = Buffer.Captures();
+        States.resize(States.size() + 1);
+        ReadRewindTestState(States.back());
+        if (States.size() > Steps)
+        {
+            break;
+        }
+
+        g_BaseSystem->ExternalEvent(SysEvent_ResumeCPU_FromMenu);
+        for (uint32_t Wait = 0; Buffer.Captures() == Captures && g_Settings->LoadBool(GameRunning_CPU_Running) && Wait < 10000; Wait++)
+        {
+            pjutil::Sleep(1);
+        }
+        g_BaseSystem->ExternalEvent(SysEvent_PauseCPU_FromMenu);
+        Paused = WaitForRewindPause(0) && Buffer.Captures() != Captures;
+    }
+    if (!Paused || Buffer.Snapshots() <= Steps)
+    {
+        Result = stdstr_f("failed (could not record %d snapshots, %d held)", Steps + 1, Buffer.Snapshots());
+        g_BaseSystem->ExternalEvent(SysEvent_ResumeCPU_FromMenu);
+        return false;
+    }
+
+    uint32_t Snapshots = Buffer.Snapshots();
+    bool Passed = true;
+    for (uint32_t Step = 1; Passed && Step <= Steps; Step++)
+    {
+        // Two intervals steps back one snapshot, the newest one is dropped
+        REWIND_TEST_STATE State;
+        if (!RewindFromPause(RewindInterval * 2))
+        {
+            Result = stdstr_f("failed (rewind %d did not complete)", Step);
+            Passed = false;
+            break;
+        }
+        ReadRewindTestState(State);
+
+        const REWIND_TEST_STATE & Expected = States[Steps - Step];
+        if (Buffer.Snapshots() != Snapshots - Step)
+        {
+            Result = stdstr_f("failed (rewind %d left %d snapshots, expected %d)", Step, Buffer.Snapshots(), Snapshots - Step);
+            Passed = false;
+        }
+        else if (State.PC != Expected.PC)
+        {
+            Result = stdstr_f("failed (rewind %d restored PC %08X, expected %08X)", Step, State.PC, Expected.PC);
+            Passed = false;
+        }
+        else if (State.Rdram != Expected.Rdram)
+        {
+            Result = stdstr_f("failed (rewind %d restored different RDRAM)", Step);
+            Passed = false;
+        }
+    }
+    if (Passed)
+    {
+        Result = stdstr_f("passed (%d consecutive rewinds matched the recorded snapshots)", Steps);
+    }
+    g_BaseSystem->ExternalEvent(SysEvent_ResumeCPU_FromMenu);
+    return Passed;
+}
+
+int main(int argc, char ** argv)
+{
+    const char * RomFile = nullptr, * BaseDir = nullptr;
+    const char * GfxPlugin = "libProject64-gfx-null.so";
+    bool Interpreter = false, FunctionIndex = false, RewindTest = false;
+    uint32_t Frames = 0, Cycles = 0, RewindInterval = 0;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-cpu") == 0 && i + 1 < argc)
+        {
+            const char * Core = argv[++i];
+            if (strcmp(Core, "interpreter") == 0) { Interpreter = true; }
+            else if (strcmp(Core, "recompiler") == 0) { Interpreter = false; }
+            else { Usage(argv[0]); return 1; }
+        }
+        else if (strcmp(argv[i], "-frames") == 0 && i + 1 < argc) { Frames = strtoul(argv[++i], nullptr, 0); }
+        else if (strcmp(argv[i], "-cycles") == 0 && i + 1 < argc) { Cycles = strtoul(argv[++i], nullptr, 0); }
+        else if (strcmp(argv[i], "-rewind") == 0 && i + 1 < argc) { RewindInterval = strtoul(argv[++i], nullptr, 0); }
+        else if (strcmp(argv[i], "-rewindtest") == 0) { RewindTest = true; }
+        else if (strcmp(argv[i], "-gfx") == 0 && i + 1 < argc)
+        {
+            const char * Gfx = argv[++i];
+            if (strcmp(Gfx, "null") == 0) { GfxPlugin = "libProject64-gfx-null.so"; }
+            else if (strcmp(Gfx, "headless") == 0) { GfxPlugin = "libProject64-gfx-headless.so"; }
+            else { Usage(argv[0]); return 1; }
+        }
+        else if (strcmp(argv[i], "-basedir") == 0 && i + 1 < argc) { BaseDir = argv[++i]; }
+        else if (strcmp(argv[i], "-verbose") == 0) { Notify().SetVerbose(true); }
+        else if (strcmp(argv[i], "-funcindex") == 0) { FunctionIndex = true; }
+        else if (strcmp(argv[i], "-byteswap") == 0) { return ByteSwapBenchmark(); }
+        else if (argv[i][0] != '-' && RomFile == nullptr) { RomFile = argv[i]; }
+        else { Usage(argv[0]); return 1; }
+    }
+    if (RomFile == nullptr)
+    {
+        Usage(argv[0]);
+        return 1;
+    }
+    if (Frames == 0 && Cycles == 0)
+    {
+        Frames = 1800;
+    }
+    if (RewindTest && (RewindInterval == 0 || Frames == 0))
+    {
+        Usage(argv[0]);
+        return 1;
+    }
+
+    char CurrentDir[4096];
+    if (BaseDir == nullptr)
+    {
+        BaseDir = getcwd(CurrentDir, sizeof(CurrentDir)) != nullptr ? CurrentDir : ".";
+    }
+
+    CHostInstructionCounter HostInstructions;
+    if (!AppInit(&Notify(), BaseDir, 0, nullptr))
+    {
+        fprintf(stderr, "Failed to initialize emulator in %s\n", BaseDir);
+        AppCleanup();
+        return 1;
+    }
+
+    // No window, no sound and no frame limit, the controller plugin is only needed for the PIF
+    g_Settings->SaveString(Plugin_GFX_Current, GfxPlugin);
+    g_Settings->SaveString(Plugin_AUDIO_Current, "libProject64-audio-null.so");
+    g_Settings->SaveString(Plugin_RSP_Current, "libProject64-rsp-hle.so");
+    g_Settings->SaveString(Plugin_CONT_Current, "libProject64-input-android.so");
+    g_Settings->SaveBool(Setting_AutoStart, true);
+    g_Settings->SaveBool(GameRunning_LimitFPS, false);
+    g_Settings->SaveBool(UserInterface_ShowCPUPer, true);
+    g_Settings->SaveBool(Setting_ForceInterpreterCPU, Interpreter);
+    g_Settings->SaveDword(Setting_BenchmarkFrames, Frames);
+    g_Settings->SaveDword(Setting_BenchmarkCycles, Cycles);
+    g_Settings->SaveBool(Setting_Rewind, RewindInterval != 0);
+    g_Settings->SaveDword(Setting_RewindInterval, RewindInterval);
+
+    if (!CN64System::LoadFileImage(RomFile))
+    {
+        fprintf(stderr, "Failed to load %s\n", RomFile);
+        AppCleanup();
+        return 1;
+    }
+    if (!Interpreter)
+    {
+        g_Settings->SaveDword(Game_CpuType, CPU_Recompiler);
+    }
+
+    HighResTimeStamp StartTime, EndTime;
+    StartTime.SetToNow();
+    HostInstructions.Start();
+    CN64System::RunLoadedImage();
+
+    // Wait for the CPU to start, then for the frame or cycle budget to close it
+    for (uint32_t Wait = 0; !g_Settings->LoadBool(GameRunning_CPU_Running) && Wait < 10000; Wait++)
+    {
+        pjutil::Sleep(1);
+    }
+    uint32_t RewindViCount = 0;
+    bool RewindPassed = false;
+    std::string RewindResult;
+    while (g_Settings->LoadBool(GameRunning_CPU_Running))
+    {
+        if (RewindTest && RewindViCount == 0 && g_BaseSystem != nullptr && g_BaseSystem->ViCount() >= Frames / 2)
+        {
+            RewindViCount = g_BaseSystem->ViCount();
+            RewindPassed = RunRewindTest(RewindInterval, 3, RewindResult);
+        }
+        pjutil::Sleep(10);
+    }
+    HostInstructions.Stop();
+    EndTime.SetToNow();
+
+    if (g_BaseSystem == nullptr || g_BaseSystem->ViCount() == 0)
+    {
+        fprintf(stderr, "Emulation did not run\n");
+        CN64System::CloseSystem();
+        AppCleanup();
+        return 1;
+    }
+
+    uint64_t ElapsedTime = EndTime.GetMicroSeconds() - StartTime.GetMicroSeconds();
+    uint64_t GuestInstructions = g_BaseSystem->ViCycles() / (CGameSettings::CountPerOp() != 0 ? CGameSettings::CountPerOp() : 1);
+    uint32_t ViCount = g_BaseSystem->ViCount();
+
+    printf("ROM:           %s\n", g_Settings->LoadStringVal(Rdb_GoodName).c_str());
+    printf("CPU core:      %s\n", Interpreter ? "interpreter" : "recompiler");
+    printf("Frames:        %d\n", ViCount);
+    printf("Timer cycles:  %lld\n", (long long)g_BaseSystem->ViCycles());
+    printf("Elapsed:       %d.%03d s\n", (uint32_t)(ElapsedTime / 1000000), (uint32_t)((ElapsedTime / 1000) % 1000));
+    printf("VI/s:          %.2f\n", ElapsedTime != 0 ? ViCount * 1000000.0 / ElapsedTime : 0.0);
+    printf("Guest instr:   %lld (estimated from CountPerOp %d)\n", (long long)GuestInstructions, CGameSettings::CountPerOp());
+    if (HostInstructions.Available())
+    {
+        uint64_t HostCount = HostInstructions.Count();
+        printf("Host instr:    %lld\n", (long long)HostCount);
+        printf("Host/guest:    %.2f\n", GuestInstructions != 0 ? (double)HostCount / GuestInstructions : 0.0);
+    }
+    else
+    {
+        printf("Host instr:    unavailable (perf_event_open failed)\n");
+    }
+    if (RewindInterval != 0)
+    {
+        const CRewindBuffer & Rewind = g_BaseSystem->RewindBuffer();
+        printf("Rewind:        %d snapshots in %d KB, %d us per capture\n", Rewind.Snapshots(), Rewind.MemoryUsed() / 1024, Rewind.AverageCaptureTime());
+    }
+    bool RewindTestFailed = false;
+    if (RewindTest)
+    {
+        // The VI count is not part of the state, so the run only finishes if emulation carries on from the restored snapshots
+        RewindTestFailed = !RewindPassed || ViCount < Frames;
+        if (RewindViCount == 0)
+        {
+            RewindResult = "failed (frame budget ended before the test started)";
+        }
+        else if (RewindPassed && ViCount < Frames)
+        {
+            RewindResult = stdstr_f("failed (stopped at VI %d after rewinding)", ViCount);
+        }
+        printf("Rewind test:   %s, started at VI %d\n", RewindResult.c_str(), RewindViCount);
+    }
+    if (FunctionIndex && g_BaseSystem->Recompiler() != nullptr)
+    {
+        FunctionIndexBenchmark(g_BaseSystem->Recompiler()->Functions());
+    }
+
+    static const struct
+    {
+        PROFILE_TIMERS Timer;
+        const char * Name;
+    } Timers[] =
+    {
+        { Timer_R4300, "r4300i" },
+        { Timer_RSP_Dlist, "RSP Dlist" },
+        { Timer_RSP_Alist, "RSP Alist" },
+        { Timer_RSP_Unknown, "RSP Unknown" },
+        { Timer_RefreshScreen, "Refresh screen" },
+        { Timer_UpdateScreen, "Update screen" },
+        { Timer_UpdateFPS, "Update FPS" },
+        { Timer_Idel, "Idle" },
+        { Timer_Rewind, "Rewind" },
+    };
+
+    const CProfiling & Profile = g_BaseSystem->CPU_Usage();
+    uint64_t ProfiledTime = 0;
+    for (size_t i = 0; i < sizeof(Timers) / sizeof(Timers[0]); i++)
+    {
+        ProfiledTime += Profile.TotalTime(Timers[i].Timer);
+    }
+    for (size_t i = 0; ProfiledTime != 0 && i < sizeof(Timers) / sizeof(Timers[0]); i++)
+    {
+        uint64_t Time = Profile.TotalTime(Timers[i].Timer);
+        printf("%-15s%6.2f%%  (%lld us)\n", stdstr_f("%s:", Timers[i].Name).c_str(), Time * 100.0 / ProfiledTime, (long long)Time);
+    }
+
+    CN64System::CloseSystem();
+    AppCleanup();
+    return RewindTestFailed ? 1 : 0;
+}
@@ -0,0 +1,196 @@
+#include "ByteSwap.h"
+#include <string.h>
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+#define BYTESWAP_X86
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define BYTESWAP_TARGET(Target)
+#else
+#include <cpuid.h>
+#define BYTESWAP_TARGET(Target) __attribute__((target(Target)))
+#endif
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define BYTESWAP_NEON
+#include <arm_neon.h>
+#endif
+
+static void ByteSwap32_Scalar(uint8_t * Data, size_t Length)
+{
+    for (size_t i = 0; i + 4 <= Length; i += 4)
+    {
+        uint32_t Value;
+        memcpy(&Value, Data + i, sizeof(Value));
+        Value = (Value >> 24) | ((Value >> 8) & 0xFF00) | ((Value << 8) & 0xFF0000) | (Value << 24);
+        memcpy(Data + i, &Value, sizeof(Value));
+    }
+}
+
+static void HalfSwap32_Scalar(uint8_t * Data, size_t Length)
+{
+    for (size_t i = 0; i + 4 <= Length; i += 4)
+    {
+        uint32_t Value;
+        memcpy(&Value, Data + i, sizeof(Value));
+        Value = (Value >> 16) | (Value << 16);
+        memcpy(Data + i, &Value, sizeof(Value));
+    }
+}
+
+#ifdef BYTESWAP_X86
+BYTESWAP_TARGET("ssse3") static void Shuffle_SSSE3(uint8_t * Data, size_t Length, __m128i Mask)
+{
+    size_t i = 0;
+    for (; i + 16 <= Length; i += 16)
+    {
+        __m128i Value = _mm_loadu_si128((const __m128i *)(Data + i));
+        _mm_storeu_si128((__m128i *)(Data + i), _mm_shuffle_epi8(Value, Mask));
+    }
+    if ((Length - i) >= 4)
+    {
+        uint8_t Tail[16];
+        memcpy(Tail, Data + i, Length - i);
+        __m128i Value = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)Tail), Mask);
+        _mm_storeu_si128((__m128i *)Tail, Value);
+        memcpy(Data + i, Tail, (Length - i) & ~(size_t)3);
+    }
+}
+
+BYTESWAP_TARGET("ssse3") static void ByteSwap32_SSSE3(uint8_t * Data, size_t Length)
+{
+    Shuffle_SSSE3(Data, Length, _mm_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12));
+}
+
+BYTESWAP_TARGET("ssse3") static void HalfSwap32_SSSE3(uint8_t * Data, size_t Length)
+{
+    Shuffle_SSSE3(Data, Length, _mm_setr_epi8(2, 3, 0, 1, 6, 7, 4, 5, 10, 11, 8, 9, 14, 15, 12, 13));
+}
+
+BYTESWAP_TARGET("avx2") static void Shuffle_AVX2(uint8_t * Data, size_t Length, __m256i Mask)
+{
+    size_t i = 0;
+    for (; i + 32 <= Length; i += 32)
+    {
+        __m256i Value = _mm256_loadu_si256((const __m256i *)(Data + i));
+        _mm256_storeu_si256((__m256i *)(Data + i), _mm256_shuffle_epi8(Value, Mask));
+    }
+    if ((Length - i) >= 4)
+    {
+        uint8_t Tail[32];
+        memcpy(Tail, Data + i, Length - i);
+        __m256i Value = _mm256_shuffle_epi8(_mm256_loadu_si256((const __m256i *)Tail), Mask);
+        _mm256_storeu_si256((__m256i *)Tail, Value);
+        memcpy(Data + i, Tail, (Length - i) & ~(size_t)3);
+    }
+}
+
+BYTESWAP_TARGET("avx2") static void ByteSwap32_AVX2(uint8_t * Data, size_t Length)
+{
+    Shuffle_AVX2(Data, Length, _mm256_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12, 3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12));
+}
+
+BYTESWAP_TARGET("avx2") static void HalfSwap32_AVX2(uint8_t * Data, size_t Length)
+{
+    Shuffle_AVX2(Data, Length, _mm256_setr_epi8(2, 3, 0, 1, 6, 7, 4, 5, 10, 11, 8, 9, 14, 15, 12, 13, 2, 3, 0, 1, 6, 7, 4, 5, 10, 11, 8, 9, 14, 15, 12, 13));
+}
+
+static void CpuId(uint32_t Leaf, uint32_t SubLeaf, uint32_t Regs[4])
+{
+#ifdef _MSC_VER
+    __cpuidex((int *)Regs, (int)Leaf, (int)SubLeaf);
+#else
+    __cpuid_count(Leaf, SubLeaf, Regs[0], Regs[1], Regs[2], Regs[3]);
+#endif
+}
+
+BYTESWAP_TARGET("xsave") static bool OsSavesAvxState(void)
+{
+    return (_xgetbv(0) & 6) == 6;
+}
+#endif
+
+#ifdef BYTESWAP_NEON
+static void ByteSwap32_NEON(uint8_t * Data, size_t Length)
+{
+    size_t i = 0;
+    for (; i + 16 <= Length; i += 16)
+    {
+        vst1q_u8(Data + i, vrev32q_u8(vld1q_u8(Data + i)));
+    }
+    ByteSwap32_Scalar(Data + i, Length - i);
+}
+
+static void HalfSwap32_NEON(uint8_t * Data, size_t Length)
+{
+    size_t i = 0;
+    for (; i + 16 <= Length; i += 16)
+    {
+        vst1q_u8(Data + i, vreinterpretq_u8_u16(vrev32q_u16(vreinterpretq_u16_u8(vld1q_u8(Data + i)))));
+    }
+    HalfSwap32_Scalar(Data + i, Length - i);
+}
+#endif
+
+struct BYTESWAP_KERNEL_TABLE
+{
+    BYTESWAP_KERNEL Kernels[3];
+    size_t Count;
+};
+
+static BYTESWAP_KERNEL_TABLE DetectKernels(void)
+{
+    BYTESWAP_KERNEL_TABLE Table = {};
+    BYTESWAP_KERNEL Scalar = { "scalar", ByteSwap32_Scalar, HalfSwap32_Scalar };
+    Table.Kernels[Table.Count++] = Scalar;
+#ifdef BYTESWAP_X86
+    uint32_t Regs[4];
+    CpuId(0, 0, Regs);
+    uint32_t MaxLeaf = Regs[0];
+    CpuId(1, 0, Regs);
+    bool Ssse3 = (Regs[2] & (1 << 9)) != 0;
+    bool Avx = (Regs[2] & (1 << 27)) != 0 && (Regs[2] & (1 << 28)) != 0 && OsSavesAvxState();
+    if (Ssse3)
+    {
+        BYTESWAP_KERNEL Kernel = { "ssse3", ByteSwap32_SSSE3, HalfSwap32_SSSE3 };
+        Table.Kernels[Table.Count++] = Kernel;
+    }
+    if (Avx && MaxLeaf >= 7)
+    {
+        CpuId(7, 0, Regs);
+        if ((Regs[1] & (1 << 5)) != 0)
+        {
+            BYTESWAP_KERNEL Kernel = { "avx2", ByteSwap32_AVX2, HalfSwap32_AVX2 };
+            Table.Kernels[Table.Count++] = Kernel;
+        }
+    }
+#endif
+#ifdef BYTESWAP_NEON
+    BYTESWAP_KERNEL Neon = { "neon", ByteSwap32_NEON, HalfSwap32_NEON };
+    Table.Kernels[Table.Count++] = Neon;
+#endif
+    return Table;
+}
+
+size_t ByteSwapKernels(const BYTESWAP_KERNEL ** Kernels)
+{
+    // ROM list scan threads can get here together, initializing a local static is thread safe
+    static const BYTESWAP_KERNEL_TABLE Table = DetectKernels();
+
+    *Kernels = Table.Kernels;
+    return Table.Count;
+}
+
+void ByteSwap32(void * Data, size_t Length)
+{
+    const BYTESWAP_KERNEL * Kernels;
+    size_t Count = ByteSwapKernels(&Kernels);
+    Kernels[Count - 1].ByteSwap32((uint8_t *)Data, Length);
+}
+
+void HalfSwap32(void * Data, size_t Length)
+{
+    const BYTESWAP_KERNEL * Kernels;
+    size_t Count = ByteSwapKernels(&Kernels);
+    Kernels[Count - 1].HalfSwap32((uint8_t *)Data, Length);
+}
@@ -0,0 +1,23 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+
+// Byte swaps whole images a 32-bit word at a time. The fastest kernel the CPU supports is
+// picked on first use, lengths are rounded down to a whole number of words.
+
+// 0x11223344 -> 0x44332211, big endian images to the byte order the core keeps them in
+void ByteSwap32(void * Data, size_t Length);
+
+// 0x11223344 -> 0x33441122, byte swapped (.v64) images to the byte order the core keeps them in
+void HalfSwap32(void * Data, size_t Length);
+
+struct BYTESWAP_KERNEL
+{
+    const char * Name;
+    void(*ByteSwap32)(uint8_t * Data, size_t Length);
+    void(*HalfSwap32)(uint8_t * Data, size_t Length);
+};
+
+// Kernels usable on this CPU, slowest first, so they can be benchmarked against each other.
+// The last one is the kernel ByteSwap32 and HalfSwap32 use.
+size_t ByteSwapKernels(const BYTESWAP_KERNEL ** Kernels);
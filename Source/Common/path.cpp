@@ -16,6 +16,7 @@
 #include <dirent.h>
 #include <unistd.h>
 #include <errno.h>
+#include <stdio.h>
 #endif
 #include "Platform.h"
 
@@ -1169,28 +1170,18 @@ bool CPath::CopyTo(const char * lpcszTargetFile, bool bOverwrite)
 
 bool CPath::MoveTo(const char * lpcszTargetFile, bool bOverwrite)
 {
-#ifdef _WIN32
     // Check if the target file exists
     CPath TargetFile(lpcszTargetFile);
-    if (TargetFile.Exists())
+    if (!bOverwrite && TargetFile.Exists())
     {
-        // Yeah there is already such a target file
-        // Decide if we should overwrite
-        if (!bOverwrite)
-        {
-            return false;
-        }
-
-        // Delete any previous target
-        if (!TargetFile.Delete(TRUE))
-        {
-            return false;
-        }
+        return false;
     }
 
-    return MoveFileA(m_strPath.c_str(), lpcszTargetFile) != 0;
+    // Replacing the target is a single step, it is either the old file or the new one
+#ifdef _WIN32
+    return MoveFileExA(m_strPath.c_str(), lpcszTargetFile, bOverwrite ? MOVEFILE_REPLACE_EXISTING : 0) != 0;
 #else
-    return false;
+    return rename(m_strPath.c_str(), lpcszTargetFile) == 0;
 #endif
 }
 
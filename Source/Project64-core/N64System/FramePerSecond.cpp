@@ -8,7 +8,8 @@ m_CurrentDlistFrame(0),
 m_iFrameRateType(g_Settings->LoadDword(UserInterface_FrameDisplayType)),
 m_ScreenHertz(g_Settings->LoadDword(GameRunning_ScreenHertz)),
 m_ViFrameRateWhole(0),
-m_ViFrameRateFraction(0)
+m_ViFrameRateFraction(0),
+m_FrameTimeCount(0)
 {
     g_Settings->RegisterChangeCB(UserInterface_FrameDisplayType, this, (CSettings::SettingChangedFunc)FrameRateTypeChanged);
     g_Settings->RegisterChangeCB(GameRunning_ScreenHertz, this, (CSettings::SettingChangedFunc)ScreenHertzChanged);
@@ -37,6 +38,14 @@ void CFramePerSecond::Reset(bool ClearDisplay)
         m_ViFrames[count] = 0;
         m_FramesDlist[count] = 0;
     }
+
+    if (m_FrameTimeCount != 0)
+    {
+        WriteTrace(TraceN64System, TraceInfo, "Frame times over %d frames: median %d us, 99%% %d us, 99.9%% %d us", m_FrameTimeCount, FrameTimePerMille(500), FrameTimePerMille(990), FrameTimePerMille(999));
+    }
+    m_LastFrameTime.SetMicroSeconds(0);
+    memset(m_FrameTimes, 0, sizeof(m_FrameTimes));
+    m_FrameTimeCount = 0;
     if (ClearDisplay)
     {
         g_Notify->DisplayMessage2("");
@@ -72,6 +81,34 @@ void CFramePerSecond::UpdateViCounter(void)
     m_CurrentViFrame += 1;
 }
 
+void CFramePerSecond::RecordFrameTime(void)
+{
+    HighResTimeStamp Time;
+    Time.SetToNow();
+    if (m_LastFrameTime.GetMicroSeconds() != 0)
+    {
+        uint64_t Bucket = (Time.GetMicroSeconds() - m_LastFrameTime.GetMicroSeconds()) / FrameTimeBucketSize;
+        m_FrameTimes[Bucket < FrameTimeBuckets ? Bucket : FrameTimeBuckets - 1] += 1;
+        m_FrameTimeCount += 1;
+    }
+    m_LastFrameTime = Time;
+}
+
+// Upper edge of the bucket that PerMille thousandths of the frames fall within
+uint32_t CFramePerSecond::FrameTimePerMille(uint32_t PerMille) const
+{
+    uint64_t Target = ((uint64_t)m_FrameTimeCount * PerMille + 999) / 1000, Total = 0;
+    for (uint32_t i = 0; i < FrameTimeBuckets; i++)
+    {
+        Total += m_FrameTimes[i];
+        if (Total >= Target)
+        {
+            return (i + 1) * FrameTimeBucketSize;
+        }
+    }
+    return FrameTimeBuckets * FrameTimeBucketSize;
+}
+
 void CFramePerSecond::UpdateDisplay(void)
 {
     std::string DisplayString;
@@ -14,6 +14,14 @@ public:
     void UpdateViCounter(void);
     void DisplayViCounter(int32_t FrameRateWhole, uint32_t FrameRateFraction);
 
+    // Histogram of the time between screen refreshes, in FrameTimeBucketSize microsecond
+    // buckets with the last one holding everything longer
+    enum { FrameTimeBuckets = 80, FrameTimeBucketSize = 500 };
+    void RecordFrameTime(void);
+    const uint32_t * FrameTimeHistogram(void) const { return m_FrameTimes; }
+    uint32_t FrameTimeCount(void) const { return m_FrameTimeCount; }
+    uint32_t FrameTimePerMille(uint32_t PerMille) const;
+
 private:
     CFramePerSecond(const CFramePerSecond&);
     CFramePerSecond& operator=(const CFramePerSecond&);
@@ -37,4 +45,9 @@ private:
     uint64_t m_FramesDlist[NoOfFrames];
     uint32_t m_CurrentDlistFrame;
     float m_DlistFrameRate;
+
+    // Frame times
+    HighResTimeStamp m_LastFrameTime;
+    uint32_t m_FrameTimes[FrameTimeBuckets];
+    uint32_t m_FrameTimeCount;
 };
@@ -292,6 +292,7 @@ void CDMA::PI_DMA_WRITE()
             g_System->SetDmaUsed(true);
             OnFirstDMA();
         }
+        g_MMU->UpdatePageGeneration(g_Reg->PI_DRAM_ADDR_REG, PI_WR_LEN_REG);
         if (g_Recompiler && g_System->bSMM_PIDMA())
         {
             g_Recompiler->ClearRecompCode_Phys(g_Reg->PI_DRAM_ADDR_REG, g_Reg->PI_WR_LEN_REG, CRecompiler::Remove_DMA);
@@ -446,6 +447,7 @@ void CDMA::PI_DMA_WRITE()
             g_System->SetDmaUsed(true);
             OnFirstDMA();
         }
+        g_MMU->UpdatePageGeneration(g_Reg->PI_DRAM_ADDR_REG, PI_WR_LEN_REG);
         if (g_Recompiler && g_System->bSMM_PIDMA())
         {
             g_Recompiler->ClearRecompCode_Phys(g_Reg->PI_DRAM_ADDR_REG, g_Reg->PI_WR_LEN_REG, CRecompiler::Remove_DMA);
@@ -555,6 +557,7 @@ void CDMA::SP_DMA_WRITE()
 
     memcpy(g_MMU->Rdram() + g_Reg->SP_DRAM_ADDR_REG, g_MMU->Dmem() + (g_Reg->SP_MEM_ADDR_REG & 0x1FFF),
         g_Reg->SP_WR_LEN_REG + 1);
+    g_MMU->UpdatePageGeneration(g_Reg->SP_DRAM_ADDR_REG, g_Reg->SP_WR_LEN_REG + 1);
 
     g_Reg->SP_DMA_BUSY_REG = 0;
     g_Reg->SP_STATUS_REG &= ~SP_STATUS_DMA_BUSY;
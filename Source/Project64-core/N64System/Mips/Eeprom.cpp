@@ -5,9 +5,8 @@
 #include <time.h>
 
 CEeprom::CEeprom(bool ReadOnly) :
-m_ReadOnly(ReadOnly)
+m_SaveChip("eep", EepromSize, 0xFF, ReadOnly)
 {
-    memset(m_EEPROM, 0xFF, sizeof(m_EEPROM));
 }
 
 CEeprom::~CEeprom()
@@ -131,68 +130,33 @@ void CEeprom::EepromCommand(uint8_t * Command)
 
 void CEeprom::LoadEeprom()
 {
-    memset(m_EEPROM, 0xFF, sizeof(m_EEPROM));
-
-    CPath FileName(g_Settings->LoadStringVal(Directory_NativeSave).c_str(), stdstr_f("%s.eep", g_Settings->LoadStringVal(Game_GameName).c_str()).c_str());
-    if (g_Settings->LoadBool(Setting_UniqueSaveDir))
-    {
-        FileName.AppendDirectory(g_Settings->LoadStringVal(Game_UniqueSaveDir).c_str());
-    }
-#ifdef _WIN32
-    FileName.NormalizePath(CPath(CPath::MODULE_DIRECTORY));
-#endif
-
-    if (!FileName.DirectoryExists())
-    {
-        FileName.DirectoryCreate();
-    }
-
-    if (!m_File.Open(FileName, (m_ReadOnly ? CFileBase::modeRead : CFileBase::modeReadWrite) | CFileBase::modeNoTruncate | CFileBase::modeCreate))
+    if (!m_SaveChip.Load())
     {
-#ifdef _WIN32
-        WriteTrace(TraceN64System, TraceError, "Failed to open (%s), ReadOnly = %d, LastError = %X", (const char *)FileName, m_ReadOnly, GetLastError());
-#else
-        WriteTrace(TraceN64System, TraceError, "Failed to open (%s), ReadOnly = %d", (const char *)FileName, m_ReadOnly);
-#endif
         g_Notify->DisplayError(GS(MSG_FAIL_OPEN_EEPROM));
-        return;
     }
-    m_File.SeekToBegin();
-    m_File.Read(m_EEPROM, sizeof(m_EEPROM));
 }
 
 void CEeprom::ReadFrom(uint8_t * Buffer, int32_t line)
 {
-    int32_t i;
-
-    if (!m_File.IsOpen())
+    if (!m_SaveChip.Loaded())
     {
         LoadEeprom();
     }
-
-    for (i = 0; i < 8; i++)
-    {
-        Buffer[i] = m_EEPROM[line * 8 + i];
-    }
+    m_SaveChip.Read(line * 8, Buffer, 8);
 }
 
 void CEeprom::WriteTo(uint8_t * Buffer, int32_t line)
 {
-    int32_t i;
-
-    if (!m_File.IsOpen())
+    if (!m_SaveChip.Loaded())
     {
         LoadEeprom();
     }
-    for (i = 0; i < 8; i++)
-    {
-        m_EEPROM[line * 8 + i] = Buffer[i];
-    }
-    if (!m_ReadOnly)
-    {
-        m_File.Seek(line * 8, CFile::begin);
-        m_File.Write(Buffer, 8);
-    }
+    m_SaveChip.Write(line * 8, Buffer, 8);
+}
+
+void CEeprom::FlushEeprom()
+{
+    m_SaveChip.Flush();
 }
 
 void CEeprom::ProcessingError(uint8_t * /*Command*/)
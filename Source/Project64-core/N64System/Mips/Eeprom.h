@@ -1,5 +1,6 @@
 #pragma once
 #include <Project64-core/Settings/DebugSettings.h>
+#include <Project64-core/N64System/Mips/SaveChip.h>
 
 class CEeprom :
     protected CDebugSettings
@@ -9,6 +10,7 @@ public:
     ~CEeprom();
 
     void EepromCommand(uint8_t * Command);
+    void FlushEeprom();
 
 private:
     CEeprom(void);
@@ -20,7 +22,7 @@ private:
     void ReadFrom(uint8_t * Buffer, int32_t line);
     void WriteTo(uint8_t * Buffer, int32_t line);
 
-    uint8_t m_EEPROM[0x800];
-    bool    m_ReadOnly;
-    CFile   m_File;
+    enum { EepromSize = 0x800 };
+
+    CSaveChip m_SaveChip;
 };
@@ -2,14 +2,13 @@
 #include <Project64-core/N64System/Mips/FlashRam.h>
 #include <Project64-core/N64System/SystemGlobals.h>
 #include <Project64-core/N64System/Mips/MemoryVirtualMem.h>
-#include <Common/path.h>
 
 CFlashram::CFlashram(bool ReadOnly) :
 m_FlashRamPointer(nullptr),
 m_FlashFlag(FLASHRAM_MODE_NOPES),
 m_FlashStatus(0),
 m_FlashRAM_Offset(0),
-m_ReadOnly(ReadOnly)
+m_SaveChip("fla", FlashramSize, 0xFF, ReadOnly)
 {
 }
 
@@ -19,22 +18,20 @@ CFlashram::~CFlashram()
 
 void CFlashram::DmaFromFlashram(uint8_t * dest, int32_t StartOffset, int32_t len)
 {
-    uint8_t FlipBuffer[0x10000];
-
     switch (m_FlashFlag)
     {
     case FLASHRAM_MODE_READ:
-        if (!m_File.IsOpen() && !LoadFlashram())
+        if (!LoadFlashram())
         {
             return;
         }
-        if (len > sizeof(FlipBuffer))
+        if (len > 0x10000)
         {
             if (HaveDebugger())
             {
-                g_Notify->DisplayError(stdstr_f("%s: DmaFromFlashram FlipBuffer to small (len: %d)", __FUNCTION__, len).c_str());
+                g_Notify->DisplayError(stdstr_f("%s: DmaFromFlashram read too large (len: %d)", __FUNCTION__, len).c_str());
             }
-            len = sizeof(FlipBuffer);
+            len = 0x10000;
         }
         if ((len & 3) != 0)
         {
@@ -44,20 +41,8 @@ void CFlashram::DmaFromFlashram(uint8_t * dest, int32_t StartOffset, int32_t len
             }
             return;
         }
-        memset(FlipBuffer, 0, sizeof(FlipBuffer));
-        StartOffset = StartOffset << 1;
-        m_File.Seek(StartOffset, CFile::begin);
-        m_File.Read(FlipBuffer, len);
-
-        for (int32_t count = m_File.GetLength(); count < len; count++)
-        {
-            FlipBuffer[count] = 0xFF;
-        }
-
-        for (int32_t count = 0; count < len; count += 4)
-        {
-            *(uint32_t *)(dest + count) = *(uint32_t *)&FlipBuffer[count];
-        }
+        // Erased flash reads back as 0xFF, the save chip is filled with it past the end of the file
+        m_SaveChip.Read(StartOffset << 1, dest, len);
         break;
     case FLASHRAM_MODE_STATUS:
         if (StartOffset != 0 && len != 8)
@@ -110,34 +95,21 @@ uint32_t CFlashram::ReadFromFlashStatus(uint32_t PAddr)
 
 bool CFlashram::LoadFlashram()
 {
-    CPath FileName(g_Settings->LoadStringVal(Directory_NativeSave).c_str(), stdstr_f("%s.fla", g_Settings->LoadStringVal(Game_GameName).c_str()).c_str());
-    if (g_Settings->LoadBool(Setting_UniqueSaveDir))
-    {
-        FileName.AppendDirectory(g_Settings->LoadStringVal(Game_UniqueSaveDir).c_str());
-    }
-#ifdef _WIN32
-    FileName.NormalizePath(CPath(CPath::MODULE_DIRECTORY));
-#endif
-
-    if (!FileName.DirectoryExists())
+    if (!m_SaveChip.Load())
     {
-        FileName.DirectoryCreate();
-    }
-
-    if (!m_File.Open(FileName, (m_ReadOnly ? CFileBase::modeRead : CFileBase::modeReadWrite) | CFileBase::modeNoTruncate | CFileBase::modeCreate))
-    {
-        WriteTrace(TraceN64System, TraceError, "Failed to open (%s), ReadOnly = %d", (const char *)FileName, m_ReadOnly);
         g_Notify->DisplayError(GS(MSG_FAIL_OPEN_FLASH));
         return false;
     }
-    m_File.SeekToBegin();
     return true;
 }
 
-void CFlashram::WriteToFlashCommand(uint32_t FlashRAM_Command)
+void CFlashram::FlushFlashram()
 {
-    uint8_t EmptyBlock[16 * sizeof(int64_t)];
+    m_SaveChip.Flush();
+}
 
+void CFlashram::WriteToFlashCommand(uint32_t FlashRAM_Command)
+{
     switch (FlashRAM_Command & 0xFF000000)
     {
     case 0xD2000000:
@@ -147,35 +119,18 @@ void CFlashram::WriteToFlashCommand(uint32_t FlashRAM_Command)
         case FLASHRAM_MODE_READ: break;
         case FLASHRAM_MODE_STATUS: break;
         case FLASHRAM_MODE_ERASE:
-            memset(EmptyBlock, 0xFF, sizeof(EmptyBlock));
-            if (!m_File.IsOpen() && !LoadFlashram())
+            if (!LoadFlashram())
             {
                 return;
             }
-            if (!m_ReadOnly)
-            {
-                m_File.Seek(m_FlashRAM_Offset, CFile::begin);
-                m_File.Write(EmptyBlock, sizeof(EmptyBlock));
-            }
+            m_SaveChip.Fill(m_FlashRAM_Offset, 0xFF, FlashramPageSize);
             break;
         case FLASHRAM_MODE_WRITE:
-            if (!m_File.IsOpen() && !LoadFlashram())
+            if (!LoadFlashram())
             {
                 return;
             }
-            {
-                uint8_t FlipBuffer[sizeof(EmptyBlock)];
-                uint8_t * FlashRamPointer = m_FlashRamPointer;
-
-                memset(FlipBuffer, 0, sizeof(FlipBuffer));
-                memcpy(&FlipBuffer[0], FlashRamPointer, sizeof(EmptyBlock));
-
-                if (!m_ReadOnly)
-                {
-                    m_File.Seek(m_FlashRAM_Offset, CFile::begin);
-                    m_File.Write(FlipBuffer, sizeof(EmptyBlock));
-                }
-            }
+            m_SaveChip.Write(m_FlashRAM_Offset, m_FlashRamPointer, FlashramPageSize);
             break;
         default:
             g_Notify->DisplayError(stdstr_f("Writing %X to flash RAM command register\nm_FlashFlag: %d", FlashRAM_Command, m_FlashFlag).c_str());
@@ -192,7 +147,7 @@ void CFlashram::WriteToFlashCommand(uint32_t FlashRAM_Command)
         m_FlashStatus = 0x11118004F0000000;
         break;
     case 0x4B000000:
-        m_FlashRAM_Offset = (FlashRAM_Command & 0xFFFF) * sizeof(EmptyBlock);
+        m_FlashRAM_Offset = (FlashRAM_Command & 0xFFFF) * FlashramPageSize;
         break;
     case 0x78000000:
         m_FlashFlag = FLASHRAM_MODE_ERASE;
@@ -202,7 +157,7 @@ void CFlashram::WriteToFlashCommand(uint32_t FlashRAM_Command)
         m_FlashFlag = FLASHRAM_MODE_WRITE;
         break;
     case 0xA5000000:
-        m_FlashRAM_Offset = (FlashRAM_Command & 0xFFFF) * sizeof(EmptyBlock);
+        m_FlashRAM_Offset = (FlashRAM_Command & 0xFFFF) * FlashramPageSize;
         m_FlashStatus = 0x1111800400C2001E;
         break;
     default:
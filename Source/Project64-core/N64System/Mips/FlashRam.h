@@ -1,5 +1,6 @@
 #pragma once
 #include <Project64-core/Settings/DebugSettings.h>
+#include <Project64-core/N64System/Mips/SaveChip.h>
 
 class CFlashram :
     private CDebugSettings
@@ -21,6 +22,7 @@ public:
     void  DmaToFlashram(uint8_t * Source, int32_t StartOffset, int32_t len);
     uint32_t ReadFromFlashStatus(uint32_t PAddr);
     void     WriteToFlashCommand(uint32_t Value);
+    void     FlushFlashram();
 
 private:
     CFlashram(void);
@@ -29,10 +31,11 @@ private:
 
     bool  LoadFlashram();
 
+    enum { FlashramSize = 0x20000, FlashramPageSize = 128 };
+
     uint8_t * m_FlashRamPointer;
     Modes     m_FlashFlag;
     uint64_t  m_FlashStatus;
     uint32_t  m_FlashRAM_Offset;
-    bool      m_ReadOnly;
-    CFile     m_File;
+    CSaveChip m_SaveChip;
 };
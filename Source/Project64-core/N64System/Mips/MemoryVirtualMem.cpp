@@ -43,6 +43,7 @@ CMipsMemoryVM::CMipsMemoryVM(bool SavesReadOnly) :
     m_DDRom(nullptr),
     m_DDRomSize(0)
 {
+    memset(m_PageGeneration, 0, sizeof(m_PageGeneration));
     g_Settings->RegisterChangeCB(Game_RDRamSize, this, (CSettings::SettingChangedFunc)RdramChanged);
 }
 
@@ -308,6 +309,13 @@ CFlashram* CMipsMemoryVM::GetFlashram()
 	return dynamic_cast<CFlashram*>(this);
 }
 
+void CMipsMemoryVM::FlushSaveChips()
+{
+    FlushEeprom();
+    FlushFlashram();
+    FlushSram();
+}
+
 bool CMipsMemoryVM::LB_VAddr(uint32_t VAddr, uint8_t& Value)
 {
     if (m_TLB_ReadMap[VAddr >> 12] == 0)
@@ -442,6 +450,23 @@ bool CMipsMemoryVM::LD_PAddr(uint32_t PAddr, uint64_t& Value)
     return false;
 }
 
+void CMipsMemoryVM::UpdatePageGeneration(uint32_t PAddr, uint32_t Length)
+{
+    if (Length == 0)
+    {
+        return;
+    }
+    uint32_t FirstPage = PAddr >> 12, LastPage = (PAddr + Length - 1) >> 12;
+    if (LastPage - FirstPage > PageGenerationMask)
+    {
+        LastPage = FirstPage + PageGenerationMask;
+    }
+    for (uint32_t Page = FirstPage; Page <= LastPage; Page++)
+    {
+        m_PageGeneration[Page & PageGenerationMask] += 1;
+    }
+}
+
 bool CMipsMemoryVM::SB_VAddr(uint32_t VAddr, uint8_t Value)
 {
     if (m_TLB_WriteMap[VAddr >> 12] == 0)
@@ -450,6 +475,7 @@ bool CMipsMemoryVM::SB_VAddr(uint32_t VAddr, uint8_t Value)
     }
 
     *(uint8_t*)(m_TLB_WriteMap[VAddr >> 12] + (VAddr ^ 3)) = Value;
+    PageWritten(VAddr);
     return true;
 }
 
@@ -461,6 +487,7 @@ bool CMipsMemoryVM::SH_VAddr(uint32_t VAddr, uint16_t Value)
     }
 
     *(uint16_t*)(m_TLB_WriteMap[VAddr >> 12] + (VAddr ^ 2)) = Value;
+    PageWritten(VAddr);
     return true;
 }
 
@@ -482,6 +509,7 @@ bool CMipsMemoryVM::SW_VAddr(uint32_t VAddr, uint32_t Value)
     }
 
     *(uint32_t*)(m_TLB_WriteMap[VAddr >> 12] + VAddr) = Value;
+    PageWritten(VAddr);
     return true;
 }
 
@@ -494,6 +522,7 @@ bool CMipsMemoryVM::SD_VAddr(uint32_t VAddr, uint64_t Value)
 
     *(uint32_t*)(m_TLB_WriteMap[VAddr >> 12] + VAddr + 0) = *((uint32_t*)(&Value) + 1);
     *(uint32_t*)(m_TLB_WriteMap[VAddr >> 12] + VAddr + 4) = *((uint32_t*)(&Value));
+    PageWritten(VAddr);
     return true;
 }
 
@@ -502,6 +531,7 @@ bool CMipsMemoryVM::SB_PAddr(uint32_t PAddr, uint8_t Value)
     if (PAddr < RdramSize())
     {
         *(uint8_t*)(m_RDRAM + (PAddr ^ 3)) = Value;
+        m_PageGeneration[(PAddr >> 12) & PageGenerationMask] += 1;
         return true;
     }
 
@@ -519,6 +549,7 @@ bool CMipsMemoryVM::SH_PAddr(uint32_t PAddr, uint16_t Value)
     if (PAddr < RdramSize())
     {
         *(uint16_t*)(m_RDRAM + (PAddr ^ 2)) = Value;
+        m_PageGeneration[(PAddr >> 12) & PageGenerationMask] += 1;
         return true;
     }
 
@@ -536,6 +567,7 @@ bool CMipsMemoryVM::SW_PAddr(uint32_t PAddr, uint32_t Value)
     if (PAddr < RdramSize())
     {
         *(uint32_t*)(m_RDRAM + PAddr) = Value;
+        m_PageGeneration[(PAddr >> 12) & PageGenerationMask] += 1;
         return true;
     }
 
@@ -554,6 +586,7 @@ bool CMipsMemoryVM::SD_PAddr(uint32_t PAddr, uint64_t Value)
     {
         *(uint32_t*)(m_RDRAM + PAddr + 0) = *((uint32_t*)(&Value) + 1);
         *(uint32_t*)(m_RDRAM + PAddr + 4) = *((uint32_t*)(&Value));
+        m_PageGeneration[(PAddr >> 12) & PageGenerationMask] += 1;
         return true;
     }
 
@@ -1770,6 +1803,7 @@ void CMipsMemoryVM::Write32DPCommandRegisters(void)
         if (g_Plugins->Gfx()->ProcessRDPList)
         {
             g_Plugins->Gfx()->ProcessRDPList();
+            g_MMU->UpdatePageGeneration(0, g_System->RdramSize());
         }
         break;
         //case 0x04100008: g_Reg->DPC_CURRENT_REG = Value; break;
@@ -58,9 +58,18 @@ public:
     uint8_t * Imem();
     uint8_t * PifRam();
 
+    // Write generation of each 4KB page of RDRAM, bumped by anything that may write to the page
+    enum { PageGenerationMask = 0x7FF };
+    uint32_t   PageGeneration(uint32_t PAddr) const { return m_PageGeneration[(PAddr >> 12) & PageGenerationMask]; }
+    uint32_t * PageGenerations() { return m_PageGeneration; }
+    void       UpdatePageGeneration(uint32_t PAddr, uint32_t Length);
+
     CSram * GetSram();
     CFlashram * GetFlashram();
 
+    // Write any pending save chip changes to disk
+    void FlushSaveChips();
+
     bool  LB_VAddr(uint32_t VAddr, uint8_t & Value);
     bool  LH_VAddr(uint32_t VAddr, uint16_t & Value);
     bool  LW_VAddr(uint32_t VAddr, uint32_t & Value);
@@ -211,6 +220,9 @@ private:
     size_t * m_TLB_ReadMap;
     size_t * m_TLB_WriteMap;
 
+    void PageWritten(uint32_t VAddr) { m_PageGeneration[(((m_TLB_WriteMap[VAddr >> 12] + VAddr) - (size_t)m_RDRAM) >> 12) & PageGenerationMask] += 1; }
+    uint32_t m_PageGeneration[PageGenerationMask + 1];
+
     static uint32_t m_MemLookupAddress;
     static MIPS_DWORD m_MemLookupValue;
     static bool m_MemLookupValid;
@@ -281,6 +281,7 @@ void CPifRam::SI_DMA_READ()
         {
             RDRAM[(SI_DRAM_ADDR_REG + i) ^ 3] = PifRamPos[i];
         }
+        g_MMU->UpdatePageGeneration(SI_DRAM_ADDR_REG, 64);
     }
 
     if (LogPRDMAMemStores())
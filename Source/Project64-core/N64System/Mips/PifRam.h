@@ -19,6 +19,8 @@ public:
     void SI_DMA_READ();
     void SI_DMA_WRITE();
 
+    using CEeprom::FlushEeprom;
+
 protected:
     uint8_t m_PifRom[0x7C0];
     uint8_t m_PifRam[0x40];
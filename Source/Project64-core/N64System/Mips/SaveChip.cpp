@@ -0,0 +1,329 @@
+#include "stdafx.h"
+#include <Project64-core/N64System/Mips/SaveChip.h>
+#include <Common/path.h>
+#include <Common/md5.h>
+#include <Common/Util.h>
+
+CSaveChip::CSaveChip(const char * Extension, uint32_t Size, uint8_t FillValue, bool ReadOnly) :
+    m_Extension(Extension),
+    m_Image(nullptr),
+    m_Size(Size),
+    m_FillValue(FillValue),
+    m_ReadOnly(ReadOnly),
+    m_Loaded(false),
+    m_FileLength(0),
+    m_FlushThread(stFlushThread),
+    m_FlushEvent(false),
+    m_FlushThreadEnd(false)
+{
+}
+
+CSaveChip::~CSaveChip()
+{
+    if (m_FlushThread.isRunning())
+    {
+        m_FlushThreadEnd = true;
+        m_FlushEvent.Trigger();
+        while (m_FlushThread.isRunning())
+        {
+            pjutil::Sleep(1);
+        }
+    }
+    Flush();
+    delete[] m_Image;
+    m_Image = nullptr;
+}
+
+std::string CSaveChip::SaveFile() const
+{
+    CPath FileName(g_Settings->LoadStringVal(Directory_NativeSave).c_str(), stdstr_f("%s.%s", g_Settings->LoadStringVal(Game_GameName).c_str(), m_Extension.c_str()).c_str());
+    if (g_Settings->LoadBool(Setting_UniqueSaveDir))
+    {
+        FileName.AppendDirectory(g_Settings->LoadStringVal(Game_UniqueSaveDir).c_str());
+    }
+#ifdef _WIN32
+    FileName.NormalizePath(CPath(CPath::MODULE_DIRECTORY));
+#endif
+    return (const std::string &)FileName;
+}
+
+bool CSaveChip::Load()
+{
+    if (m_Loaded)
+    {
+        return true;
+    }
+
+    CPath FileName(SaveFile());
+    if (!FileName.DirectoryExists())
+    {
+        FileName.DirectoryCreate();
+    }
+
+    if (!m_File.Open(FileName, (m_ReadOnly ? CFileBase::modeRead : CFileBase::modeReadWrite) | CFileBase::modeNoTruncate | CFileBase::modeCreate))
+    {
+        WriteTrace(TraceN64System, TraceError, "Failed to open (%s), ReadOnly = %d", (const char *)FileName, m_ReadOnly);
+        return false;
+    }
+    m_FileName = (const char *)FileName;
+
+    if (m_Image == nullptr)
+    {
+        m_Image = new uint8_t[m_Size];
+    }
+    memset(m_Image, m_FillValue, m_Size);
+    m_FileLength = m_File.GetLength();
+    m_File.SeekToBegin();
+    m_File.Read(m_Image, m_FileLength < m_Size ? m_FileLength : m_Size);
+    ReplayJournal();
+    m_Loaded = true;
+
+    if (!m_ReadOnly)
+    {
+        m_FlushThreadEnd = false;
+        m_FlushThread.Start(this);
+    }
+    return true;
+}
+
+void CSaveChip::Read(uint32_t Offset, void * Dest, uint32_t Length)
+{
+    if (!m_Loaded || Offset >= m_Size)
+    {
+        memset(Dest, m_FillValue, Length);
+        return;
+    }
+    uint32_t Available = Length < m_Size - Offset ? Length : m_Size - Offset;
+    memcpy(Dest, m_Image + Offset, Available);
+    if (Available < Length)
+    {
+        memset((uint8_t *)Dest + Available, m_FillValue, Length - Available);
+    }
+}
+
+void CSaveChip::Write(uint32_t Offset, const void * Source, uint32_t Length)
+{
+    if (!m_Loaded || m_ReadOnly || Offset >= m_Size)
+    {
+        return;
+    }
+    if (Length > m_Size - Offset)
+    {
+        Length = m_Size - Offset;
+    }
+
+    CGuard Guard(m_CS);
+    memcpy(m_Image + Offset, Source, Length);
+    MarkDirty(Offset, Offset + Length);
+}
+
+void CSaveChip::Fill(uint32_t Offset, uint8_t Value, uint32_t Length)
+{
+    if (!m_Loaded || m_ReadOnly || Offset >= m_Size)
+    {
+        return;
+    }
+    if (Length > m_Size - Offset)
+    {
+        Length = m_Size - Offset;
+    }
+
+    CGuard Guard(m_CS);
+    memset(m_Image + Offset, Value, Length);
+    MarkDirty(Offset, Offset + Length);
+}
+
+void CSaveChip::MarkDirty(uint32_t Start, uint32_t End)
+{
+    // Merge with any range that overlaps or touches [Start, End)
+    DIRTY_RANGES::iterator itr = m_Dirty.upper_bound(Start);
+    if (itr != m_Dirty.begin())
+    {
+        DIRTY_RANGES::iterator Prev = itr;
+        Prev--;
+        if (Prev->second >= Start)
+        {
+            Start = Prev->first;
+            End = End > Prev->second ? End : Prev->second;
+            itr = m_Dirty.erase(Prev);
+        }
+    }
+    while (itr != m_Dirty.end() && itr->first <= End)
+    {
+        End = End > itr->second ? End : itr->second;
+        itr = m_Dirty.erase(itr);
+    }
+    m_Dirty[Start] = End;
+}
+
+void CSaveChip::Flush()
+{
+    CGuard FlushGuard(m_FlushCS);
+    if (!m_Loaded || m_ReadOnly)
+    {
+        return;
+    }
+
+    DIRTY_RANGES Ranges;
+    std::vector<uint8_t> Data;
+    {
+        CGuard Guard(m_CS);
+        if (m_Dirty.empty())
+        {
+            return;
+        }
+
+        // Anything between the end of the file and a dirty range is written as well,
+        // otherwise the file system would fill the gap with zeros instead of the fill value
+        if (m_Dirty.rbegin()->second > m_FileLength)
+        {
+            MarkDirty(m_FileLength, m_Dirty.rbegin()->second);
+        }
+        Ranges.swap(m_Dirty);
+        for (DIRTY_RANGES::const_iterator itr = Ranges.begin(); itr != Ranges.end(); itr++)
+        {
+            Data.insert(Data.end(), m_Image + itr->first, m_Image + itr->second);
+        }
+    }
+
+    bool Journaled = WriteJournal(Ranges, Data);
+    size_t DataOffset = 0;
+    for (DIRTY_RANGES::const_iterator itr = Ranges.begin(); itr != Ranges.end(); itr++)
+    {
+        uint32_t Length = itr->second - itr->first;
+        m_File.Seek(itr->first, CFile::begin);
+        m_File.Write(&Data[DataOffset], Length);
+        DataOffset += Length;
+        if (itr->second > m_FileLength)
+        {
+            m_FileLength = itr->second;
+        }
+    }
+    m_File.Flush();
+
+    if (Journaled)
+    {
+        CPath(stdstr_f("%s.journal", m_FileName.c_str()).c_str()).Delete();
+    }
+    WriteTrace(TraceN64System, TraceDebug, "%s: wrote %d ranges (%d bytes)", m_Extension.c_str(), (uint32_t)Ranges.size(), (uint32_t)Data.size());
+}
+
+bool CSaveChip::WriteJournal(const DIRTY_RANGES & Ranges, const std::vector<uint8_t> & Data)
+{
+    std::vector<uint32_t> Table;
+    for (DIRTY_RANGES::const_iterator itr = Ranges.begin(); itr != Ranges.end(); itr++)
+    {
+        Table.push_back(itr->first);
+        Table.push_back(itr->second - itr->first);
+    }
+
+    JOURNAL_HEADER Header;
+    Header.Magic = JournalMagic;
+    Header.Version = JournalVersion;
+    Header.Ranges = (uint32_t)Ranges.size();
+    Header.DataLength = (uint32_t)Data.size();
+
+    MD5 Digest;
+    Digest.update((const unsigned char *)&Table[0], (unsigned int)(Table.size() * sizeof(uint32_t)));
+    Digest.update(&Data[0], (unsigned int)Data.size());
+    Digest.finalize();
+    memcpy(Header.Digest, Digest.raw_digest(), sizeof(Header.Digest));
+
+    CFile Journal;
+    if (!Journal.Open(stdstr_f("%s.journal", m_FileName.c_str()).c_str(), CFileBase::modeWrite | CFileBase::modeCreate))
+    {
+        WriteTrace(TraceN64System, TraceWarning, "Failed to create journal for %s", m_FileName.c_str());
+        return false;
+    }
+    if (!Journal.Write(&Header, sizeof(Header)) ||
+        !Journal.Write(&Table[0], (uint32_t)(Table.size() * sizeof(uint32_t))) ||
+        !Journal.Write(&Data[0], (uint32_t)Data.size()) ||
+        !Journal.Flush())
+    {
+        WriteTrace(TraceN64System, TraceWarning, "Failed to write journal for %s", m_FileName.c_str());
+        return false;
+    }
+    return true;
+}
+
+void CSaveChip::ReplayJournal()
+{
+    CPath JournalFile(stdstr_f("%s.journal", m_FileName.c_str()).c_str());
+    CFile Journal;
+    if (!JournalFile.Exists() || !Journal.Open(JournalFile, CFileBase::modeRead))
+    {
+        return;
+    }
+
+    // A journal is only left behind when the emulator stopped while writing the save,
+    // an incomplete journal means the save file itself was never touched
+    // Every range holds at least one byte, so bounding the range count by the data length
+    // keeps a corrupt header from asking for a huge table
+    JOURNAL_HEADER Header;
+    std::vector<uint32_t> Table;
+    std::vector<uint8_t> Data;
+    bool Valid = Journal.Read(&Header, sizeof(Header)) == sizeof(Header) && Header.Magic == JournalMagic &&
+        Header.Version == JournalVersion && Header.Ranges != 0 && Header.DataLength <= m_Size &&
+        Header.Ranges <= Header.DataLength;
+    if (Valid)
+    {
+        Table.resize(Header.Ranges * 2);
+        Data.resize(Header.DataLength);
+        Valid = Journal.Read(&Table[0], (uint32_t)(Table.size() * sizeof(uint32_t))) == Table.size() * sizeof(uint32_t) &&
+            Journal.Read(&Data[0], (uint32_t)Data.size()) == Data.size();
+    }
+    if (Valid)
+    {
+        MD5 Digest;
+        Digest.update((const unsigned char *)&Table[0], (unsigned int)(Table.size() * sizeof(uint32_t)));
+        Digest.update(&Data[0], (unsigned int)Data.size());
+        Digest.finalize();
+        Valid = memcmp(Header.Digest, Digest.raw_digest(), sizeof(Header.Digest)) == 0;
+    }
+    Journal.Close();
+
+    if (!Valid)
+    {
+        WriteTrace(TraceN64System, TraceWarning, "Discarding incomplete journal (%s)", (const char *)JournalFile);
+    }
+    else
+    {
+        WriteTrace(TraceN64System, TraceInfo, "Replaying journal (%s)", (const char *)JournalFile);
+        uint32_t DataOffset = 0;
+        for (uint32_t i = 0; i < Header.Ranges; i++)
+        {
+            uint32_t Start = Table[i * 2], Length = Table[i * 2 + 1];
+            if (Start >= m_Size || Length > m_Size - Start || Length > Header.DataLength - DataOffset)
+            {
+                break;
+            }
+            memcpy(m_Image + Start, &Data[DataOffset], Length);
+            if (!m_ReadOnly)
+            {
+                m_File.Seek(Start, CFile::begin);
+                m_File.Write(&Data[DataOffset], Length);
+                if (Start + Length > m_FileLength)
+                {
+                    m_FileLength = Start + Length;
+                }
+            }
+            DataOffset += Length;
+        }
+        m_File.Flush();
+    }
+    if (!m_ReadOnly)
+    {
+        JournalFile.Delete();
+    }
+}
+
+void CSaveChip::FlushThread()
+{
+    WriteTrace(TraceN64System, TraceDebug, "Start (%s)", m_Extension.c_str());
+    while (!m_FlushThreadEnd)
+    {
+        m_FlushEvent.IsTriggered(FlushInterval);
+        Flush();
+    }
+    WriteTrace(TraceN64System, TraceDebug, "Done (%s)", m_Extension.c_str());
+}
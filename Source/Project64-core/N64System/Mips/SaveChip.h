@@ -0,0 +1,72 @@
+#pragma once
+#include <Common/File.h>
+#include <Common/Thread.h>
+#include <Common/CriticalSection.h>
+#include <Common/SyncEvent.h>
+#include <map>
+#include <string>
+#include <vector>
+
+// Whole save chip (SRAM, FlashRAM, EEPROM) held in memory in the same byte order as RDRAM,
+// so DMAs are plain copies. Written ranges are coalesced and written back to the save file
+// from a background thread. Each write back goes through a journal first, so a crash part
+// way through never leaves a half written save.
+class CSaveChip
+{
+public:
+    CSaveChip(const char * Extension, uint32_t Size, uint8_t FillValue, bool ReadOnly);
+    ~CSaveChip();
+
+    bool Load();
+    bool Loaded() const { return m_Loaded; }
+    uint32_t Size() const { return m_Size; }
+
+    void Read(uint32_t Offset, void * Dest, uint32_t Length);
+    void Write(uint32_t Offset, const void * Source, uint32_t Length);
+    void Fill(uint32_t Offset, uint8_t Value, uint32_t Length);
+
+    // Writes everything changed so far to the save file, called on pause and close
+    void Flush();
+
+private:
+    CSaveChip();
+    CSaveChip(const CSaveChip&);
+    CSaveChip& operator=(const CSaveChip&);
+
+    typedef std::map<uint32_t, uint32_t> DIRTY_RANGES; // Start -> end
+
+    typedef struct
+    {
+        uint32_t Magic;
+        uint32_t Version;
+        uint32_t Ranges;
+        uint32_t DataLength;
+        uint8_t  Digest[16];
+    } JOURNAL_HEADER;
+
+    std::string SaveFile() const;
+    void MarkDirty(uint32_t Start, uint32_t End);
+    bool WriteJournal(const DIRTY_RANGES & Ranges, const std::vector<uint8_t> & Data);
+    void ReplayJournal();
+    void FlushThread();
+    static uint32_t stFlushThread(void * lpThreadParameter) { ((CSaveChip *)lpThreadParameter)->FlushThread(); return 0; }
+
+    std::string     m_Extension;
+    std::string     m_FileName;
+    uint8_t       * m_Image;
+    uint32_t        m_Size;
+    uint8_t         m_FillValue;
+    bool            m_ReadOnly;
+    bool            m_Loaded;
+    uint32_t        m_FileLength;
+    CFile           m_File;
+    DIRTY_RANGES    m_Dirty;
+    CriticalSection m_CS;       // Image and dirty ranges
+    CriticalSection m_FlushCS;  // Save file and journal
+    CThread         m_FlushThread;
+    SyncEvent       m_FlushEvent;
+    volatile bool   m_FlushThreadEnd;
+
+    enum { JournalMagic = 0x4C4E524A, JournalVersion = 1 };
+    enum { FlushInterval = 1000 }; // Milliseconds between background write backs
+};
@@ -1,4 +1,5 @@
 #pragma once
+#include <Project64-core/N64System/Mips/SaveChip.h>
 
 class CSram
 {
@@ -8,14 +9,15 @@ public:
 
     void DmaFromSram(uint8_t * dest, int32_t StartOffset, uint32_t len);
     void DmaToSram(uint8_t * Source, int32_t StartOffset, uint32_t len);
+    void FlushSram();
 
 private:
     CSram(void);
     CSram(const CSram&);
     CSram& operator=(const CSram&);
 
-    bool LoadSram();
+    // Four 32KB banks, Dezaemon 3D uses all of them
+    enum { SramSize = 0x20000 };
 
-    bool m_ReadOnly;
-    CFile m_File;
-};
+    CSaveChip m_SaveChip;
+};
\ No newline at end of file
@@ -48,6 +48,8 @@ const char * SystemEventName(SystemEvent event)
     case SysEvent_ResetFunctionTimes: return "SysEvent_ResetFunctionTimes";
     case SysEvent_DumpFunctionTimes: return "SysEvent_DumpFunctionTimes";
     case SysEvent_ResetRecompilerCode: return "SysEvent_ResetRecompilerCode";
+    case SysEvent_RewindCapture: return "SysEvent_RewindCapture";
+    case SysEvent_RewindState: return "SysEvent_RewindState";
     }
     static char unknown[100];
     sprintf(unknown, "Unknown(%d)", event);
@@ -152,6 +154,15 @@ void CSystemEvents::ExecuteEvents()
                 bLoadedSave = true;
             }
             break;
+        case SysEvent_RewindCapture:
+            m_System->CaptureRewind();
+            break;
+        case SysEvent_RewindState:
+            if (m_System->RewindState())
+            {
+                bLoadedSave = true;
+            }
+            break;
         case SysEvent_ChangePlugins:
             ChangePluginFunc();
             break;
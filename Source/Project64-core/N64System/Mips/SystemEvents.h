@@ -46,6 +46,8 @@ enum SystemEvent
     SysEvent_ResetFunctionTimes,
     SysEvent_DumpFunctionTimes,
     SysEvent_ResetRecompilerCode,
+    SysEvent_RewindCapture,
+    SysEvent_RewindState,
 };
 
 const char * SystemEventName(SystemEvent event);
@@ -4,16 +4,19 @@
 #include <Project64-core/N64System/Mips/Register.h>
 #include <Project64-core/N64System/Mips/Disk.h>
 #include <Project64-core/N64System/N64System.h>
-#include <Project64-core/3rdParty/zip.h>
 
 CSystemTimer::CSystemTimer(CRegisters &Reg, int32_t & NextTimer) :
+    m_HeapSize(0),
+    m_NextTimerTime(0),
     m_LastUpdate(0),
     m_NextTimer(NextTimer),
     m_Current(UnknownTimer),
     m_inFixTimer(false),
     m_Reg(Reg)
 {
-    memset(m_TimerDetatils, 0, sizeof(m_TimerDetatils));
+    memset(m_TimerTime, 0, sizeof(m_TimerTime));
+    memset(m_Heap, 0, sizeof(m_Heap));
+    memset(m_HeapIndex, 0xFF, sizeof(m_HeapIndex));
 }
 
 void CSystemTimer::Reset()
@@ -21,9 +24,11 @@ void CSystemTimer::Reset()
     // Initialize structure
     for (int i = 0; i < MaxTimer; i++)
     {
-        m_TimerDetatils[i].Active = false;
-        m_TimerDetatils[i].CyclesToTimer = 0;
+        m_TimerTime[i] = 0;
+        m_HeapIndex[i] = -1;
     }
+    m_HeapSize = 0;
+    m_NextTimerTime = 0;
     m_Current = UnknownTimer;
     m_LastUpdate = 0;
     m_NextTimer = 0;
@@ -42,22 +47,15 @@ void CSystemTimer::SetTimer(TimerType Type, uint32_t Cycles, bool bRelative)
     }
     UpdateTimers();
 
-    m_TimerDetatils[Type].Active = true;
     if (bRelative)
     {
-        if (m_TimerDetatils[Type].Active)
-        {
-            m_TimerDetatils[Type].CyclesToTimer += Cycles; // Add to the timer
-        }
-        else
-        {
-            m_TimerDetatils[Type].CyclesToTimer = (int64_t)Cycles - (int64_t)m_NextTimer;  // Replace the new cycles
-        }
+        m_TimerTime[Type] += Cycles; // Add to the timer
     }
     else
     {
-        m_TimerDetatils[Type].CyclesToTimer = (int64_t)Cycles - (int64_t)m_NextTimer;  // Replace the new cycles
+        m_TimerTime[Type] = m_NextTimerTime - m_NextTimer + Cycles; // Replace the new cycles
     }
+    HeapUpdate(Type);
     FixTimers();
 }
 
@@ -68,11 +66,11 @@ uint32_t CSystemTimer::GetTimer(TimerType Type)
         g_Notify->BreakPoint(__FILE__, __LINE__);
         return 0;
     }
-    if (!m_TimerDetatils[Type].Active)
+    if (!Active(Type))
     {
         return 0;
     }
-    int64_t CyclesToTimer = m_TimerDetatils[Type].CyclesToTimer + m_NextTimer;
+    int64_t CyclesToTimer = m_TimerTime[Type] - (m_NextTimerTime - m_NextTimer);
     if (CyclesToTimer < 0)
     {
         return 0;
@@ -91,7 +89,7 @@ void CSystemTimer::StopTimer(TimerType Type)
         g_Notify->BreakPoint(__FILE__, __LINE__);
         return;
     }
-    m_TimerDetatils[Type].Active = false;
+    HeapRemove(Type);
     FixTimers();
 }
 
@@ -109,46 +107,101 @@ void CSystemTimer::FixTimers()
         SetCompareTimer();
     }
 
-    // Update the cycles for the remaining number of cycles to timer
-    int count;
-    for (count = 0; count < MaxTimer; count++)
+    // Count down to the earliest timer, or as far as m_NextTimer can reach
+    int64_t Now = m_NextTimerTime - m_NextTimer;
+    m_NextTimer = 0x7FFFFFFF;
+    if (m_HeapSize != 0 && m_TimerTime[m_Heap[0]] - Now < m_NextTimer)
     {
-        if (!m_TimerDetatils[count].Active)
-        {
-            continue;
-        }
-        m_TimerDetatils[count].CyclesToTimer += m_NextTimer;
+        m_NextTimer = (int)(m_TimerTime[m_Heap[0]] - Now);
+        m_Current = m_Heap[0];
     }
+    m_NextTimerTime = Now + m_NextTimer;
+    m_LastUpdate = m_NextTimer;
+    m_inFixTimer = false;
+}
 
-    // Set max timer
-    m_NextTimer = 0x7FFFFFFF;
+void CSystemTimer::HeapUpdate(TimerType Type)
+{
+    if (!Active(Type))
+    {
+        m_HeapIndex[Type] = m_HeapSize;
+        m_Heap[m_HeapSize++] = Type;
+    }
+    HeapSiftUp(m_HeapIndex[Type]);
+    HeapSiftDown(m_HeapIndex[Type]);
+}
+
+void CSystemTimer::HeapRemove(TimerType Type)
+{
+    if (!Active(Type))
+    {
+        return;
+    }
+    int32_t Index = m_HeapIndex[Type];
+    HeapSwap(Index, --m_HeapSize);
+    m_HeapIndex[Type] = -1;
+    if (Index < m_HeapSize)
+    {
+        HeapSiftUp(Index);
+        HeapSiftDown(Index);
+    }
+}
 
-    // Find the smallest timer left to go
-    for (count = 0; count < MaxTimer; count++)
+void CSystemTimer::HeapSwap(int32_t a, int32_t b)
+{
+    TimerType Type = m_Heap[a];
+    m_Heap[a] = m_Heap[b];
+    m_Heap[b] = Type;
+    m_HeapIndex[m_Heap[a]] = a;
+    m_HeapIndex[m_Heap[b]] = b;
+}
+
+void CSystemTimer::HeapSiftUp(int32_t Index)
+{
+    while (Index > 0 && Earlier(m_Heap[Index], m_Heap[(Index - 1) / 2]))
     {
-        if (!m_TimerDetatils[count].Active)
+        HeapSwap(Index, (Index - 1) / 2);
+        Index = (Index - 1) / 2;
+    }
+}
+
+void CSystemTimer::HeapSiftDown(int32_t Index)
+{
+    for (;;)
+    {
+        int32_t Smallest = Index, Left = Index * 2 + 1, Right = Index * 2 + 2;
+        if (Left < m_HeapSize && Earlier(m_Heap[Left], m_Heap[Smallest]))
         {
-            continue;
+            Smallest = Left;
         }
-        if (m_TimerDetatils[count].CyclesToTimer >= m_NextTimer)
+        if (Right < m_HeapSize && Earlier(m_Heap[Right], m_Heap[Smallest]))
         {
-            continue;
+            Smallest = Right;
+        }
+        if (Smallest == Index)
+        {
+            break;
         }
-        m_NextTimer = (int)m_TimerDetatils[count].CyclesToTimer;
-        m_Current = (TimerType)count;
+        HeapSwap(Index, Smallest);
+        Index = Smallest;
     }
+}
 
-    // Move the timer back this value
-    for (count = 0; count < MaxTimer; count++)
+void CSystemTimer::HeapRebuild()
+{
+    m_HeapSize = 0;
+    for (int i = 0; i < MaxTimer; i++)
     {
-        if (!m_TimerDetatils[count].Active)
+        if (m_HeapIndex[i] >= 0)
         {
-            continue;
+            m_HeapIndex[i] = m_HeapSize;
+            m_Heap[m_HeapSize++] = (TimerType)i;
         }
-        m_TimerDetatils[count].CyclesToTimer -= m_NextTimer;
     }
-    m_LastUpdate = m_NextTimer;
-    m_inFixTimer = false;
+    for (int32_t i = m_HeapSize / 2 - 1; i >= 0; i--)
+    {
+        HeapSiftDown(i);
+    }
 }
 
 void CSystemTimer::UpdateTimers()
@@ -302,7 +355,7 @@ bool CSystemTimer::SaveAllowed(void)
         {
             continue;
         }
-        if (m_TimerDetatils[i].Active)
+        if (Active((TimerType)i))
         {
             return false;
         }
@@ -310,66 +363,29 @@ bool CSystemTimer::SaveAllowed(void)
     return true;
 }
 
-void CSystemTimer::SaveData(zipFile & file) const
+void CSystemTimer::SaveData(CSaveStateBuffer & file) const
 {
     uint32_t TimerDetailsSize = sizeof(TIMER_DETAILS);
-    uint32_t Entries = sizeof(m_TimerDetatils) / sizeof(m_TimerDetatils[0]);
-    zipWriteInFileInZip(file, &TimerDetailsSize, sizeof(TimerDetailsSize));
-    zipWriteInFileInZip(file, &Entries, sizeof(Entries));
-    zipWriteInFileInZip(file, (void *)&m_TimerDetatils, sizeof(m_TimerDetatils));
-    zipWriteInFileInZip(file, (void *)&m_LastUpdate, sizeof(m_LastUpdate));
-    zipWriteInFileInZip(file, &m_NextTimer, sizeof(m_NextTimer));
-    zipWriteInFileInZip(file, (void *)&m_Current, sizeof(m_Current));
-}
+    uint32_t Entries = MaxTimer;
 
-void CSystemTimer::SaveData(CFile & file) const
-{
-    uint32_t TimerDetailsSize = sizeof(TIMER_DETAILS);
-    uint32_t Entries = sizeof(m_TimerDetatils) / sizeof(m_TimerDetatils[0]);
+    // Save states hold each timer relative to where m_NextTimer reaches zero
+    TIMER_DETAILS TimerDetails[MaxTimer];
+    memset(TimerDetails, 0, sizeof(TimerDetails));
+    for (int i = 0; i < MaxTimer; i++)
+    {
+        TimerDetails[i].Active = Active((TimerType)i);
+        TimerDetails[i].CyclesToTimer = m_TimerTime[i] - m_NextTimerTime;
+    }
 
     file.Write(&TimerDetailsSize, sizeof(TimerDetailsSize));
     file.Write(&Entries, sizeof(Entries));
-    file.Write((void *)&m_TimerDetatils, sizeof(m_TimerDetatils));
+    file.Write(TimerDetails, sizeof(TimerDetails));
     file.Write((void *)&m_LastUpdate, sizeof(m_LastUpdate));
     file.Write(&m_NextTimer, sizeof(m_NextTimer));
     file.Write((void *)&m_Current, sizeof(m_Current));
 }
 
-void CSystemTimer::LoadData(zipFile & file)
-{
-    uint32_t TimerDetailsSize, Entries;
-
-    unzReadCurrentFile(file, &TimerDetailsSize, sizeof(TimerDetailsSize));
-    unzReadCurrentFile(file, &Entries, sizeof(Entries));
-
-    if (TimerDetailsSize != sizeof(TIMER_DETAILS))
-    {
-        g_Notify->BreakPoint(__FILE__, __LINE__);
-        return;
-    }
-    if (Entries != sizeof(m_TimerDetatils) / sizeof(m_TimerDetatils[0]))
-    {
-        if (Entries < (sizeof(m_TimerDetatils) / sizeof(m_TimerDetatils[0])))
-        {
-            memset((void *)&m_TimerDetatils, 0, sizeof(m_TimerDetatils));
-            unzReadCurrentFile(file, (void *)&m_TimerDetatils, Entries * sizeof(m_TimerDetatils[0]));
-        }
-        else
-        {
-            g_Notify->BreakPoint(__FILE__, __LINE__);
-            return;
-        }
-    }
-    else
-    {
-        unzReadCurrentFile(file, (void *)&m_TimerDetatils, sizeof(m_TimerDetatils));
-    }
-    unzReadCurrentFile(file, (void *)&m_LastUpdate, sizeof(m_LastUpdate));
-    unzReadCurrentFile(file, &m_NextTimer, sizeof(m_NextTimer));
-    unzReadCurrentFile(file, (void *)&m_Current, sizeof(m_Current));
-}
-
-void CSystemTimer::LoadData(CFile & file)
+void CSystemTimer::LoadData(CSaveStateBuffer & file)
 {
     uint32_t TimerDetailsSize, Entries;
 
@@ -381,16 +397,27 @@ void CSystemTimer::LoadData(CFile & file)
         g_Notify->BreakPoint(__FILE__, __LINE__);
         return;
     }
-    if (Entries != sizeof(m_TimerDetatils) / sizeof(m_TimerDetatils[0]))
+    if (Entries > MaxTimer)
     {
         g_Notify->BreakPoint(__FILE__, __LINE__);
         return;
     }
 
-    file.Read((void *)&m_TimerDetatils, sizeof(m_TimerDetatils));
+    // Older save states may have fewer timers, the missing ones are left stopped
+    TIMER_DETAILS TimerDetails[MaxTimer];
+    memset(TimerDetails, 0, sizeof(TimerDetails));
+    file.Read(TimerDetails, Entries * sizeof(TimerDetails[0]));
     file.Read((void *)&m_LastUpdate, sizeof(m_LastUpdate));
     file.Read(&m_NextTimer, sizeof(m_NextTimer));
     file.Read((void *)&m_Current, sizeof(m_Current));
+
+    m_NextTimerTime = m_NextTimer;
+    for (int i = 0; i < MaxTimer; i++)
+    {
+        m_TimerTime[i] = m_NextTimerTime + TimerDetails[i].CyclesToTimer;
+        m_HeapIndex[i] = TimerDetails[i].Active ? 0 : -1;
+    }
+    HeapRebuild();
 }
 
 void CSystemTimer::RecordDifference(CLog &LogFile, const CSystemTimer& rSystemTimer)
@@ -414,13 +441,13 @@ void CSystemTimer::RecordDifference(CLog &LogFile, const CSystemTimer& rSystemTi
 
     for (int i = 0; i < MaxTimer; i++)
     {
-        if (m_TimerDetatils[i].Active != rSystemTimer.m_TimerDetatils[i].Active)
+        if (Active((TimerType)i) != rSystemTimer.Active((TimerType)i))
         {
-            LogFile.LogF("Timer-m_TimerDetatils[%d] %X %X\r\n", i, (int)m_TimerDetatils[i].Active, (int)rSystemTimer.m_TimerDetatils[i].Active);
+            LogFile.LogF("Timer-Active[%d] %X %X\r\n", i, (int)Active((TimerType)i), (int)rSystemTimer.Active((TimerType)i));
         }
-        if (m_TimerDetatils[i].CyclesToTimer != rSystemTimer.m_TimerDetatils[i].CyclesToTimer)
+        if (m_TimerTime[i] - m_NextTimerTime != rSystemTimer.m_TimerTime[i] - rSystemTimer.m_NextTimerTime)
         {
-            LogFile.LogF("Timer-m_TimerDetatils[%d] 0x%08X, 0x%08X\r\n", i, (uint32_t)m_TimerDetatils[i].CyclesToTimer, (uint32_t)rSystemTimer.m_TimerDetatils[i].CyclesToTimer);
+            LogFile.LogF("Timer-CyclesToTimer[%d] 0x%08X, 0x%08X\r\n", i, (uint32_t)(m_TimerTime[i] - m_NextTimerTime), (uint32_t)(rSystemTimer.m_TimerTime[i] - rSystemTimer.m_NextTimerTime));
         }
     }
 }
@@ -446,11 +473,11 @@ bool CSystemTimer::operator == (const CSystemTimer& rSystemTimer) const
 
     for (int i = 0; i < MaxTimer; i++)
     {
-        if (m_TimerDetatils[i].Active != rSystemTimer.m_TimerDetatils[i].Active)
+        if (Active((TimerType)i) != rSystemTimer.Active((TimerType)i))
         {
             return false;
         }
-        if (m_TimerDetatils[i].CyclesToTimer != rSystemTimer.m_TimerDetatils[i].CyclesToTimer)
+        if (m_TimerTime[i] - m_NextTimerTime != rSystemTimer.m_TimerTime[i] - rSystemTimer.m_NextTimerTime)
         {
             return false;
         }
@@ -3,7 +3,8 @@
 #include <Common/Log.h>
 #include <Project64-core/N64System/N64Types.h>
 #include <Project64-core/N64System/Mips/Register.h>
-#include <Project64-core/3rdParty/zip.h>
+
+class CSaveStateBuffer;
 
 class CSystemTimer
 {
@@ -27,6 +28,7 @@ public:
         MaxTimer
     };
 
+    // Layout of a timer in save states
     struct TIMER_DETAILS
     {
         union 
@@ -47,10 +49,8 @@ public:
     void UpdateCompareTimer();
     bool SaveAllowed();
 
-    void SaveData(zipFile & file) const;
-    void SaveData(CFile & file) const;
-    void LoadData(zipFile & file);
-    void LoadData(CFile & file);
+    void SaveData(CSaveStateBuffer & file) const;
+    void LoadData(CSaveStateBuffer & file);
 
     void RecordDifference(CLog &LogFile, const CSystemTimer& rSystemTimer);
 
@@ -67,7 +67,22 @@ private:
     void SetCompareTimer();
     void FixTimers();
 
-    TIMER_DETAILS m_TimerDetatils[MaxTimer];
+    // Active timers are kept in a binary heap ordered by the cycle they fire at, so arming,
+    // stopping and finding the next timer never has to walk or rebase every timer
+    bool Active(TimerType Type) const { return m_HeapIndex[Type] >= 0; }
+    bool Earlier(TimerType a, TimerType b) const { return m_TimerTime[a] < m_TimerTime[b] || (m_TimerTime[a] == m_TimerTime[b] && a < b); }
+    void HeapUpdate(TimerType Type);
+    void HeapRemove(TimerType Type);
+    void HeapSwap(int32_t a, int32_t b);
+    void HeapSiftUp(int32_t Index);
+    void HeapSiftDown(int32_t Index);
+    void HeapRebuild();
+
+    int64_t m_TimerTime[MaxTimer];  // Cycle each timer fires at, kept when stopped for relative timers
+    TimerType m_Heap[MaxTimer];
+    int32_t m_HeapIndex[MaxTimer];  // Position in m_Heap, -1 when the timer is stopped
+    int32_t m_HeapSize;
+    int64_t m_NextTimerTime;        // Cycle at which m_NextTimer counts down to zero
     int32_t m_LastUpdate;
     int32_t & m_NextTimer;
     TimerType m_Current;
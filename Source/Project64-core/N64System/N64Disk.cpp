@@ -1,6 +1,7 @@
 #include "stdafx.h"
 #include "N64Disk.h"
 #include "SystemGlobals.h"
+#include <Common/ByteSwap.h>
 #include <Common/md5.h>
 #include <Common/Platform.h>
 #include <Common/MemoryManagement.h>
@@ -505,21 +506,11 @@ bool CN64Disk::LoadDiskRAMImage()
 
 void CN64Disk::ByteSwapDisk()
 {
-    uint32_t count;
-
     switch (*((uint32_t *)&GetDiskAddressSys()[8]))
     {
     case 0x281E140A:
     case 0x3024180C:
-        for (count = 0; count < m_DiskFileSize; count += 4)
-        {
-            m_DiskImage[count] ^= m_DiskImage[count + 3];
-            m_DiskImage[count + 3] ^= m_DiskImage[count];
-            m_DiskImage[count] ^= m_DiskImage[count + 3];
-            m_DiskImage[count + 1] ^= m_DiskImage[count + 2];
-            m_DiskImage[count + 2] ^= m_DiskImage[count + 1];
-            m_DiskImage[count + 1] ^= m_DiskImage[count + 2];
-        }
+        ByteSwap32(m_DiskImage, m_DiskFileSize);
         break;
     case 0x0A141E28: break;
     case 0x0C182430: break;
@@ -530,17 +521,7 @@ void CN64Disk::ByteSwapDisk()
 
 void CN64Disk::ForceByteSwapDisk()
 {
-    uint32_t count;
-
-    for (count = 0; count < m_DiskFileSize; count += 4)
-    {
-        m_DiskImage[count] ^= m_DiskImage[count + 3];
-        m_DiskImage[count + 3] ^= m_DiskImage[count];
-        m_DiskImage[count] ^= m_DiskImage[count + 3];
-        m_DiskImage[count + 1] ^= m_DiskImage[count + 2];
-        m_DiskImage[count + 2] ^= m_DiskImage[count + 1];
-        m_DiskImage[count + 1] ^= m_DiskImage[count + 2];
-    }
+    ByteSwap32(m_DiskImage, m_DiskFileSize);
 }
 
 void CN64Disk::SetError(LanguageStringID ErrorMsg)
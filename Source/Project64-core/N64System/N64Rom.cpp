@@ -2,6 +2,7 @@
 #include "N64Rom.h"
 #include "SystemGlobals.h"
 #include <Project64-core/3rdParty/zip.h>
+#include <Common/ByteSwap.h>
 #include <Common/md5.h>
 #include <Common/Platform.h>
 #include <Common/MemoryManagement.h>
@@ -10,11 +11,16 @@
 
 #ifdef _WIN32
 #include <Project64-core/3rdParty/7zip.h>
+#else
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
 #endif
 
 CN64Rom::CN64Rom() :
     m_ROMImage(nullptr),
     m_ROMImageBase(nullptr),
+    m_ROMImageMapSize(0),
     m_RomFileSize(0),
     m_ErrorMsg(EMPTY_STRING),
     m_Country(Country_Unknown),
@@ -80,6 +86,14 @@ bool CN64Rom::AllocateAndLoadN64Image(const char * FileLoc, bool LoadBootCodeOnl
         WriteTrace(TraceN64System, TraceDebug, "Loading boot code, so loading the first 0x1000 bytes", RomFileSize);
         RomFileSize = 0x1000;
     }
+#ifndef _WIN32
+    // Only images already in memory order are mapped, swapping a mapped image would give every page a private copy
+    else if (g_Settings->LoadBool(Setting_MapRomFile) && *((uint32_t *)&Test[0]) == 0x80371240 && MapN64Image(FileLoc, RomFileSize))
+    {
+        m_RomFile.Close();
+        return true;
+    }
+#endif
 
     if (!AllocateRomImage(RomFileSize))
     {
@@ -126,6 +140,40 @@ bool CN64Rom::AllocateAndLoadN64Image(const char * FileLoc, bool LoadBootCodeOnl
     return true;
 }
 
+#ifndef _WIN32
+bool CN64Rom::MapN64Image(const char * FileLoc, uint32_t RomFileSize)
+{
+    // Reserve a spare page past the end of the image, as the read buffer has, so reads just
+    // past the end of the ROM do not fault
+    uint32_t MapSize = (RomFileSize + 0x1FFF) & ~0xFFF;
+    uint8_t * Image = (uint8_t *)mmap(nullptr, MapSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (Image == (uint8_t *)MAP_FAILED)
+    {
+        return false;
+    }
+
+    int fd = open(FileLoc, O_RDONLY);
+    if (fd < 0 || mmap(Image, RomFileSize, PROT_READ, MAP_PRIVATE | MAP_FIXED, fd, 0) == MAP_FAILED)
+    {
+        WriteTrace(TraceN64System, TraceDebug, "Failed to map %s, reading it instead", FileLoc);
+        if (fd >= 0)
+        {
+            close(fd);
+        }
+        munmap(Image, MapSize);
+        return false;
+    }
+    close(fd);
+    WriteTrace(TraceN64System, TraceDebug, "Mapped ROM file (%p)", Image);
+
+    m_ROMImage = Image;
+    m_ROMImageMapSize = MapSize;
+    m_RomFileSize = RomFileSize;
+    ProtectMemory(m_ROMImage, m_RomFileSize, MEM_READONLY);
+    return true;
+}
+#endif
+
 bool CN64Rom::AllocateAndLoadZipImage(const char * FileLoc, bool LoadBootCodeOnly)
 {
     unzFile file = unzOpen(FileLoc);
@@ -226,32 +274,14 @@ bool CN64Rom::AllocateAndLoadZipImage(const char * FileLoc, bool LoadBootCodeOnl
 
 void CN64Rom::ByteSwapRom()
 {
-    uint32_t count;
-
     switch (*((uint32_t *)&m_ROMImage[0]))
     {
     case 0x12408037:
-        for (count = 0; count < m_RomFileSize; count += 4)
-        {
-            m_ROMImage[count] ^= m_ROMImage[count + 2];
-            m_ROMImage[count + 2] ^= m_ROMImage[count];
-            m_ROMImage[count] ^= m_ROMImage[count + 2];
-            m_ROMImage[count + 1] ^= m_ROMImage[count + 3];
-            m_ROMImage[count + 3] ^= m_ROMImage[count + 1];
-            m_ROMImage[count + 1] ^= m_ROMImage[count + 3];
-        }
+        HalfSwap32(m_ROMImage, m_RomFileSize);
         break;
     case 0x40072780: // 64DD IPL
     case 0x40123780:
-        for (count = 0; count < m_RomFileSize; count += 4)
-        {
-            m_ROMImage[count] ^= m_ROMImage[count + 3];
-            m_ROMImage[count + 3] ^= m_ROMImage[count];
-            m_ROMImage[count] ^= m_ROMImage[count + 3];
-            m_ROMImage[count + 1] ^= m_ROMImage[count + 2];
-            m_ROMImage[count + 2] ^= m_ROMImage[count + 1];
-            m_ROMImage[count + 1] ^= m_ROMImage[count + 2];
-        }
+        ByteSwap32(m_ROMImage, m_RomFileSize);
         break;
     case 0x80371240: break;
     default:
@@ -910,5 +940,12 @@ void CN64Rom::UnallocateRomImage()
         delete[] m_ROMImageBase;
         m_ROMImageBase = nullptr;
     }
+#ifndef _WIN32
+    if (m_ROMImageMapSize != 0)
+    {
+        munmap(m_ROMImage, m_ROMImageMapSize);
+        m_ROMImageMapSize = 0;
+    }
+#endif
     m_ROMImage = nullptr;
 }
\ No newline at end of file
@@ -35,6 +35,7 @@ public:
 private:
     bool AllocateRomImage(uint32_t RomFileSize);
     bool AllocateAndLoadN64Image(const char * FileLoc, bool LoadBootCodeOnly);
+    bool MapN64Image(const char * FileLoc, uint32_t RomFileSize);
     bool AllocateAndLoadZipImage(const char * FileLoc, bool LoadBootCodeOnly);
     void ByteSwapRom();
     void SetError(LanguageStringID ErrorMsg);
@@ -50,6 +51,7 @@ private:
     CFile m_RomFile;
     uint8_t * m_ROMImage;
     uint8_t * m_ROMImageBase;
+    uint32_t m_ROMImageMapSize; // Non zero when m_ROMImage is a private mapping of the ROM file
     uint32_t m_RomFileSize;
     Country m_Country;
     CICChip m_CicChip;
@@ -17,9 +17,6 @@
 #include <Common/Util.h>
 #include <float.h>
 #include <time.h>
-#if defined(ANDROID)
-#include <utime.h>
-#endif
 
 #pragma warning(disable:4355) // Disable 'this' : used in base member initializer list
 
@@ -31,6 +28,10 @@ CN64System::CN64System(CPlugins * Plugins, uint32_t randomizer_seed, bool SavesR
     m_SyncCPU(nullptr),
     m_SyncPlugins(nullptr),
     m_MMU_VM(SavesReadOnly),
+    m_SaveStateBase(m_MMU_VM),
+    m_Rewind(g_Settings->LoadDword(Setting_RewindBufferSize) * 0x100000),
+    m_RewindInterval(g_Settings->LoadBool(Setting_Rewind) && !SyncSystem ? g_Settings->LoadDword(Setting_RewindInterval) : 0),
+    m_RewindFrames(0),
     //m_Cheats(m_MMU_VM),
     m_TLB(this),
     m_Reg(this, this),
@@ -47,6 +48,10 @@ CN64System::CN64System(CPlugins * Plugins, uint32_t randomizer_seed, bool SavesR
     m_TLBLoadAddress(0),
     m_TLBStoreAddress(0),
     m_SyncCount(0),
+    m_ViCount(0),
+    m_ViCycles(0),
+    m_BenchmarkFrames(g_Settings->LoadDword(Setting_BenchmarkFrames)),
+    m_BenchmarkCycles(g_Settings->LoadDword(Setting_BenchmarkCycles)),
     m_thread(nullptr),
     m_hPauseEvent(true),
     m_SyncSystem(SyncSystem),
@@ -196,6 +201,8 @@ void CN64System::ExternalEvent(SystemEvent action)
     case SysEvent_ResetFunctionTimes:
     case SysEvent_DumpFunctionTimes:
     case SysEvent_ResetRecompilerCode:
+    case SysEvent_RewindCapture:
+    case SysEvent_RewindState:
         QueueEvent(action);
         break;
     case SysEvent_PauseCPU_AppLostFocus:
@@ -770,6 +777,7 @@ void CN64System::Pause()
     PauseType pause_type = (PauseType)g_Settings->LoadDword(GameRunning_CPU_PausedType);
     m_hPauseEvent.Reset();
     g_Settings->SaveBool(GameRunning_CPU_Paused, true);
+    m_MMU_VM.FlushSaveChips();
     if (pause_type == PauseType_FromMenu)
     {
         g_Notify->DisplayMessage(5, MSG_CPU_PAUSED);
@@ -789,6 +797,7 @@ void CN64System::GameReset()
     m_Plugins->Gfx()->ShowCFB();
     m_Reg.FAKE_CAUSE_REGISTER |= CAUSE_IP4;
     m_Plugins->Gfx()->SoftReset();
+    m_Rewind.Clear();
     if (m_SyncCPU)
     {
         m_SyncCPU->GameReset();
@@ -844,6 +853,10 @@ void CN64System::Reset(bool bInitReg, bool ClearMenory)
     g_Settings->SaveBool(GameRunning_InReset, true);
     RefreshGameSettings();
     m_Audio.Reset();
+    if (m_Recomp)
+    {
+        m_Recomp->WaitForBackgroundCompile();
+    }
     m_MMU_VM.Reset(ClearMenory);
 
     m_CyclesToSkip = 0;
@@ -863,6 +876,8 @@ void CN64System::Reset(bool bInitReg, bool ClearMenory)
     {
         bool PostPif = true;
 
+        // Only a hard reset drops the rewind snapshots, loading a state (including a rewind) resets with bInitReg false
+        m_Rewind.Clear();
         InitRegisters(PostPif, m_MMU_VM);
         if (PostPif)
         {
@@ -1298,41 +1313,75 @@ void CN64System::SyncCPU(CN64System * const SecondCPU)
         ErrorFound = true;
     }
 #endif
-    if (m_Reg.m_PROGRAM_COUNTER != SecondCPU->m_Reg.m_PROGRAM_COUNTER)
+    // Most blocks leave both cores identical, so compare the register file as a whole first
+    // and only check register by register when something differs
+    if (!SyncRegistersMatch(SecondCPU))
     {
-        ErrorFound = true;
-    }
-    if (b32BitCore())
-    {
-        for (int count = 0; count < 32; count++)
+        if (m_Reg.m_PROGRAM_COUNTER != SecondCPU->m_Reg.m_PROGRAM_COUNTER)
         {
-            if (m_Reg.m_GPR[count].W[0] != SecondCPU->m_Reg.m_GPR[count].W[0])
-            {
-                ErrorFound = true;
-            }
-            if (m_Reg.m_FPR[count].DW != SecondCPU->m_Reg.m_FPR[count].DW)
+            ErrorFound = true;
+        }
+        if (b32BitCore())
+        {
+            for (int count = 0; count < 32; count++)
             {
-                ErrorFound = true;
+                if (m_Reg.m_GPR[count].W[0] != SecondCPU->m_Reg.m_GPR[count].W[0])
+                {
+                    ErrorFound = true;
+                }
+                if (m_Reg.m_FPR[count].DW != SecondCPU->m_Reg.m_FPR[count].DW)
+                {
+                    ErrorFound = true;
+                }
+                if (m_Reg.m_CP0[count] != SecondCPU->m_Reg.m_CP0[count])
+                {
+                    ErrorFound = true;
+                }
             }
-            if (m_Reg.m_CP0[count] != SecondCPU->m_Reg.m_CP0[count])
+        }
+        else
+        {
+            for (int count = 0; count < 32; count++)
             {
-                ErrorFound = true;
+                if (m_Reg.m_GPR[count].DW != SecondCPU->m_Reg.m_GPR[count].DW)
+                {
+                    ErrorFound = true;
+                }
+                if (m_Reg.m_FPR[count].DW != SecondCPU->m_Reg.m_FPR[count].DW)
+                {
+                    ErrorFound = true;
+                }
+                if (m_Reg.m_CP0[count] != SecondCPU->m_Reg.m_CP0[count])
+                {
+                    ErrorFound = true;
+                }
             }
         }
-    }
-    else
-    {
-        for (int count = 0; count < 32; count++)
+
+        if (m_Reg.m_FPCR[0] != SecondCPU->m_Reg.m_FPCR[0]) { ErrorFound = true; }
+        if (m_Reg.m_FPCR[31] != SecondCPU->m_Reg.m_FPCR[31]) { ErrorFound = true; }
+        if (m_Reg.m_HI.DW != SecondCPU->m_Reg.m_HI.DW) { ErrorFound = true; }
+        if (m_Reg.m_LO.DW != SecondCPU->m_Reg.m_LO.DW) { ErrorFound = true; }
+
+        for (int i = 0, n = sizeof(m_Reg.m_Mips_Interface) / sizeof(m_Reg.m_Mips_Interface[0]); i < n; i++)
         {
-            if (m_Reg.m_GPR[count].DW != SecondCPU->m_Reg.m_GPR[count].DW)
+            if (m_Reg.m_Mips_Interface[i] != SecondCPU->m_Reg.m_Mips_Interface[i])
             {
                 ErrorFound = true;
             }
-            if (m_Reg.m_FPR[count].DW != SecondCPU->m_Reg.m_FPR[count].DW)
+        }
+
+        for (int i = 0, n = sizeof(m_Reg.m_SigProcessor_Interface) / sizeof(m_Reg.m_SigProcessor_Interface[0]); i < n; i++)
+        {
+            if (m_Reg.m_SigProcessor_Interface[i] != SecondCPU->m_Reg.m_SigProcessor_Interface[i])
             {
                 ErrorFound = true;
             }
-            if (m_Reg.m_CP0[count] != SecondCPU->m_Reg.m_CP0[count])
+        }
+
+        for (int i = 0, n = sizeof(m_Reg.m_Display_ControlReg) / sizeof(m_Reg.m_Display_ControlReg[0]); i < n; i++)
+        {
+            if (m_Reg.m_Display_ControlReg[i] != SecondCPU->m_Reg.m_Display_ControlReg[i])
             {
                 ErrorFound = true;
             }
@@ -1344,10 +1393,6 @@ void CN64System::SyncCPU(CN64System * const SecondCPU)
         ErrorFound = true; 
     }
     if (m_TLB != SecondCPU->m_TLB) { ErrorFound = true; }
-    if (m_Reg.m_FPCR[0] != SecondCPU->m_Reg.m_FPCR[0]) { ErrorFound = true; }
-    if (m_Reg.m_FPCR[31] != SecondCPU->m_Reg.m_FPCR[31]) { ErrorFound = true; }
-    if (m_Reg.m_HI.DW != SecondCPU->m_Reg.m_HI.DW) { ErrorFound = true; }
-    if (m_Reg.m_LO.DW != SecondCPU->m_Reg.m_LO.DW) { ErrorFound = true; }
     /*if (m_SyncCount > 4788000)
     {
     if (memcmp(m_MMU_VM.Rdram(),SecondCPU->m_MMU_VM.Rdram(),RdramSize()) != 0)
@@ -1385,37 +1430,44 @@ void CN64System::SyncCPU(CN64System * const SecondCPU)
     if (m_NextTimer != SecondCPU->m_NextTimer) { ErrorFound = true; }
     if (m_Reg.m_RoundingModel != SecondCPU->m_Reg.m_RoundingModel) { ErrorFound = true; }
 
-    for (int i = 0, n = sizeof(m_Reg.m_Mips_Interface) / sizeof(m_Reg.m_Mips_Interface[0]); i < n; i++)
-    {
-        if (m_Reg.m_Mips_Interface[i] != SecondCPU->m_Reg.m_Mips_Interface[i])
-        {
-            ErrorFound = true;
-        }
-    }
+    if (ErrorFound) { DumpSyncErrors(SecondCPU); }
 
-    for (int i = 0, n = sizeof(m_Reg.m_SigProcessor_Interface) / sizeof(m_Reg.m_SigProcessor_Interface[0]); i < n; i++)
+    for (int i = (sizeof(m_LastSuccessSyncPC) / sizeof(m_LastSuccessSyncPC[0])) - 1; i > 0; i--)
     {
-        if (m_Reg.m_SigProcessor_Interface[i] != SecondCPU->m_Reg.m_SigProcessor_Interface[i])
-        {
-            ErrorFound = true;
-        }
+        m_LastSuccessSyncPC[i] = m_LastSuccessSyncPC[i - 1];
     }
+    m_LastSuccessSyncPC[0] = m_Reg.m_PROGRAM_COUNTER;
+}
 
-    for (int i = 0, n = sizeof(m_Reg.m_Display_ControlReg) / sizeof(m_Reg.m_Display_ControlReg[0]); i < n; i++)
+bool CN64System::SyncRegistersMatch(CN64System * const SecondCPU) const
+{
+    // Must cover the same registers as the checks in SyncCPU, anything extra only sends
+    // blocks that are in sync down the slow path
+    const CRegisters & Reg = SecondCPU->m_Reg;
+    if (b32BitCore())
     {
-        if (m_Reg.m_Display_ControlReg[i] != SecondCPU->m_Reg.m_Display_ControlReg[i])
+        for (int count = 0; count < 32; count++)
         {
-            ErrorFound = true;
+            if (m_Reg.m_GPR[count].W[0] != Reg.m_GPR[count].W[0])
+            {
+                return false;
+            }
         }
     }
-
-    if (ErrorFound) { DumpSyncErrors(SecondCPU); }
-
-    for (int i = (sizeof(m_LastSuccessSyncPC) / sizeof(m_LastSuccessSyncPC[0])) - 1; i > 0; i--)
+    else if (memcmp(m_Reg.m_GPR, Reg.m_GPR, sizeof(m_Reg.m_GPR)) != 0)
     {
-        m_LastSuccessSyncPC[i] = m_LastSuccessSyncPC[i - 1];
+        return false;
     }
-    m_LastSuccessSyncPC[0] = m_Reg.m_PROGRAM_COUNTER;
+    return m_Reg.m_PROGRAM_COUNTER == Reg.m_PROGRAM_COUNTER &&
+        memcmp(m_Reg.m_FPR, Reg.m_FPR, sizeof(m_Reg.m_FPR)) == 0 &&
+        memcmp(m_Reg.m_CP0, Reg.m_CP0, 32 * sizeof(m_Reg.m_CP0[0])) == 0 &&
+        m_Reg.m_FPCR[0] == Reg.m_FPCR[0] &&
+        m_Reg.m_FPCR[31] == Reg.m_FPCR[31] &&
+        m_Reg.m_HI.DW == Reg.m_HI.DW &&
+        m_Reg.m_LO.DW == Reg.m_LO.DW &&
+        memcmp(m_Reg.m_Mips_Interface, Reg.m_Mips_Interface, sizeof(m_Reg.m_Mips_Interface)) == 0 &&
+        memcmp(m_Reg.m_SigProcessor_Interface, Reg.m_SigProcessor_Interface, sizeof(m_Reg.m_SigProcessor_Interface)) == 0 &&
+        memcmp(m_Reg.m_Display_ControlReg, Reg.m_Display_ControlReg, sizeof(m_Reg.m_Display_ControlReg)) == 0;
 }
 
 void CN64System::SyncSystem()
@@ -1676,6 +1728,74 @@ void CN64System::DumpSyncErrors(CN64System * SecondCPU)
     g_Notify->BreakPoint(__FILE__, __LINE__);
 }
 
+void CN64System::SaveStateData(CSaveStateBuffer & State, CSaveStateBuffer & ExtraInfo, const CSaveStateBase::PAGE_LIST * ChangedPages)
+{
+    uint32_t SaveID = ChangedPages != nullptr ? SaveID_3 : SaveID_0;
+    uint32_t RdramSize = g_Settings->LoadDword(Game_RDRamSize);
+    uint32_t NextViTimer = m_SystemTimer.GetTimer(CSystemTimer::ViTimer);
+    uint32_t PageCount = ChangedPages != nullptr ? (uint32_t)ChangedPages->size() : 0;
+
+    State.Write(&SaveID, sizeof(uint32_t));
+    State.Write(&RdramSize, sizeof(uint32_t));
+    if (g_Settings->LoadBool(Setting_EnableDisk) && g_Disk)
+    {
+        // Keep base ROM information (64DD IPL / compatible game ROM)
+        State.Write(&g_Rom->GetRomAddress()[0x10], 0x20);
+        State.Write(g_Disk->GetDiskAddressID(), 0x20);
+    }
+    else
+    {
+        State.Write(g_Rom->GetRomAddress(), 0x40);
+    }
+    if (ChangedPages != nullptr)
+    {
+        State.Write(m_SaveStateBase.Digest().digest, sizeof(m_SaveStateBase.Digest().digest));
+    }
+    State.Write(&NextViTimer, sizeof(uint32_t));
+    State.Write(&m_Reg.m_PROGRAM_COUNTER, sizeof(m_Reg.m_PROGRAM_COUNTER));
+    State.Write(m_Reg.m_GPR, sizeof(int64_t) * 32);
+    State.Write(m_Reg.m_FPR, sizeof(int64_t) * 32);
+    State.Write(m_Reg.m_CP0, sizeof(uint32_t) * 32);
+    State.Write(m_Reg.m_FPCR, sizeof(uint32_t) * 32);
+    State.Write(&m_Reg.m_HI, sizeof(int64_t));
+    State.Write(&m_Reg.m_LO, sizeof(int64_t));
+    State.Write(m_Reg.m_RDRAM_Registers, sizeof(uint32_t) * 10);
+    State.Write(m_Reg.m_SigProcessor_Interface, sizeof(uint32_t) * 10);
+    State.Write(m_Reg.m_Display_ControlReg, sizeof(uint32_t) * 10);
+    State.Write(m_Reg.m_Mips_Interface, sizeof(uint32_t) * 4);
+    State.Write(m_Reg.m_Video_Interface, sizeof(uint32_t) * 14);
+    State.Write(m_Reg.m_Audio_Interface, sizeof(uint32_t) * 6);
+    State.Write(m_Reg.m_Peripheral_Interface, sizeof(uint32_t) * 13);
+    State.Write(m_Reg.m_RDRAM_Interface, sizeof(uint32_t) * 8);
+    State.Write(m_Reg.m_SerialInterface, sizeof(uint32_t) * 4);
+    State.Write(&m_TLB.TlbEntry(0), sizeof(CTLB::TLB_ENTRY) * 32);
+    State.Write(m_MMU_VM.PifRam(), 0x40);
+    if (ChangedPages != nullptr)
+    {
+        State.Write(&PageCount, sizeof(PageCount));
+        for (uint32_t i = 0; i < PageCount; i++)
+        {
+            State.Write(&(*ChangedPages)[i], sizeof(uint32_t));
+            State.Write(m_MMU_VM.Rdram() + ((*ChangedPages)[i] << 12), 0x1000);
+        }
+    }
+    else
+    {
+        State.Write(m_MMU_VM.Rdram(), RdramSize);
+    }
+    State.Write(m_MMU_VM.Dmem(), 0x1000);
+    State.Write(m_MMU_VM.Imem(), 0x1000);
+
+    // Extra info v2
+    ExtraInfo.Write(&SaveID_2, sizeof(uint32_t));
+
+    // Disk interface info
+    ExtraInfo.Write(m_Reg.m_DiskInterface, sizeof(uint32_t) * 22);
+
+    // System timers info
+    m_SystemTimer.SaveData(ExtraInfo);
+}
+
 bool CN64System::SaveState()
 {
     WriteTrace(TraceN64System, TraceDebug, "Start");
@@ -1730,150 +1850,114 @@ bool CN64System::SaveState()
         }
     }
 
-    uint32_t RdramSize = g_Settings->LoadDword(Game_RDRamSize);
     uint32_t MiInterReg = g_Reg->MI_INTR_REG;
-    uint32_t NextViTimer = m_SystemTimer.GetTimer(CSystemTimer::ViTimer);
-    if (g_Settings->LoadDword(Setting_AutoZipInstantSave))
-    {
-        ZipFile.Delete();
-        zipFile file = zipOpen(ZipFile, 0);
-        zipOpenNewFileInZip(file, SaveFile.GetNameExtension().c_str(), nullptr, nullptr, 0, nullptr, 0, nullptr, Z_DEFLATED, Z_DEFAULT_COMPRESSION);
-        zipWriteInFileInZip(file, &SaveID_0, sizeof(SaveID_0));
-        zipWriteInFileInZip(file, &RdramSize, sizeof(uint32_t));
-        if (g_Settings->LoadBool(Setting_EnableDisk) && g_Disk)
-        {
-            // Keep base ROM information (64DD IPL / compatible game ROM)
-            zipWriteInFileInZip(file, &g_Rom->GetRomAddress()[0x10], 0x20);
-            zipWriteInFileInZip(file, g_Disk->GetDiskAddressID(), 0x20);
-        }
-        else
-        {
-            zipWriteInFileInZip(file, g_Rom->GetRomAddress(), 0x40);
-        }
-        zipWriteInFileInZip(file, &NextViTimer, sizeof(uint32_t));
-        zipWriteInFileInZip(file, &m_Reg.m_PROGRAM_COUNTER, sizeof(m_Reg.m_PROGRAM_COUNTER));
-        zipWriteInFileInZip(file, m_Reg.m_GPR, sizeof(int64_t) * 32);
-        zipWriteInFileInZip(file, m_Reg.m_FPR, sizeof(int64_t) * 32);
-        zipWriteInFileInZip(file, m_Reg.m_CP0, sizeof(uint32_t) * 32);
-        zipWriteInFileInZip(file, m_Reg.m_FPCR, sizeof(uint32_t) * 32);
-        zipWriteInFileInZip(file, &m_Reg.m_HI, sizeof(int64_t));
-        zipWriteInFileInZip(file, &m_Reg.m_LO, sizeof(int64_t));
-        zipWriteInFileInZip(file, m_Reg.m_RDRAM_Registers, sizeof(uint32_t) * 10);
-        zipWriteInFileInZip(file, m_Reg.m_SigProcessor_Interface, sizeof(uint32_t) * 10);
-        zipWriteInFileInZip(file, m_Reg.m_Display_ControlReg, sizeof(uint32_t) * 10);
-        zipWriteInFileInZip(file, m_Reg.m_Mips_Interface, sizeof(uint32_t) * 4);
-        zipWriteInFileInZip(file, m_Reg.m_Video_Interface, sizeof(uint32_t) * 14);
-        zipWriteInFileInZip(file, m_Reg.m_Audio_Interface, sizeof(uint32_t) * 6);
-        zipWriteInFileInZip(file, m_Reg.m_Peripheral_Interface, sizeof(uint32_t) * 13);
-        zipWriteInFileInZip(file, m_Reg.m_RDRAM_Interface, sizeof(uint32_t) * 8);
-        zipWriteInFileInZip(file, m_Reg.m_SerialInterface, sizeof(uint32_t) * 4);
-        zipWriteInFileInZip(file, (void *const)&m_TLB.TlbEntry(0), sizeof(CTLB::TLB_ENTRY) * 32);
-        zipWriteInFileInZip(file, m_MMU_VM.PifRam(), 0x40);
-        zipWriteInFileInZip(file, m_MMU_VM.Rdram(), RdramSize);
-        zipWriteInFileInZip(file, m_MMU_VM.Dmem(), 0x1000);
-        zipWriteInFileInZip(file, m_MMU_VM.Imem(), 0x1000);
-        zipCloseFileInZip(file);
-
-        zipOpenNewFileInZip(file, ExtraInfo.GetNameExtension().c_str(), nullptr, nullptr, 0, nullptr, 0, nullptr, Z_DEFLATED, Z_DEFAULT_COMPRESSION);
-
-        // Extra info v2
-        zipWriteInFileInZip(file, &SaveID_2, sizeof(SaveID_2));
 
-        // Disk interface info
-        zipWriteInFileInZip(file, m_Reg.m_DiskInterface, sizeof(uint32_t) * 22);
-
-        // System timers info
-        m_SystemTimer.SaveData(file);
+    // Incremental states only hold the RDRAM pages that changed since the base image
+    CSaveStateBase::PAGE_LIST ChangedPages;
+    MD5Digest PreviousBase = m_SaveStateBase.Digest();
+    bool Incremental = g_Settings->LoadBool(Setting_IncrementalSaveStates) && m_SaveStateBase.ChangedPages(SaveFile, g_Settings->LoadDword(Game_RDRamSize), ChangedPages);
+    if (Incremental && memcmp(PreviousBase.digest, m_SaveStateBase.Digest().digest, sizeof(PreviousBase.digest)) != 0)
+    {
+        PruneSaveStateBases(SaveFile);
+    }
 
-        zipCloseFileInZip(file);
+    // Only the copy into memory happens here, compressing and writing is left to the save state writer
+    SaveStateData(m_SaveStateWriter.State(), m_SaveStateWriter.ExtraInfo(), Incremental ? &ChangedPages : nullptr);
 
-        zipClose(file, "");
-#if defined(ANDROID)
-        utimes((const char *)ZipFile, nullptr);
-#endif
+    WriteTrace(TraceN64System, TraceDebug, "SaveFile: %s", (const char *)SaveFile);
+    if (g_Settings->LoadDword(Setting_AutoZipInstantSave))
+    {
+        m_SaveStateWriter.Commit(SaveFile, ExtraInfo, ZipFile, (SAVE_STATE_COMPRESSION)g_Settings->LoadDword(Setting_SaveStateCompression));
     }
     else
     {
-        WriteTrace(TraceN64System, TraceDebug, "SaveFile: %s", (const char *)SaveFile);
-        ExtraInfo.Delete();
-        SaveFile.Delete();
-        CFile hSaveFile(SaveFile, CFileBase::modeWrite | CFileBase::modeCreate);
-        if (!hSaveFile.IsOpen())
-        {
-            g_Notify->DisplayError(GS(MSG_FAIL_OPEN_SAVE));
-            m_Reg.MI_INTR_REG = MiInterReg;
-            WriteTrace(TraceN64System, TraceDebug, "Done - Failed to open");
-            return true;
-        }
+        m_SaveStateWriter.Commit(SaveFile, ExtraInfo, CPath(), SaveStateCompression_Stored);
+    }
+    m_Reg.MI_INTR_REG = MiInterReg;
+    g_Settings->SaveString(GameRunning_InstantSaveFile, "");
+    g_Settings->SaveDword(Game_LastSaveTime, (uint32_t)time(nullptr));
+    WriteTrace(TraceN64System, TraceDebug, "Done");
+    return true;
+}
 
-        // Write info to file
-        hSaveFile.SeekToBegin();
-        hSaveFile.Write(&SaveID_0, sizeof(uint32_t));
-        hSaveFile.Write(&RdramSize, sizeof(uint32_t));
-        if (g_Settings->LoadBool(Setting_EnableDisk) && g_Disk)
+bool CN64System::SaveStateBaseDigest(const CPath & FileName, MD5Digest & Digest) const
+{
+    // Only the start of the state is needed: save id, RDRAM size, ROM header and the base digest
+    uint8_t Header[sizeof(uint32_t) * 2 + 0x40 + sizeof(Digest.digest)];
+    uint32_t HeaderSize = 0;
+
+    if (_stricmp(FileName.GetExtension().c_str(), ".zip") == 0)
+    {
+        unzFile file = unzOpen(FileName);
+        int port = file != nullptr ? unzGoToFirstFile(file) : UNZ_END_OF_LIST_OF_FILE;
+        while (port == UNZ_OK && HeaderSize == 0)
         {
-            // Keep base ROM information (64DD IPL / compatible game ROM)
-            hSaveFile.Write(&g_Rom->GetRomAddress()[0x10], 0x20);
-            hSaveFile.Write(g_Disk->GetDiskAddressID(), 0x20);
+            if (unzOpenCurrentFile(file) == UNZ_OK)
+            {
+                if (unzReadCurrentFile(file, Header, sizeof(Header)) == sizeof(Header) && *(uint32_t *)Header == SaveID_3)
+                {
+                    HeaderSize = sizeof(Header);
+                }
+                unzCloseCurrentFile(file);
+            }
+            port = unzGoToNextFile(file);
         }
-        else
+        if (file != nullptr)
         {
-            hSaveFile.Write(g_Rom->GetRomAddress(), 0x40);
-        }
-        hSaveFile.Write(&NextViTimer, sizeof(uint32_t));
-        hSaveFile.Write(&m_Reg.m_PROGRAM_COUNTER, sizeof(m_Reg.m_PROGRAM_COUNTER));
-        hSaveFile.Write(m_Reg.m_GPR, sizeof(int64_t) * 32);
-        hSaveFile.Write(m_Reg.m_FPR, sizeof(int64_t) * 32);
-        hSaveFile.Write(m_Reg.m_CP0, sizeof(uint32_t) * 32);
-        hSaveFile.Write(m_Reg.m_FPCR, sizeof(uint32_t) * 32);
-        hSaveFile.Write(&m_Reg.m_HI, sizeof(int64_t));
-        hSaveFile.Write(&m_Reg.m_LO, sizeof(int64_t));
-        hSaveFile.Write(m_Reg.m_RDRAM_Registers, sizeof(uint32_t) * 10);
-        hSaveFile.Write(m_Reg.m_SigProcessor_Interface, sizeof(uint32_t) * 10);
-        hSaveFile.Write(m_Reg.m_Display_ControlReg, sizeof(uint32_t) * 10);
-        hSaveFile.Write(m_Reg.m_Mips_Interface, sizeof(uint32_t) * 4);
-        hSaveFile.Write(m_Reg.m_Video_Interface, sizeof(uint32_t) * 14);
-        hSaveFile.Write(m_Reg.m_Audio_Interface, sizeof(uint32_t) * 6);
-        hSaveFile.Write(m_Reg.m_Peripheral_Interface, sizeof(uint32_t) * 13);
-        hSaveFile.Write(m_Reg.m_RDRAM_Interface, sizeof(uint32_t) * 8);
-        hSaveFile.Write(m_Reg.m_SerialInterface, sizeof(uint32_t) * 4);
-        hSaveFile.Write(&m_TLB.TlbEntry(0), sizeof(CTLB::TLB_ENTRY) * 32);
-        hSaveFile.Write(g_MMU->PifRam(), 0x40);
-        hSaveFile.Write(g_MMU->Rdram(), RdramSize);
-        hSaveFile.Write(g_MMU->Dmem(), 0x1000);
-        hSaveFile.Write(g_MMU->Imem(), 0x1000);
-        hSaveFile.Close();
-
-        CFile hExtraInfo(ExtraInfo, CFileBase::modeWrite | CFileBase::modeCreate);
-        if (hExtraInfo.IsOpen())
+            unzClose(file);
+        }
+    }
+    else
+    {
+        CFile hSaveFile(FileName, CFileBase::modeRead);
+        if (hSaveFile.IsOpen() && hSaveFile.Read(Header, sizeof(Header)) == sizeof(Header))
         {
-            // Extra info v2
-            hExtraInfo.Write(&SaveID_2, sizeof(uint32_t));
-
-            // Disk interface info
-            hExtraInfo.Write(m_Reg.m_DiskInterface, sizeof(uint32_t) * 22);
-
-            // System timers info
-            m_SystemTimer.SaveData(hExtraInfo);
-            hExtraInfo.Close();
+            HeaderSize = sizeof(Header);
         }
     }
-    m_Reg.MI_INTR_REG = MiInterReg;
-    g_Settings->SaveString(GameRunning_InstantSaveFile, "");
-    g_Settings->SaveDword(Game_LastSaveTime, (uint32_t)time(nullptr));
-    if (g_Settings->LoadDword(Setting_AutoZipInstantSave))
+
+    if (HeaderSize == 0 || *(uint32_t *)Header != SaveID_3)
     {
-        SaveFile = ZipFile;
+        return false;
     }
-    g_Notify->DisplayMessage(3, stdstr_f("%s %s", g_Lang->GetString(MSG_SAVED_STATE).c_str(), stdstr(SaveFile.GetNameExtension()).c_str()).c_str());
-    WriteTrace(TraceN64System, TraceDebug, "Done");
+    memcpy(Digest.digest, &Header[sizeof(Header) - sizeof(Digest.digest)], sizeof(Digest.digest));
     return true;
 }
 
+void CN64System::PruneSaveStateBases(const CPath & SaveFile)
+{
+    // States still being written would not be seen
+    m_SaveStateWriter.WaitForIdle();
+
+    CSaveStateBase::DIGEST_LIST InUse;
+    const char * StatePatterns[] = { "*.pj*", "*.zip" };
+    for (size_t i = 0; i < sizeof(StatePatterns) / sizeof(StatePatterns[0]); i++)
+    {
+        CPath StateFile(SaveFile);
+        StateFile.SetNameExtension(StatePatterns[i]);
+        if (!StateFile.FindFirst())
+        {
+            continue;
+        }
+        do
+        {
+            MD5Digest Digest;
+            if (_stricmp(StateFile.GetExtension().c_str(), ".pjbase") != 0 && SaveStateBaseDigest(StateFile, Digest))
+            {
+                InUse.push_back(Digest);
+            }
+        } while (StateFile.FindNext());
+    }
+    m_SaveStateBase.Prune(SaveFile, InUse);
+}
+
 bool CN64System::LoadState()
 {
     WriteTrace(TraceN64System, TraceDebug, "Start");
 
+    // A state that was just saved may still be being written
+    m_SaveStateWriter.WaitForIdle();
+
     stdstr InstantFileName = g_Settings->LoadStringVal(GameRunning_InstantSaveFile);
     if (!InstantFileName.empty())
     {
@@ -1943,14 +2027,11 @@ bool CN64System::LoadState()
 bool CN64System::LoadState(const char * FileName)
 {
     WriteTrace(TraceN64System, TraceDebug, "(%s): Start", FileName);
-
-    uint32_t Value, SaveRDRAMSize, NextVITimer = 0, old_status, old_width, old_dacrate;
-    bool LoadedZipFile = false, AudioResetOnLoad;
-    old_status = m_Reg.VI_STATUS_REG;
-    old_width = m_Reg.VI_WIDTH_REG;
-    old_dacrate = m_Reg.AI_DACRATE_REG;
+    m_SaveStateWriter.WaitForIdle();
 
     CPath SaveFile(FileName);
+    CSaveStateBuffer State, ExtraInfo;
+    bool LoadedZipFile = false;
 
     if (g_Settings->LoadDword(Setting_AutoZipInstantSave) || _stricmp(SaveFile.GetExtension().c_str(), ".zip") == 0)
     {
@@ -1969,195 +2050,205 @@ bool CN64System::LoadState(const char * FileName)
         {
             unz_file_info info;
             char zname[132];
+            uint32_t Value = 0;
 
             unzGetCurrentFileInfo(file, &info, zname, 128, nullptr, 0, nullptr, 0);
-            if (unzLocateFile(file, zname, 1) != UNZ_OK)
-            {
-                unzClose(file);
-                port = -1;
-                continue;
-            }
             if (unzOpenCurrentFile(file) != UNZ_OK)
             {
-                unzClose(file);
-                port = -1;
-                continue;
+                break;
             }
-            unzReadCurrentFile(file, &Value, 4);
-            if (!LoadedZipFile && Value == SaveID_0 && port == UNZ_OK)
-            {
-                unzReadCurrentFile(file, &SaveRDRAMSize, sizeof(SaveRDRAMSize));
-                // Check header
 
-                uint8_t LoadHeader[64];
-                unzReadCurrentFile(file, LoadHeader, 0x40);
-                if (g_Settings->LoadBool(Setting_EnableDisk) && g_Disk)
+            // The entries are told apart by their first word rather than their name
+            CSaveStateBuffer * Buffer = nullptr;
+            if (info.uncompressed_size >= sizeof(Value) && unzReadCurrentFile(file, &Value, sizeof(Value)) == sizeof(Value))
+            {
+                if (State.Length() == 0 && (Value == SaveID_0 || Value == SaveID_3))
                 {
-                    // Base ROM information (64DD IPL / compatible game ROM) and disk info check
-                    if ((memcmp(LoadHeader, &g_Rom->GetRomAddress()[0x10], 0x20) != 0 ||
-                        memcmp(&LoadHeader[0x20], g_Disk->GetDiskAddressID(), 0x20) != 0) &&
-                        !g_Notify->AskYesNoQuestion(g_Lang->GetString(MSG_SAVE_STATE_HEADER).c_str()))
-                    {
-                        return false;
-                    }
+                    Buffer = &State;
                 }
-                else
+                else if (ExtraInfo.Length() == 0 && (Value == SaveID_1 || Value == SaveID_2))
                 {
-                    if (memcmp(LoadHeader, g_Rom->GetRomAddress(), 0x40) != 0 &&
-                        !g_Notify->AskYesNoQuestion(g_Lang->GetString(MSG_SAVE_STATE_HEADER).c_str()))
-                    {
-                        return false;
-                    }
+                    Buffer = &ExtraInfo;
                 }
-                Reset(false, true);
-
-                m_MMU_VM.UnProtectMemory(0x80000000, 0x80000000 + g_Settings->LoadDword(Game_RDRamSize) - 4);
-                m_MMU_VM.UnProtectMemory(0xA4000000, 0xA4001FFC);
-                g_Settings->SaveDword(Game_RDRamSize, SaveRDRAMSize);
-                unzReadCurrentFile(file, &NextVITimer, sizeof(NextVITimer));
-                unzReadCurrentFile(file, &m_Reg.m_PROGRAM_COUNTER, sizeof(m_Reg.m_PROGRAM_COUNTER));
-                unzReadCurrentFile(file, m_Reg.m_GPR, sizeof(int64_t) * 32);
-                unzReadCurrentFile(file, m_Reg.m_FPR, sizeof(int64_t) * 32);
-                unzReadCurrentFile(file, m_Reg.m_CP0, sizeof(uint32_t) * 32);
-                unzReadCurrentFile(file, m_Reg.m_FPCR, sizeof(uint32_t) * 32);
-                unzReadCurrentFile(file, &m_Reg.m_HI, sizeof(int64_t));
-                unzReadCurrentFile(file, &m_Reg.m_LO, sizeof(int64_t));
-                unzReadCurrentFile(file, m_Reg.m_RDRAM_Registers, sizeof(uint32_t) * 10);
-                unzReadCurrentFile(file, m_Reg.m_SigProcessor_Interface, sizeof(uint32_t) * 10);
-                unzReadCurrentFile(file, m_Reg.m_Display_ControlReg, sizeof(uint32_t) * 10);
-                unzReadCurrentFile(file, m_Reg.m_Mips_Interface, sizeof(uint32_t) * 4);
-                unzReadCurrentFile(file, m_Reg.m_Video_Interface, sizeof(uint32_t) * 14);
-                unzReadCurrentFile(file, m_Reg.m_Audio_Interface, sizeof(uint32_t) * 6);
-                unzReadCurrentFile(file, m_Reg.m_Peripheral_Interface, sizeof(uint32_t) * 13);
-                unzReadCurrentFile(file, m_Reg.m_RDRAM_Interface, sizeof(uint32_t) * 8);
-                unzReadCurrentFile(file, m_Reg.m_SerialInterface, sizeof(uint32_t) * 4);
-                unzReadCurrentFile(file, (void *const)&m_TLB.TlbEntry(0), sizeof(CTLB::TLB_ENTRY) * 32);
-                unzReadCurrentFile(file, m_MMU_VM.PifRam(), 0x40);
-                unzReadCurrentFile(file, m_MMU_VM.Rdram(), SaveRDRAMSize);
-                unzReadCurrentFile(file, m_MMU_VM.Dmem(), 0x1000);
-                unzReadCurrentFile(file, m_MMU_VM.Imem(), 0x1000);
-                unzCloseCurrentFile(file);
-                port = unzGoToFirstFile(file);
-                LoadedZipFile = true;
-                continue;
-            }
-            if (LoadedZipFile && Value == SaveID_1 && port == UNZ_OK)
-            {
-                // Extra info v1
-                // System timers info
-                m_SystemTimer.LoadData(file);
             }
-            if (LoadedZipFile && Value == SaveID_2 && port == UNZ_OK)
+            if (Buffer != nullptr)
             {
-                // Extra info v2 (Project64 2.4)
-                // Disk interface info
-                unzReadCurrentFile(file, m_Reg.m_DiskInterface, sizeof(uint32_t) * 22);
-
-                // Recover disk seek address (if the save state is done while loading/saving data)
-                if (g_Disk)
-                    DiskBMReadWrite(false);
-
-                // System timers info
-                m_SystemTimer.LoadData(file);
+                Buffer->SetLength(info.uncompressed_size);
+                memcpy(Buffer->Data(), &Value, sizeof(Value));
+                unzReadCurrentFile(file, Buffer->Data() + sizeof(Value), Buffer->Length() - sizeof(Value));
             }
             unzCloseCurrentFile(file);
             port = unzGoToNextFile(file);
         }
-        unzClose(file);
+        if (file != nullptr)
+        {
+            unzClose(file);
+        }
+        LoadedZipFile = State.Length() != 0;
     }
     if (!LoadedZipFile)
     {
+        State.Clear();
+        ExtraInfo.Clear();
+
         CFile hSaveFile(SaveFile, CFileBase::modeRead);
         if (!hSaveFile.IsOpen())
         {
             g_Notify->DisplayMessage(3, stdstr_f("%s %s", GS(MSG_UNABLED_LOAD_STATE), FileName).c_str());
             return false;
         }
+        State.SetLength(hSaveFile.GetLength());
         hSaveFile.SeekToBegin();
+        hSaveFile.Read(State.Data(), State.Length());
+        hSaveFile.Close();
 
-        hSaveFile.Read(&Value, sizeof(Value));
-        if (Value != SaveID_0)
+        CPath ExtraInfoFile(SaveFile);
+        ExtraInfoFile.SetExtension(".dat");
+        CFile hExtraInfo(ExtraInfoFile, CFileBase::modeRead);
+        if (hExtraInfo.IsOpen())
         {
-            return false;
+            ExtraInfo.SetLength(hExtraInfo.GetLength());
+            hExtraInfo.SeekToBegin();
+            hExtraInfo.Read(ExtraInfo.Data(), ExtraInfo.Length());
+            hExtraInfo.Close();
         }
+    }
 
-        hSaveFile.Read(&SaveRDRAMSize, sizeof(SaveRDRAMSize));
-
-        // Check header
-        uint8_t LoadHeader[64];
-        hSaveFile.Read(LoadHeader, 0x40);
-        if (g_Settings->LoadBool(Setting_EnableDisk) && g_Disk)
+    if (!LoadStateData(State, ExtraInfo, SaveFile))
+    {
+        return false;
+    }
+    m_Rewind.Clear();
+    if (g_Settings->LoadDword(Game_CpuType) == CPU_SyncCores)
+    {
+        if (m_SyncCPU)
         {
-            // Base ROM information (64DD IPL / compatible game ROM) and disk info check
-            if ((memcmp(LoadHeader, &g_Rom->GetRomAddress()[0x10], 0x20) != 0 ||
-                memcmp(&LoadHeader[0x20], g_Disk->GetDiskAddressID(), 0x20) != 0) &&
-                !g_Notify->AskYesNoQuestion(g_Lang->GetString(MSG_SAVE_STATE_HEADER).c_str()))
+            for (int i = 0; i < (sizeof(m_LastSuccessSyncPC) / sizeof(m_LastSuccessSyncPC[0])); i++)
             {
-                return false;
+                m_LastSuccessSyncPC[i] = 0;
             }
+            m_SyncCPU->SetActiveSystem(true);
+            m_SyncCPU->LoadStateData(State, ExtraInfo, SaveFile);
+            SetActiveSystem(true);
+            SyncCPU(m_SyncCPU);
         }
-        else
+    }
+    std::string LoadMsg = g_Lang->GetString(MSG_LOADED_STATE);
+    g_Notify->DisplayMessage(3, stdstr_f("%s %s", LoadMsg.c_str(), stdstr(SaveFile.GetNameExtension()).c_str()).c_str());
+    WriteTrace(TraceN64System, TraceDebug, "Done");
+    return true;
+}
+
+bool CN64System::LoadStateData(CSaveStateBuffer & State, CSaveStateBuffer & ExtraInfo, const CPath & SaveFile)
+{
+    uint32_t Value, SaveRDRAMSize, NextVITimer = 0, old_status, old_width, old_dacrate;
+    bool AudioResetOnLoad;
+    old_status = m_Reg.VI_STATUS_REG;
+    old_width = m_Reg.VI_WIDTH_REG;
+    old_dacrate = m_Reg.AI_DACRATE_REG;
+
+    State.SeekToBegin();
+    ExtraInfo.SeekToBegin();
+    State.Read(&Value, sizeof(Value));
+    if (Value != SaveID_0 && Value != SaveID_3)
+    {
+        return false;
+    }
+    bool Incremental = Value == SaveID_3;
+
+    State.Read(&SaveRDRAMSize, sizeof(SaveRDRAMSize));
+
+    // Check header
+    uint8_t LoadHeader[64];
+    State.Read(LoadHeader, 0x40);
+    if (g_Settings->LoadBool(Setting_EnableDisk) && g_Disk)
+    {
+        // Base ROM information (64DD IPL / compatible game ROM) and disk info check
+        if ((memcmp(LoadHeader, &g_Rom->GetRomAddress()[0x10], 0x20) != 0 ||
+            memcmp(&LoadHeader[0x20], g_Disk->GetDiskAddressID(), 0x20) != 0) &&
+            !g_Notify->AskYesNoQuestion(g_Lang->GetString(MSG_SAVE_STATE_HEADER).c_str()))
         {
-            if (memcmp(LoadHeader, g_Rom->GetRomAddress(), 0x40) != 0 &&
-                !g_Notify->AskYesNoQuestion(g_Lang->GetString(MSG_SAVE_STATE_HEADER).c_str()))
-            {
-                return false;
-            }
+            return false;
         }
-        Reset(false, true);
-        m_MMU_VM.UnProtectMemory(0x80000000, 0x80000000 + g_Settings->LoadDword(Game_RDRamSize) - 4);
-        m_MMU_VM.UnProtectMemory(0xA4000000, 0xA4001FFC);
-        g_Settings->SaveDword(Game_RDRamSize, SaveRDRAMSize);
-
-        hSaveFile.Read(&NextVITimer, sizeof(NextVITimer));
-        hSaveFile.Read(&m_Reg.m_PROGRAM_COUNTER, sizeof(m_Reg.m_PROGRAM_COUNTER));
-        hSaveFile.Read(m_Reg.m_GPR, sizeof(int64_t) * 32);
-        hSaveFile.Read(m_Reg.m_FPR, sizeof(int64_t) * 32);
-        hSaveFile.Read(m_Reg.m_CP0, sizeof(uint32_t) * 32);
-        hSaveFile.Read(m_Reg.m_FPCR, sizeof(uint32_t) * 32);
-        hSaveFile.Read(&m_Reg.m_HI, sizeof(int64_t));
-        hSaveFile.Read(&m_Reg.m_LO, sizeof(int64_t));
-        hSaveFile.Read(m_Reg.m_RDRAM_Registers, sizeof(uint32_t) * 10);
-        hSaveFile.Read(m_Reg.m_SigProcessor_Interface, sizeof(uint32_t) * 10);
-        hSaveFile.Read(m_Reg.m_Display_ControlReg, sizeof(uint32_t) * 10);
-        hSaveFile.Read(m_Reg.m_Mips_Interface, sizeof(uint32_t) * 4);
-        hSaveFile.Read(m_Reg.m_Video_Interface, sizeof(uint32_t) * 14);
-        hSaveFile.Read(m_Reg.m_Audio_Interface, sizeof(uint32_t) * 6);
-        hSaveFile.Read(m_Reg.m_Peripheral_Interface, sizeof(uint32_t) * 13);
-        hSaveFile.Read(m_Reg.m_RDRAM_Interface, sizeof(uint32_t) * 8);
-        hSaveFile.Read(m_Reg.m_SerialInterface, sizeof(uint32_t) * 4);
-        hSaveFile.Read((void *const)&m_TLB.TlbEntry(0), sizeof(CTLB::TLB_ENTRY) * 32);
-        hSaveFile.Read(m_MMU_VM.PifRam(), 0x40);
-        hSaveFile.Read(m_MMU_VM.Rdram(), SaveRDRAMSize);
-        hSaveFile.Read(m_MMU_VM.Dmem(), 0x1000);
-        hSaveFile.Read(m_MMU_VM.Imem(), 0x1000);
-        hSaveFile.Close();
-
-        CPath ExtraInfo(SaveFile);
-        ExtraInfo.SetExtension(".dat");
-        CFile hExtraInfo(ExtraInfo, CFileBase::modeRead);
-        if (hExtraInfo.IsOpen())
+    }
+    else
+    {
+        if (memcmp(LoadHeader, g_Rom->GetRomAddress(), 0x40) != 0 &&
+            !g_Notify->AskYesNoQuestion(g_Lang->GetString(MSG_SAVE_STATE_HEADER).c_str()))
         {
-            // Extra info version check
-            hExtraInfo.Read(&Value, sizeof(Value));
-            if (Value != SaveID_1 && Value != SaveID_2)
-                hExtraInfo.SeekToBegin();
-
-            // Disk interface info
-            if (Value == SaveID_2)
-            {
-                hExtraInfo.Read(m_Reg.m_DiskInterface, sizeof(uint32_t) * 22);
+            return false;
+        }
+    }
+    if (Incremental)
+    {
+        MD5Digest BaseDigest;
+        State.Read(BaseDigest.digest, sizeof(BaseDigest.digest));
+        if (!m_SaveStateBase.Load(SaveFile, BaseDigest, SaveRDRAMSize))
+        {
+            g_Notify->DisplayMessage(3, stdstr_f("%s %s", GS(MSG_UNABLED_LOAD_STATE), (const char *)SaveFile).c_str());
+            return false;
+        }
+    }
+    Reset(false, true);
+    m_MMU_VM.UnProtectMemory(0x80000000, 0x80000000 + g_Settings->LoadDword(Game_RDRamSize) - 4);
+    m_MMU_VM.UnProtectMemory(0xA4000000, 0xA4001FFC);
+    g_Settings->SaveDword(Game_RDRamSize, SaveRDRAMSize);
+
+    State.Read(&NextVITimer, sizeof(NextVITimer));
+    State.Read(&m_Reg.m_PROGRAM_COUNTER, sizeof(m_Reg.m_PROGRAM_COUNTER));
+    State.Read(m_Reg.m_GPR, sizeof(int64_t) * 32);
+    State.Read(m_Reg.m_FPR, sizeof(int64_t) * 32);
+    State.Read(m_Reg.m_CP0, sizeof(uint32_t) * 32);
+    State.Read(m_Reg.m_FPCR, sizeof(uint32_t) * 32);
+    State.Read(&m_Reg.m_HI, sizeof(int64_t));
+    State.Read(&m_Reg.m_LO, sizeof(int64_t));
+    State.Read(m_Reg.m_RDRAM_Registers, sizeof(uint32_t) * 10);
+    State.Read(m_Reg.m_SigProcessor_Interface, sizeof(uint32_t) * 10);
+    State.Read(m_Reg.m_Display_ControlReg, sizeof(uint32_t) * 10);
+    State.Read(m_Reg.m_Mips_Interface, sizeof(uint32_t) * 4);
+    State.Read(m_Reg.m_Video_Interface, sizeof(uint32_t) * 14);
+    State.Read(m_Reg.m_Audio_Interface, sizeof(uint32_t) * 6);
+    State.Read(m_Reg.m_Peripheral_Interface, sizeof(uint32_t) * 13);
+    State.Read(m_Reg.m_RDRAM_Interface, sizeof(uint32_t) * 8);
+    State.Read(m_Reg.m_SerialInterface, sizeof(uint32_t) * 4);
+    State.Read((void *const)&m_TLB.TlbEntry(0), sizeof(CTLB::TLB_ENTRY) * 32);
+    State.Read(m_MMU_VM.PifRam(), 0x40);
+    if (Incremental)
+    {
+        uint32_t PageCount = 0, Page = 0;
+        m_SaveStateBase.Restore(m_MMU_VM.Rdram());
+        State.Read(&PageCount, sizeof(PageCount));
+        for (uint32_t i = 0; i < PageCount && State.Read(&Page, sizeof(Page)) == sizeof(Page) && (Page << 12) < SaveRDRAMSize; i++)
+        {
+            State.Read(m_MMU_VM.Rdram() + (Page << 12), 0x1000);
+        }
+    }
+    else
+    {
+        State.Read(m_MMU_VM.Rdram(), SaveRDRAMSize);
+    }
+    State.Read(m_MMU_VM.Dmem(), 0x1000);
+    State.Read(m_MMU_VM.Imem(), 0x1000);
 
-                // Recover disk seek address (if the save state is done while loading/saving data)
-                if (g_Disk)
-                    DiskBMReadWrite(false);
-            }
+    if (ExtraInfo.Length() != 0)
+    {
+        // Extra info version check
+        ExtraInfo.Read(&Value, sizeof(Value));
+        if (Value != SaveID_1 && Value != SaveID_2)
+            ExtraInfo.SeekToBegin();
 
-            // System timers info
-            m_SystemTimer.LoadData(hExtraInfo);
+        // Disk interface info
+        if (Value == SaveID_2)
+        {
+            ExtraInfo.Read(m_Reg.m_DiskInterface, sizeof(uint32_t) * 22);
 
-            hExtraInfo.Close();
+            // Recover disk seek address (if the save state is done while loading/saving data)
+            if (g_Disk)
+                DiskBMReadWrite(false);
         }
+
+        // System timers info
+        m_SystemTimer.LoadData(ExtraInfo);
     }
 
     // Fix losing audio in certain games with certain plugins
@@ -2211,24 +2302,66 @@ bool CN64System::LoadState(const char * FileName)
     m_CurrentSP = GPR[29].UW[0];
 #endif
     if (bFastSP() && m_Recomp) { m_Recomp->ResetMemoryStackPos(); }
+    return true;
+}
 
-    if (g_Settings->LoadDword(Game_CpuType) == CPU_SyncCores)
+void CN64System::Rewind(uint32_t Frames)
+{
+    m_RewindFrames = Frames;
+    ExternalEvent(SysEvent_RewindState);
+}
+
+void CN64System::CaptureRewind()
+{
+    // Same restrictions as a save state, a skipped capture is just taken on a later VI
+    if ((m_Reg.STATUS_REGISTER & STATUS_EXL) != 0 || g_Settings->LoadDword(Game_FuncLookupMode) == FuncFind_ChangeMemory)
     {
-        if (m_SyncCPU)
+        return;
+    }
+
+    PROFILE_TIMERS CPU_UsageAddr = Timer_None;
+    if (bShowCPUPer()) { CPU_UsageAddr = m_CPU_Usage.StartTimer(Timer_Rewind); }
+
+    HighResTimeStamp StartTime;
+    StartTime.SetToNow();
+    SaveStateData(m_Rewind.State(), m_Rewind.ExtraInfo(), nullptr);
+    m_Rewind.Capture(StartTime);
+
+    if ((m_Rewind.Snapshots() % 100) == 1)
+    {
+        WriteTrace(TraceN64System, TraceDebug, "Rewind: %d snapshots in %d KB, %d us per capture", m_Rewind.Snapshots(), m_Rewind.MemoryUsed() / 1024, m_Rewind.AverageCaptureTime());
+    }
+    if (bShowCPUPer()) { m_CPU_Usage.StartTimer(CPU_UsageAddr != Timer_None ? CPU_UsageAddr : Timer_R4300); }
+}
+
+bool CN64System::RewindState()
+{
+    if (m_RewindInterval == 0)
+    {
+        return false;
+    }
+
+    uint32_t Snapshots = (m_RewindFrames + m_RewindInterval - 1) / m_RewindInterval;
+    if (!m_Rewind.Rewind(Snapshots != 0 ? Snapshots : 1))
+    {
+        return false;
+    }
+    WriteTrace(TraceN64System, TraceDebug, "Rewind %d frames (%d snapshots left)", m_RewindFrames, m_Rewind.Snapshots());
+    if (!LoadStateData(m_Rewind.NewestState(), m_Rewind.NewestExtraInfo(), CPath()))
+    {
+        return false;
+    }
+    if (g_Settings->LoadDword(Game_CpuType) == CPU_SyncCores && m_SyncCPU)
+    {
+        for (int i = 0; i < (sizeof(m_LastSuccessSyncPC) / sizeof(m_LastSuccessSyncPC[0])); i++)
         {
-            for (int i = 0; i < (sizeof(m_LastSuccessSyncPC) / sizeof(m_LastSuccessSyncPC[0])); i++)
-            {
-                m_LastSuccessSyncPC[i] = 0;
-            }
-            m_SyncCPU->SetActiveSystem(true);
-            m_SyncCPU->LoadState(FileName);
-            SetActiveSystem(true);
-            SyncCPU(m_SyncCPU);
+            m_LastSuccessSyncPC[i] = 0;
         }
+        m_SyncCPU->SetActiveSystem(true);
+        m_SyncCPU->LoadStateData(m_Rewind.NewestState(), m_Rewind.NewestExtraInfo(), CPath());
+        SetActiveSystem(true);
+        SyncCPU(m_SyncCPU);
     }
-    std::string LoadMsg = g_Lang->GetString(MSG_LOADED_STATE);
-    g_Notify->DisplayMessage(3, stdstr_f("%s %s", LoadMsg.c_str(), stdstr(SaveFile.GetNameExtension()).c_str()).c_str());
-    WriteTrace(TraceN64System, TraceDebug, "Done");
     return true;
 }
 
@@ -2291,6 +2424,9 @@ void CN64System::RunRSP()
                 WriteTrace(TraceRSP, TraceDebug, "Do cycles - starting");
                 g_Plugins->RSP()->DoRspCycles(100);
                 WriteTrace(TraceRSP, TraceDebug, "Do cycles - done");
+
+                // The task may have written anywhere in RDRAM through the plugins without bumping a page generation
+                m_MMU_VM.UpdatePageGeneration(0, RdramSize());
             }
             __except_catch()
             {
@@ -2361,6 +2497,19 @@ void CN64System::RefreshScreen()
         }
     }
     g_SystemTimer->SetTimer(CSystemTimer::ViTimer, VI_INTR_TIME, true);
+    m_ViCount += 1;
+    m_ViCycles += VI_INTR_TIME;
+    if ((m_BenchmarkFrames != 0 && m_ViCount >= m_BenchmarkFrames) || (m_BenchmarkCycles != 0 && m_ViCycles >= m_BenchmarkCycles))
+    {
+        WriteTrace(TraceN64System, TraceInfo, "Benchmark done (frames: %d cycles: %lld)", m_ViCount, m_ViCycles);
+        m_BenchmarkFrames = 0;
+        m_BenchmarkCycles = 0;
+        ExternalEvent(SysEvent_CloseCPU);
+    }
+    if (m_RewindInterval != 0 && (m_ViCount % m_RewindInterval) == 0)
+    {
+        QueueEvent(SysEvent_RewindCapture);
+    }
     if (bFixedAudio())
     {
         g_Audio->SetViIntr(VI_INTR_TIME);
@@ -2383,6 +2532,7 @@ void CN64System::RefreshScreen()
     {
         WriteTrace(TraceGFXPlugin, TraceDebug, "UpdateScreen starting");
         g_Plugins->Gfx()->UpdateScreen();
+        m_MMU_VM.UpdatePageGeneration(0, RdramSize());
 		if (g_Debugger != nullptr && HaveDebugger())
 		{
 			g_Debugger->FrameDrawn();
@@ -2412,6 +2562,7 @@ void CN64System::RefreshScreen()
         m_FPS.UpdateViCounter();
         m_bCleanFrameBox = true;
     }
+    m_FPS.RecordFrameTime();
 
     if (m_bCleanFrameBox && !bDisplayFrameRate())
     {
@@ -2433,11 +2584,19 @@ void CN64System::RefreshScreen()
 
 void CN64System::TLB_Mapped(uint32_t VAddr, uint32_t Len, uint32_t PAddr, bool bReadOnly)
 {
+    if (m_Recomp)
+    {
+        m_Recomp->WaitForBackgroundCompile();
+    }
     m_MMU_VM.TLB_Mapped(VAddr, Len, PAddr, bReadOnly);
 }
 
 void CN64System::TLB_Unmaped(uint32_t VAddr, uint32_t Len)
 {
+    if (m_Recomp)
+    {
+        m_Recomp->WaitForBackgroundCompile();
+    }
     m_MMU_VM.TLB_Unmaped(VAddr, Len);
     if (m_Recomp && bSMM_TLB())
     {
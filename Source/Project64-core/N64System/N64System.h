@@ -11,6 +11,9 @@
 #include <Project64-core/N64System/Mips/SystemEvents.h>
 #include <Project64-core/N64System/Mips/SystemTiming.h>
 #include <Project64-core/N64System/Mips/Mempak.h>
+#include <Project64-core/N64System/SaveStateBase.h>
+#include <Project64-core/N64System/SaveStateWriter.h>
+#include <Project64-core/N64System/RewindBuffer.h>
 #include <Project64-core/Settings/DebugSettings.h>
 #include <Project64-core/Plugin.h>
 #include <Project64-core/Logging.h>
@@ -73,12 +76,20 @@ public:
     bool   SaveState();
     bool   LoadState(const char * FileName);
     bool   LoadState();
+    void   Rewind(uint32_t Frames);
 
     bool   DmaUsed() const { return m_DMAUsed; }
     void   SetDmaUsed(bool DMAUsed) { m_DMAUsed = DMAUsed; }
     uint32_t  GetButtons(int32_t Control) const { return m_Buttons[Control]; }
     CPlugins * GetPlugins() { return m_Plugins; }
 
+    // Frames and timer cycles emulated so far, used by headless benchmarking
+    uint32_t ViCount() const { return m_ViCount; }
+    uint64_t ViCycles() const { return m_ViCycles; }
+    const CProfiling & CPU_Usage() const { return m_CPU_Usage; }
+    const CRewindBuffer & RewindBuffer() const { return m_Rewind; }
+    const CRecompiler * Recompiler() const { return m_Recomp; }
+
     // Variable used to track that the SP is being handled and stays the same as the real SP in sync core
 #ifdef TEST_SP_TRACKING
     uint32_t m_CurrentSP;
@@ -97,6 +108,7 @@ private:
     friend class CControl_Plugin;
 
     // Recompiler has access to manipulate and call functions
+    friend class CSystemEvents;
     friend class CSystemTimer;
     friend class CRecompiler;
     friend class CMipsMemoryVM;
@@ -109,11 +121,20 @@ private:
     void   ExecuteCPU();
     void   RefreshScreen();
     void   DumpSyncErrors(CN64System * SecondCPU);
+    bool   SyncRegistersMatch(CN64System * const SecondCPU) const;
     void   StartEmulation2(bool NewThread);
     bool   SetActiveSystem(bool bActive = true);
     void   InitRegisters(bool bPostPif, CMipsMemoryVM & MMU);
     void   DisplayRSPListCount();
 
+    // Save state contents, shared by save state files and the rewind buffer
+    void   SaveStateData(CSaveStateBuffer & State, CSaveStateBuffer & ExtraInfo, const CSaveStateBase::PAGE_LIST * ChangedPages);
+    bool   LoadStateData(CSaveStateBuffer & State, CSaveStateBuffer & ExtraInfo, const CPath & SaveFile);
+    bool   SaveStateBaseDigest(const CPath & FileName, MD5Digest & Digest) const;
+    void   PruneSaveStateBases(const CPath & SaveFile);
+    void   CaptureRewind();
+    bool   RewindState();
+
     // CPU methods
     void   ExecuteRecompiler();
     void   ExecuteInterpret();
@@ -131,6 +152,11 @@ private:
     CPlugins      * m_SyncPlugins;
     CN64System    * m_SyncCPU;
     CMipsMemoryVM   m_MMU_VM;   // Memory of the N64
+    CSaveStateBase  m_SaveStateBase;
+    CSaveStateWriter m_SaveStateWriter;
+    CRewindBuffer   m_Rewind;
+    uint32_t        m_RewindInterval;   // VIs between rewind snapshots, 0 when rewind is off
+    volatile uint32_t m_RewindFrames;
     CTLB            m_TLB;
     CRegisters      m_Reg;
     CMempak         m_Mempak;
@@ -152,6 +178,10 @@ private:
     uint32_t        m_TLBLoadAddress;
     uint32_t        m_TLBStoreAddress;
     uint32_t        m_SyncCount;
+    uint32_t        m_ViCount;
+    uint64_t        m_ViCycles;
+    uint32_t        m_BenchmarkFrames;
+    uint32_t        m_BenchmarkCycles;
     bool            m_SyncSystem;
     CRandom         m_Random;
 
@@ -175,4 +205,5 @@ private:
     const uint32_t SaveID_0 = 0x23D8A6C8;   // Main save state info (*.pj)
     const uint32_t SaveID_1 = 0x56D2CD23;   // Extra data v1 (system timing) info (*.dat)
     const uint32_t SaveID_2 = 0x750A6BEB;   // Extra data v2 (timing + disk registers) (*.dat)
+    const uint32_t SaveID_3 = 0x4D1C37E5;   // Main save state info with RDRAM as pages changed from a base image (*.pj)
 };
@@ -44,6 +44,11 @@ enum SAVE_CHIP_TYPE
     SaveChip_Auto = -1, SaveChip_Eeprom_4K, SaveChip_Eeprom_16K, SaveChip_Sram, SaveChip_FlashRam
 };
 
+enum SAVE_STATE_COMPRESSION
+{
+    SaveStateCompression_Stored = 0, SaveStateCompression_Fast = 1, SaveStateCompression_Default = 2,
+};
+
 enum SAVE_DISK_TYPE
 {
     SaveDisk_ShadowFile = 0, SaveDisk_RAMFile = 1,
@@ -107,7 +112,8 @@ enum PROFILE_TIMERS
     Timer_UpdateScreen = 6,
     Timer_UpdateFPS = 7,
     Timer_Idel = 8,
-    Timer_Max = 9,
+    Timer_Rewind = 9,
+    Timer_Max = 10,
 };
 
 enum STEP_TYPE
@@ -11,11 +11,13 @@ m_CurrentDisplayCount(MAX_FRAMES),
 m_CurrentTimerType(Timer_None)
 {
     memset(m_Timers, 0, sizeof(m_Timers));
+    memset(m_TotalTimers, 0, sizeof(m_TotalTimers));
 }
 
 void CProfiling::RecordTime(PROFILE_TIMERS timer, uint32_t TimeTaken)
 {
     m_Timers[timer] += TimeTaken;
+    m_TotalTimers[timer] += TimeTaken;
 }
 
 uint64_t CProfiling::NonCPUTime(void)
@@ -47,6 +49,7 @@ PROFILE_TIMERS CProfiling::StopTimer()
     EndTime.SetToNow();
     uint64_t TimeTaken = EndTime.GetMicroSeconds() - m_StartTime.GetMicroSeconds();
     m_Timers[m_CurrentTimerType] += TimeTaken;
+    m_TotalTimers[m_CurrentTimerType] += TimeTaken;
 
     PROFILE_TIMERS CurrentTimerType = m_CurrentTimerType;
     m_CurrentTimerType = Timer_None;
@@ -19,6 +19,9 @@ public:
 
     void ResetTimers(void);
 
+    // Time recorded against a timer since the system started, not cleared by ResetTimers
+    uint64_t TotalTime(PROFILE_TIMERS Timer) const { return m_TotalTimers[Timer]; }
+
 private:
     CProfiling(const CProfiling&);
     CProfiling& operator=(const CProfiling&);
@@ -27,4 +30,5 @@ private:
     PROFILE_TIMERS m_CurrentTimerType;
     HighResTimeStamp m_StartTime;
     uint64_t m_Timers[Timer_Max];
+    uint64_t m_TotalTimers[Timer_Max];
 };
@@ -0,0 +1,243 @@
+#include "stdafx.h"
+#include <Project64-core/N64System/Recompiler/BlockProfiler.h>
+#include <Project64-core/N64System/Mips/Register.h>
+#include <Project64-core/N64System/SystemGlobals.h>
+#include <Common/path.h>
+#include <Common/File.h>
+#include <Common/Util.h>
+#include <algorithm>
+#include <stdlib.h>
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+CBlockProfiler::CBlockProfiler(CRegisters & Registers) :
+    m_Registers(Registers),
+    m_Active(false),
+    m_EntryCounts(nullptr),
+    m_SampleThread(stSampleThread),
+    m_SampleThreadEnd(false)
+{
+}
+
+CBlockProfiler::~CBlockProfiler()
+{
+    Stop();
+    delete[] m_EntryCounts;
+    m_EntryCounts = nullptr;
+}
+
+void CBlockProfiler::Start()
+{
+    WriteTrace(TraceRecompiler, TraceDebug, "Start");
+    if (m_EntryCounts == nullptr)
+    {
+        m_EntryCounts = new uint64_t[MaxEntryCounters];
+        memset(m_EntryCounts, 0, sizeof(uint64_t) * MaxEntryCounters);
+    }
+    LoadSymbols();
+
+#ifndef _WIN32
+    // Lets perf and other host profilers name samples that land in the code buffer
+    if (m_PerfMap.Open(stdstr_f("/tmp/perf-%d.map", getpid()).c_str(), CLog::Log_Append))
+    {
+        m_PerfMap.SetFlush(true);
+    }
+#endif
+
+    m_Active = true;
+    m_SampleThreadEnd = false;
+    m_SampleThread.Start(this);
+    WriteTrace(TraceRecompiler, TraceDebug, "Done");
+}
+
+void CBlockProfiler::Stop()
+{
+    if (m_SampleThread.isRunning())
+    {
+        m_SampleThreadEnd = true;
+        while (m_SampleThread.isRunning())
+        {
+            pjutil::Sleep(1);
+        }
+    }
+    m_PerfMap.Close();
+    m_Active = false;
+}
+
+void CBlockProfiler::Reset()
+{
+    CGuard Guard(m_CS);
+    if (m_EntryCounts != nullptr)
+    {
+        memset(m_EntryCounts, 0, sizeof(uint64_t) * m_CounterPC.size());
+    }
+    m_Samples.clear();
+}
+
+void CBlockProfiler::ResetEntryCounters()
+{
+    // The blocks holding the counters are gone, so the counters can be handed out again
+    CGuard Guard(m_CS);
+    if (m_EntryCounts != nullptr)
+    {
+        memset(m_EntryCounts, 0, sizeof(uint64_t) * m_CounterPC.size());
+    }
+    m_CounterPC.clear();
+}
+
+uint64_t * CBlockProfiler::NewEntryCounter(uint32_t EnterPC)
+{
+#if defined(__i386__) || defined(_M_IX86)
+    CGuard Guard(m_CS);
+    if (!m_Active || m_CounterPC.size() >= MaxEntryCounters)
+    {
+        return nullptr;
+    }
+    m_CounterPC.push_back(EnterPC);
+    return &m_EntryCounts[m_CounterPC.size() - 1];
+#else
+    // Only the x86 recompiler emits the entry counter
+    return nullptr;
+#endif
+}
+
+void CBlockProfiler::AddBlock(const CCompiledFunc * Func)
+{
+    if (!m_PerfMap.IsOpen())
+    {
+        return;
+    }
+    static const COUNTER_PCS NoBlocks;
+    uint32_t Start = (uint32_t)(size_t)Func->Function() & ~1;
+    m_PerfMap.LogF("%X %X %s\n", Start, (uint32_t)((size_t)Func->FunctionEnd() - Start), SymbolName(Func->EnterPC(), NoBlocks).c_str());
+}
+
+void CBlockProfiler::LoadSymbols()
+{
+    m_Symbols.clear();
+
+    // Same location the debugger saves its symbols to
+    CPath SymFile(g_Settings->LoadStringVal(Directory_NativeSave).c_str(), stdstr_f("%s.sym", g_Settings->LoadStringVal(Game_GameName).c_str()).c_str());
+    if (g_Settings->LoadBool(Setting_UniqueSaveDir))
+    {
+        SymFile.AppendDirectory(g_Settings->LoadStringVal(Game_UniqueSaveDir).c_str());
+    }
+#ifdef _WIN32
+    SymFile.NormalizePath(CPath(CPath::MODULE_DIRECTORY));
+#endif
+
+    CFile File;
+    if (!File.Open(SymFile, CFileBase::modeRead))
+    {
+        return;
+    }
+    std::string Contents(File.GetLength(), '\0');
+    if (Contents.empty() || File.Read(&Contents[0], (uint32_t)Contents.size()) != Contents.size())
+    {
+        return;
+    }
+
+    // Each line is "address,type,name[,description]", only code symbols name functions
+    strvector Lines = stdstr(Contents).Tokenize('\n');
+    for (size_t i = 0, n = Lines.size(); i < n; i++)
+    {
+        strvector Fields = Lines[i].Tokenize(',');
+        if (Fields.size() < 3 || Fields[1].Trim() != "code")
+        {
+            continue;
+        }
+        m_Symbols[(uint32_t)strtoul(Fields[0].c_str(), nullptr, 16)] = Fields[2].Trim("\t\r ");
+    }
+    WriteTrace(TraceRecompiler, TraceInfo, "Loaded %d code symbols from %s", (uint32_t)m_Symbols.size(), (const char *)SymFile);
+}
+
+std::string CBlockProfiler::SymbolName(uint32_t Address, const COUNTER_PCS & BlockStarts) const
+{
+    SYMBOLS::const_iterator itr = m_Symbols.upper_bound(Address);
+    if (itr != m_Symbols.begin())
+    {
+        return (--itr)->second;
+    }
+
+    // Without symbols, samples are attributed to the closest block entry at or before them
+    COUNTER_PCS::const_iterator Block = std::upper_bound(BlockStarts.begin(), BlockStarts.end(), Address);
+    if (Block != BlockStarts.begin())
+    {
+        Address = *(--Block);
+    }
+    return stdstr_f("N64_%08X", Address);
+}
+
+void CBlockProfiler::SampleThread()
+{
+    WriteTrace(TraceRecompiler, TraceDebug, "Start");
+    while (!m_SampleThreadEnd)
+    {
+        pjutil::Sleep(SampleInterval);
+        if (g_Settings->LoadBool(GameRunning_CPU_Paused))
+        {
+            continue;
+        }
+
+        // Registers are read without synchronization, an occasional torn sample does not matter
+        uint64_t Key = ((uint64_t)m_Registers.m_GPR[31].UW[0] << 32) | m_Registers.m_PROGRAM_COUNTER;
+        CGuard Guard(m_CS);
+        m_Samples[Key] += 1;
+    }
+    WriteTrace(TraceRecompiler, TraceDebug, "Done");
+}
+
+void CBlockProfiler::Dump()
+{
+    CGuard Guard(m_CS);
+
+    COUNTER_PCS BlockStarts(m_CounterPC);
+    std::sort(BlockStarts.begin(), BlockStarts.end());
+    BlockStarts.erase(std::unique(BlockStarts.begin(), BlockStarts.end()), BlockStarts.end());
+
+    // A block compiled more than once has a counter for each copy
+    std::map<uint32_t, uint64_t> BlockEntries;
+    for (size_t i = 0, n = m_CounterPC.size(); i < n; i++)
+    {
+        if (m_EntryCounts[i] != 0)
+        {
+            BlockEntries[m_CounterPC[i]] += m_EntryCounts[i];
+        }
+    }
+
+    typedef std::pair<uint64_t, uint32_t> BLOCK_COUNT;
+    std::vector<BLOCK_COUNT> HotBlocks;
+    for (std::map<uint32_t, uint64_t>::const_iterator itr = BlockEntries.begin(); itr != BlockEntries.end(); itr++)
+    {
+        HotBlocks.push_back(BLOCK_COUNT(itr->second, itr->first));
+    }
+    std::sort(HotBlocks.rbegin(), HotBlocks.rend());
+
+    CLog Log;
+    Log.Open(CPath(g_Settings->LoadStringVal(Directory_Log).c_str(), "BlockProfile.csv"));
+    Log.LogF("Address,Symbol,Entries\r\n");
+    for (size_t i = 0, n = HotBlocks.size(); i < n; i++)
+    {
+        Log.LogF("0x%08X,%s,%lld\r\n", HotBlocks[i].second, SymbolName(HotBlocks[i].second, BlockStarts).c_str(), HotBlocks[i].first);
+    }
+    Log.Close();
+
+    // Collapsed stacks ("caller;function count") as read by flamegraph.pl, the caller is taken from RA
+    std::map<std::string, uint32_t> Stacks;
+    for (SAMPLES::const_iterator itr = m_Samples.begin(); itr != m_Samples.end(); itr++)
+    {
+        uint32_t PC = (uint32_t)itr->first, ReturnAddress = (uint32_t)(itr->first >> 32);
+        std::string Function = SymbolName(PC, BlockStarts);
+        std::string Caller = ReturnAddress >= 8 ? SymbolName(ReturnAddress - 8, BlockStarts) : "";
+        Stacks[Caller.empty() || Caller == Function ? Function : Caller + ";" + Function] += itr->second;
+    }
+
+    Log.Open(CPath(g_Settings->LoadStringVal(Directory_Log).c_str(), "BlockProfile.folded"));
+    for (std::map<std::string, uint32_t>::const_iterator itr = Stacks.begin(); itr != Stacks.end(); itr++)
+    {
+        Log.LogF("%s %d\n", itr->first.c_str(), itr->second);
+    }
+    Log.Close();
+    WriteTrace(TraceRecompiler, TraceInfo, "Dumped %d blocks and %d samples", (uint32_t)HotBlocks.size(), (uint32_t)m_Samples.size());
+}
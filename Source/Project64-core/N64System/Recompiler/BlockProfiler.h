@@ -0,0 +1,60 @@
+#pragma once
+#include <Project64-core/N64System/Recompiler/FunctionInfo.h>
+#include <Common/Thread.h>
+#include <Common/CriticalSection.h>
+#include <Common/Log.h>
+#include <map>
+#include <string>
+#include <vector>
+
+class CRegisters;
+
+// Counts how often each compiled block is entered and samples the program counter
+// from a second thread, so hot MIPS code can be found without instrumenting the host.
+// Compiled blocks are also written to a perf map so host profilers can name them.
+class CBlockProfiler
+{
+public:
+    CBlockProfiler(CRegisters & Registers);
+    ~CBlockProfiler();
+
+    void Start();
+    void Stop();
+    void Reset();
+    void ResetEntryCounters();
+    void Dump();
+
+    bool Active() const { return m_Active; }
+
+    // Returns the counter the block entered at EnterPC increments, or nullptr when blocks are not counted
+    uint64_t * NewEntryCounter(uint32_t EnterPC);
+    void AddBlock(const CCompiledFunc * Func);
+
+private:
+    CBlockProfiler();
+    CBlockProfiler(const CBlockProfiler&);
+    CBlockProfiler& operator=(const CBlockProfiler&);
+
+    typedef std::map<uint32_t, std::string> SYMBOLS;
+    typedef std::map<uint64_t, uint32_t> SAMPLES;
+    typedef std::vector<uint32_t> COUNTER_PCS;
+
+    void LoadSymbols();
+    std::string SymbolName(uint32_t Address, const COUNTER_PCS & BlockStarts) const;
+    void SampleThread();
+    static uint32_t stSampleThread(void * lpThreadParameter) { ((CBlockProfiler *)lpThreadParameter)->SampleThread(); return 0; }
+
+    CRegisters   & m_Registers;
+    bool           m_Active;
+    uint64_t     * m_EntryCounts;
+    COUNTER_PCS    m_CounterPC;
+    SYMBOLS        m_Symbols;
+    SAMPLES        m_Samples;
+    CriticalSection m_CS;
+    CThread        m_SampleThread;
+    volatile bool  m_SampleThreadEnd;
+    CLog           m_PerfMap;
+
+    enum { MaxEntryCounters = 0x40000 };
+    enum { SampleInterval = 1 }; // Milliseconds between samples
+};
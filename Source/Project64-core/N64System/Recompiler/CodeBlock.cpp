@@ -16,12 +16,16 @@ bool DelaySlotEffectsCompare(uint32_t PC, uint32_t Reg1, uint32_t Reg2);
 extern "C" void __clear_cache_android(uint8_t* begin, uint8_t *end);
 #endif
 
-CCodeBlock::CCodeBlock(uint32_t VAddrEnter, uint8_t * CompiledLocation) :
+CCodeBlock::CCodeBlock(uint32_t VAddrEnter, uint8_t * CompiledLocation, uint64_t * EntryCounter, uint64_t * HitCounter) :
 m_VAddrEnter(VAddrEnter),
 m_VAddrFirst(VAddrEnter),
 m_VAddrLast(VAddrEnter),
 m_CompiledLocation(CompiledLocation),
+m_EntryCounter(EntryCounter),
+m_HitCounter(HitCounter),
 m_EnterSection(nullptr),
+m_PAddrFirst(0),
+m_CodeChanged(false),
 m_RecompilerOps(nullptr),
 m_Test(1)
 {
@@ -442,6 +446,7 @@ bool CCodeBlock::AnalyzeInstruction(uint32_t PC, uint32_t & TargetPC, uint32_t &
         g_Notify->BreakPoint(__FILE__, __LINE__);
         return false;
     }
+    RecordOpcode(PC, Command.Hex);
 
 #ifdef _DEBUG
     const char * Name = R4300iOpcodeName(Command.Hex, PC);
@@ -752,6 +757,17 @@ bool CCodeBlock::Compile()
     CPU_Message("====== Recompiled code ======");
 
     m_RecompilerOps->EnterCodeBlock();
+#if defined(__i386__) || defined(_M_IX86)
+    // Counters are only handed out when the x86 recompiler is used
+    if (m_EntryCounter != nullptr)
+    {
+        m_RecompilerOps->CompileEntryCounter(m_EntryCounter);
+    }
+    if (m_HitCounter != nullptr)
+    {
+        m_RecompilerOps->CompileEntryCounter(m_HitCounter);
+    }
+#endif
     if (g_System->bLinkBlocks())
     {
         while (m_EnterSection !=nullptr && m_EnterSection->GenerateNativeCode(NextTest()));
@@ -766,9 +782,43 @@ bool CCodeBlock::Compile()
     m_RecompilerOps->CompileExitCode();
     m_CompiledLocationEnd = *g_RecompPos;
 
+    if (m_CodeChanged)
+    {
+        return false;
+    }
+
+    // Hash the words the block was compiled from rather than memory as it is now, with background
+    // compilation the CPU thread keeps running and may have written the code since it was read
+    std::vector<uint32_t> Words;
+    Words.reserve(((VAddrLast() - VAddrFirst()) >> 2) + 1);
+    for (uint32_t PC = VAddrFirst(); PC <= VAddrLast(); PC += 4)
+    {
+        OPCODE_WORDS::const_iterator itr = m_OpcodeWords.find(PC);
+        uint32_t Word = 0;
+        if (itr != m_OpcodeWords.end())
+        {
+            Word = itr->second;
+        }
+        else
+        {
+            g_MMU->LW_VAddr(PC, Word);
+        }
+        Words.push_back(Word);
+    }
+    MD5((const unsigned char *)&Words[0], (unsigned int)(Words.size() * sizeof(Words[0]))).get_digest(m_Hash);
+
     uint32_t PAddr;
     g_TransVaddr->TranslateVaddr(VAddrFirst(), PAddr);
-    MD5(g_MMU->Rdram() + PAddr, (VAddrLast() - VAddrFirst()) + 4).get_digest(m_Hash);
+
+#if defined(__i386__) || defined(_M_IX86)
+    // Only the x86 recompiler updates page generations from its own stores, and only in the validate
+    // lookup modes. Without generations the block is always hashed when it is checked.
+    m_PAddrFirst = PAddr;
+    for (uint32_t Page = PAddr >> 12, LastPage = (PAddr + (VAddrLast() - VAddrFirst())) >> 12; g_System->bSMM_ValidFunc() && Page <= LastPage; Page++)
+    {
+        m_PageGenerations.push_back(g_MMU->PageGeneration(Page << 12));
+    }
+#endif
 
 #if defined(ANDROID) && (defined(__arm__) || defined(_M_ARM))
     __clear_cache_android((uint8_t *)((uint32_t)m_CompiledLocation & ~1), m_CompiledLocationEnd);
@@ -776,6 +826,23 @@ bool CCodeBlock::Compile()
     return true;
 }
 
+void CCodeBlock::AddLink(uint32_t TargetPC, uint32_t * JumpLoc)
+{
+    BLOCK_LINK Link;
+    Link.TargetPC = TargetPC;
+    Link.JumpLoc = JumpLoc;
+    m_Links.push_back(Link);
+}
+
+void CCodeBlock::RecordOpcode(uint32_t PC, uint32_t Hex)
+{
+    std::pair<OPCODE_WORDS::iterator, bool> res = m_OpcodeWords.insert(OPCODE_WORDS::value_type(PC, Hex));
+    if (!res.second && res.first->second != Hex)
+    {
+        m_CodeChanged = true;
+    }
+}
+
 uint32_t CCodeBlock::NextTest()
 {
     uint32_t next_test = m_Test;
@@ -6,7 +6,17 @@
 class CCodeBlock
 {
 public:
-    CCodeBlock(uint32_t VAddrEnter, uint8_t * CompiledLocation);
+    // A direct jump at the end of the block that can be patched to another block
+    typedef struct
+    {
+        uint32_t   TargetPC;
+        uint32_t * JumpLoc;
+    } BLOCK_LINK;
+
+    typedef std::vector<BLOCK_LINK> BLOCK_LINKS;
+    typedef std::vector<uint32_t> PAGE_GENERATIONS;
+
+    CCodeBlock(uint32_t VAddrEnter, uint8_t * CompiledLocation, uint64_t * EntryCounter, uint64_t * HitCounter);
     ~CCodeBlock();
 
     bool Compile();
@@ -16,12 +26,22 @@ public:
     uint32_t    VAddrLast()  const { return m_VAddrLast; }
     uint8_t *   CompiledLocation() const { return m_CompiledLocation; }
     uint8_t *   CompiledLocationEnd() const { return m_CompiledLocationEnd; }
+    uint64_t *  EntryCounter() const { return m_EntryCounter; }
+    uint64_t *  HitCounter() const { return m_HitCounter; }
     int32_t     NoOfSections() const { return (int32_t)m_Sections.size() - 1; }
     const CCodeSection & EnterSection() const { return *m_EnterSection; }
     const MD5Digest & Hash() const { return m_Hash; }
+    uint32_t    PAddrFirst() const { return m_PAddrFirst; }
+    const PAGE_GENERATIONS & PageGenerations() const { return m_PageGenerations; }
     CRecompilerOps *& RecompilerOps() { return m_RecompilerOps; }
     void SetVAddrFirst(uint32_t VAddr) { m_VAddrFirst = VAddr; }
     void SetVAddrLast(uint32_t VAddr) { m_VAddrLast = VAddr; }
+    const BLOCK_LINKS & Links() const { return m_Links; }
+    void AddLink(uint32_t TargetPC, uint32_t * JumpLoc);
+
+    // Keeps the first word read at each address while the block is analysed and emitted,
+    // a later read that differs means the code was written during the compile
+    void RecordOpcode(uint32_t PC, uint32_t Hex);
 
     CCodeSection * ExistingSection(uint32_t Addr) { return m_EnterSection->ExistingSection(Addr, NextTest()); }
     bool SectionAccessible(uint32_t m_SectionID) { return m_EnterSection->SectionAccessible(m_SectionID, NextTest()); }
@@ -50,16 +70,25 @@ private:
     uint32_t           m_VAddrLast;        // The address of the first opcode in the block
     uint8_t*           m_CompiledLocation; // What address is this compiled at?
     uint8_t*           m_CompiledLocationEnd; // What address is this compiled at?
+    uint64_t*          m_EntryCounter;     // Incremented on entry when the block profiler is active
+    uint64_t*          m_HitCounter;       // Incremented on entry when chained jumps can skip the lookup loop
 
     typedef std::map<uint32_t, CCodeSection *> SectionMap;
     typedef std::list<CCodeSection *>      SectionList;
 
+    typedef std::map<uint32_t, uint32_t> OPCODE_WORDS;
+
     SectionMap       m_SectionMap;
     SectionList      m_Sections;
     CCodeSection   * m_EnterSection;
     int32_t          m_Test;
     MD5Digest        m_Hash;
+    uint32_t         m_PAddrFirst;
+    PAGE_GENERATIONS m_PageGenerations; // Write generation of each page the block spans
+    OPCODE_WORDS     m_OpcodeWords;
+    bool             m_CodeChanged;
     uint64_t         m_MemContents[2];
     uint64_t *       m_MemLocation[2];
+    BLOCK_LINKS      m_Links;
     CRecompilerOps * m_RecompilerOps;
 };
@@ -509,6 +509,7 @@ bool CCodeSection::GenerateNativeCode(uint32_t Test)
         {
             m_BlockInfo->SetVAddrLast(m_RecompilerOps->GetCurrentPC());
         }
+        m_BlockInfo->RecordOpcode(m_RecompilerOps->GetCurrentPC(), Opcode.Hex);
 
         if (isDebugging() && HaveExecutionBP() && OpHasDelaySlot(Opcode) && g_Debugger->ExecutionBP(m_RecompilerOps->GetCurrentPC() + 4))
         {
@@ -0,0 +1,164 @@
+#include "stdafx.h"
+#include <Project64-core/N64System/Recompiler/CompiledFuncList.h>
+
+CCompiledFuncList::CCompiledFuncList() :
+    m_Table(nullptr),
+    m_Capacity(0),
+    m_Shift(32),
+    m_Used(0),
+    m_Deleted(0)
+{
+    Resize(InitialCapacity);
+}
+
+CCompiledFuncList::~CCompiledFuncList()
+{
+    delete[] m_Table;
+    m_Table = nullptr;
+}
+
+CCompiledFunc * CCompiledFuncList::Find(uint32_t EnterPC) const
+{
+    for (uint32_t i = Slot(EnterPC);; i = (i + 1) & (m_Capacity - 1))
+    {
+        const ENTRY & Entry = m_Table[i];
+        if (Entry.State == Entry_Empty)
+        {
+            return nullptr;
+        }
+        if (Entry.State == Entry_Used && Entry.EnterPC == EnterPC)
+        {
+            return Entry.Func;
+        }
+    }
+}
+
+void CCompiledFuncList::Add(CCompiledFunc * Func)
+{
+    // Keep at least half of the table empty so probe sequences stay short
+    if ((m_Used + m_Deleted + 1) * 2 > m_Capacity)
+    {
+        Resize(m_Used * 4 > m_Capacity ? m_Capacity * 2 : m_Capacity);
+    }
+
+    uint32_t EnterPC = Func->EnterPC();
+    ENTRY * Free = nullptr;
+    for (uint32_t i = Slot(EnterPC);; i = (i + 1) & (m_Capacity - 1))
+    {
+        ENTRY & Entry = m_Table[i];
+        if (Entry.State == Entry_Used && Entry.EnterPC == EnterPC)
+        {
+            Func->SetNext(Entry.Func->Next());
+            Entry.Func->SetNext(Func);
+            return;
+        }
+        if (Entry.State == Entry_Deleted && Free == nullptr)
+        {
+            Free = &Entry;
+        }
+        if (Entry.State == Entry_Empty)
+        {
+            if (Free == nullptr)
+            {
+                Free = &Entry;
+            }
+            break;
+        }
+    }
+
+    if (Free->State == Entry_Deleted)
+    {
+        m_Deleted -= 1;
+    }
+    Free->EnterPC = EnterPC;
+    Free->State = Entry_Used;
+    Free->Func = Func;
+    m_Used += 1;
+}
+
+void CCompiledFuncList::Remove(const CCompiledFunc * Func)
+{
+    for (uint32_t i = Slot(Func->EnterPC());; i = (i + 1) & (m_Capacity - 1))
+    {
+        ENTRY & Entry = m_Table[i];
+        if (Entry.State == Entry_Empty)
+        {
+            return;
+        }
+        if (Entry.State != Entry_Used || Entry.EnterPC != Func->EnterPC())
+        {
+            continue;
+        }
+        if (Entry.Func == Func)
+        {
+            SetChain(i, Func->Next());
+            return;
+        }
+        for (CCompiledFunc * Prev = Entry.Func; Prev->Next() != nullptr; Prev = Prev->Next())
+        {
+            if (Prev->Next() == Func)
+            {
+                Prev->SetNext(Func->Next());
+                return;
+            }
+        }
+        return;
+    }
+}
+
+void CCompiledFuncList::Clear()
+{
+    memset(m_Table, 0, sizeof(ENTRY) * m_Capacity);
+    m_Used = 0;
+    m_Deleted = 0;
+}
+
+void CCompiledFuncList::SetChain(uint32_t Index, CCompiledFunc * Func)
+{
+    ENTRY & Entry = m_Table[Index];
+    if (Entry.State != Entry_Used)
+    {
+        g_Notify->BreakPoint(__FILE__, __LINE__);
+        return;
+    }
+    Entry.Func = Func;
+    if (Func == nullptr)
+    {
+        Entry.State = Entry_Deleted;
+        m_Used -= 1;
+        m_Deleted += 1;
+    }
+}
+
+void CCompiledFuncList::Resize(uint32_t Capacity)
+{
+    ENTRY * OldTable = m_Table;
+    uint32_t OldCapacity = m_Capacity;
+
+    m_Table = new ENTRY[Capacity];
+    memset(m_Table, 0, sizeof(ENTRY) * Capacity);
+    m_Capacity = Capacity;
+    m_Shift = 32;
+    for (uint32_t Size = Capacity; Size > 1; Size >>= 1)
+    {
+        m_Shift -= 1;
+    }
+    m_Used = 0;
+    m_Deleted = 0;
+
+    for (uint32_t i = 0; i < OldCapacity; i++)
+    {
+        if (OldTable[i].State != Entry_Used)
+        {
+            continue;
+        }
+        uint32_t Index = Slot(OldTable[i].EnterPC);
+        while (m_Table[Index].State != Entry_Empty)
+        {
+            Index = (Index + 1) & (m_Capacity - 1);
+        }
+        m_Table[Index] = OldTable[i];
+        m_Used += 1;
+    }
+    delete[] OldTable;
+}
@@ -0,0 +1,54 @@
+#pragma once
+#include <Project64-core/N64System/Recompiler/FunctionInfo.h>
+
+// Compiled blocks indexed by entry address. Entries live in one flat open-addressed
+// table (linear probing) so a lookup touches a single cache line in the common case,
+// each entry holds the chain of blocks compiled for that address.
+class CCompiledFuncList
+{
+public:
+    CCompiledFuncList();
+    ~CCompiledFuncList();
+
+    CCompiledFunc * Find(uint32_t EnterPC) const;
+    void Add(CCompiledFunc * Func);
+    void Remove(const CCompiledFunc * Func);
+    void Clear();
+
+    uint32_t Size() const { return m_Used; }
+
+    // Slots are walked by index, replacing a chain with nullptr removes it.
+    // Removing entries while walking the table is safe, adding is not.
+    uint32_t Capacity() const { return m_Capacity; }
+    CCompiledFunc * Chain(uint32_t Index) const { return m_Table[Index].Func; }
+    void SetChain(uint32_t Index, CCompiledFunc * Func);
+
+private:
+    CCompiledFuncList(const CCompiledFuncList&);
+    CCompiledFuncList& operator=(const CCompiledFuncList&);
+
+    enum ENTRY_STATE
+    {
+        Entry_Empty,
+        Entry_Used,
+        Entry_Deleted,
+    };
+
+    typedef struct
+    {
+        uint32_t        EnterPC;
+        uint32_t        State;
+        CCompiledFunc * Func;
+    } ENTRY;
+
+    uint32_t Slot(uint32_t EnterPC) const { return ((EnterPC >> 2) * 0x9E3779B1) >> m_Shift; }
+    void Resize(uint32_t Capacity);
+
+    ENTRY  * m_Table;
+    uint32_t m_Capacity;
+    uint32_t m_Shift;
+    uint32_t m_Used;
+    uint32_t m_Deleted;
+
+    enum { InitialCapacity = 0x1000 };
+};
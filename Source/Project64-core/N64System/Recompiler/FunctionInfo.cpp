@@ -1,5 +1,9 @@
 #include "stdafx.h"
 #include <Project64-core/N64System/Recompiler/FunctionInfo.h>
+#include <Project64-core/N64System/Mips/MemoryVirtualMem.h>
+
+CriticalSection CCompiledFunc::m_ArenaCS;
+void * CCompiledFunc::m_ArenaFreeList = nullptr;
 
 CCompiledFunc::CCompiledFunc( const CCodeBlock & CodeBlock ) :
     m_EnterPC(CodeBlock.VAddrEnter()),
@@ -8,7 +12,12 @@ CCompiledFunc::CCompiledFunc( const CCodeBlock & CodeBlock ) :
     m_Hash(CodeBlock.Hash()),
     m_Function((Func)CodeBlock.CompiledLocation()),
     m_FunctionEnd(CodeBlock.CompiledLocationEnd()),
-    m_Next(nullptr)
+    m_Links(CodeBlock.Links()),
+    m_PAddrFirst(CodeBlock.PAddrFirst()),
+    m_PageGenerations(CodeBlock.PageGenerations()),
+    m_Next(nullptr),
+    m_HitCount(0),
+    m_HitCounter(CodeBlock.HitCounter())
 {
     m_MemContents[0] = CodeBlock.MemContents(0);
     m_MemContents[1] = CodeBlock.MemContents(1);
@@ -22,4 +31,58 @@ CCompiledFunc::CCompiledFunc( const CCodeBlock & CodeBlock ) :
         m_Function = (Func)(((uint32_t)m_Function) + 1);
     }
 #endif
-}
\ No newline at end of file
+}
+bool CCompiledFunc::PagesUnchanged(const CMipsMemoryVM & MMU) const
+{
+    if (m_PageGenerations.empty())
+    {
+        return false;
+    }
+    for (size_t i = 0, n = m_PageGenerations.size(); i < n; i++)
+    {
+        if (MMU.PageGeneration(m_PAddrFirst + (uint32_t)(i << 12)) != m_PageGenerations[i])
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+void CCompiledFunc::UpdatePageGenerations(const CMipsMemoryVM & MMU)
+{
+    for (size_t i = 0, n = m_PageGenerations.size(); i < n; i++)
+    {
+        m_PageGenerations[i] = MMU.PageGeneration(m_PAddrFirst + (uint32_t)(i << 12));
+    }
+}
+
+void * CCompiledFunc::operator new(size_t /*size*/)
+{
+    const size_t NodeSize = (sizeof(CCompiledFunc) + 7) & ~7;
+
+    CGuard Guard(m_ArenaCS);
+    if (m_ArenaFreeList == nullptr)
+    {
+        // Chunks are never returned, freed nodes go back on the free list
+        uint8_t * Chunk = new uint8_t[NodeSize * ArenaChunkNodes];
+        for (uint32_t i = 0; i < ArenaChunkNodes; i++)
+        {
+            *(void **)(Chunk + (i * NodeSize)) = m_ArenaFreeList;
+            m_ArenaFreeList = Chunk + (i * NodeSize);
+        }
+    }
+    void * Node = m_ArenaFreeList;
+    m_ArenaFreeList = *(void **)Node;
+    return Node;
+}
+
+void CCompiledFunc::operator delete(void * ptr)
+{
+    if (ptr == nullptr)
+    {
+        return;
+    }
+    CGuard Guard(m_ArenaCS);
+    *(void **)ptr = m_ArenaFreeList;
+    m_ArenaFreeList = ptr;
+}
@@ -1,11 +1,18 @@
 #pragma once
 #include <Project64-core/N64System/Recompiler/CodeBlock.h>
+#include <Common/CriticalSection.h>
+
+class CMipsMemoryVM;
 
 class CCompiledFunc
 {
 public:
     CCompiledFunc(const CCodeBlock & CodeBlock);
 
+    // Allocated from a shared arena so that many small blocks do not fragment the heap
+    static void * operator new(size_t size);
+    static void operator delete(void * ptr);
+
     typedef void (*Func)();
 
     const uint32_t EnterPC   () const { return m_EnterPC; }
@@ -14,10 +21,20 @@ public:
     const Func     Function  () const { return m_Function; }
     const uint8_t *FunctionEnd() const { return m_FunctionEnd; }
     const MD5Digest&    Hash () const { return m_Hash; }
+    const CCodeBlock::BLOCK_LINKS & Links() const { return m_Links; }
+
+    // True when no page holding the block's code has been written since it was compiled
+    bool PagesUnchanged(const CMipsMemoryVM & MMU) const;
+    void UpdatePageGenerations(const CMipsMemoryVM & MMU);
 
     CCompiledFunc*    Next () const { return m_Next; }
     void SetNext(CCompiledFunc* Next) { m_Next = Next; }
 
+    // Blocks that can be entered through a chained jump count their own entries
+    uint32_t HitCount() const { return m_HitCounter != nullptr ? (uint32_t)*m_HitCounter : m_HitCount; }
+    void IncHitCount() { m_HitCount += 1; }
+    void AgeHitCount() { m_HitCount >>= 1; if (m_HitCounter != nullptr) { *m_HitCounter >>= 1; } }
+
     uint64_t MemContents(int32_t i) { return m_MemContents[i]; }
     uint64_t* MemLocation(int32_t i) { return m_MemLocation[i]; }
 
@@ -33,9 +50,17 @@ private:
 
     MD5Digest m_Hash;
     Func m_Function;
+    CCodeBlock::BLOCK_LINKS m_Links;
+    uint32_t m_PAddrFirst;
+    CCodeBlock::PAGE_GENERATIONS m_PageGenerations;
 
     CCompiledFunc* m_Next;
+    uint32_t m_HitCount;
+    uint64_t * m_HitCounter;
     uint64_t m_MemContents[2], * m_MemLocation[2];
-};
 
-typedef std::map<uint32_t, CCompiledFunc *> CCompiledFuncList;
+    static CriticalSection m_ArenaCS;
+    static void * m_ArenaFreeList;
+
+    enum { ArenaChunkNodes = 0x400 };
+};
@@ -177,6 +177,7 @@ bool LoopAnalysis::CheckLoopRegisterUsage(CCodeSection * Section)
             g_Notify->BreakPoint(__FILE__, __LINE__);
             return false;
         }
+        m_BlockInfo->RecordOpcode(m_PC, m_Command.Hex);
         CPU_Message("  %08X: %s", m_PC, R4300iOpcodeName(m_Command.Hex, m_PC));
         switch (m_Command.op)
         {
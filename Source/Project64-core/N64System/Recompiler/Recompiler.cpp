@@ -5,12 +5,25 @@
 #include <Project64-core/N64System/N64System.h>
 #include <Project64-core/N64System/Interpreter/InterpreterCPU.h>
 #include <Project64-core/ExceptionHandler.h>
+#include <Common/Util.h>
 
 CRecompiler::CRecompiler(CMipsMemoryVM & MMU, CRegisters & Registers, bool & EndEmulation) :
+    m_BlockProfiler(Registers),
     m_MMU(MMU),
     m_Registers(Registers),
     m_EndEmulation(EndEmulation),
     m_MemoryStack(0),
+    m_BlockChaining(false),
+    m_BackgroundCompile(false),
+    m_CompileThread(stCompileThread),
+    m_CompileRequest(false),
+    m_CompileThreadEnd(false),
+    m_CompileBusy(false),
+    m_CompileFinished(false),
+    m_CompileStale(false),
+    m_CompilePC(0),
+    m_CompileHitCounter(nullptr),
+    m_CompiledFunc(nullptr),
     PROGRAM_COUNTER(Registers.m_PROGRAM_COUNTER)
 {
     CFunctionMap::AllocateMemory();
@@ -19,6 +32,7 @@ CRecompiler::CRecompiler(CMipsMemoryVM & MMU, CRegisters & Registers, bool & End
 
 CRecompiler::~CRecompiler()
 {
+    StopCompileThread();
     ResetRecompCode(false);
 }
 
@@ -36,6 +50,7 @@ void CRecompiler::Run()
         WriteTrace(TraceRecompiler, TraceError, "AllocateMemory failed");
         return;
     }
+    m_SegmentBlocks.resize(SegmentCount());
     if (!CFunctionMap::AllocateMemory())
     {
         WriteTrace(TraceRecompiler, TraceError, "AllocateMemory failed");
@@ -43,6 +58,21 @@ void CRecompiler::Run()
     }
     m_EndEmulation = false;
 
+    if (bBlockProfiler())
+    {
+        m_BlockProfiler.Start();
+    }
+
+    m_BlockChaining = g_Settings->LoadBool(Setting_BlockChaining) && g_SyncSystem == nullptr && !g_System->bSMM_ValidFunc() &&
+        (g_System->LookUpMode() == FuncFind_VirtualLookup || g_System->LookUpMode() == FuncFind_PhysicalLookup);
+    m_BackgroundCompile = g_Settings->LoadBool(Setting_BackgroundCompile) && g_SyncSystem == nullptr &&
+        (g_System->LookUpMode() == FuncFind_VirtualLookup || g_System->LookUpMode() == FuncFind_PhysicalLookup);
+    if (m_BackgroundCompile)
+    {
+        m_CompileThreadEnd = false;
+        m_CompileThread.Start(this);
+    }
+
 #ifdef legacycode
     *g_MemoryStack = (uint32_t)(RDRAM + (_GPR[29].W[0] & 0x1FFFFFFF));
 #endif
@@ -93,6 +123,8 @@ void CRecompiler::Run()
     {
         g_Notify->DisplayError(MSG_UNKNOWN_MEM_ACTION);
     }
+    StopCompileThread();
+    m_BlockProfiler.Stop();
 
     WriteTrace(TraceRecompiler, TraceDebug, "Done");
 }
@@ -122,10 +154,15 @@ void CRecompiler::RecompilerMain_VirtualTable()
             CCompiledFunc * info = table[TableEntry];
             if (info != nullptr)
             {
+                info->IncHitCount();
                 (info->Function())();
                 continue;
             }
         }
+        if (bBackgroundCompile() && !CompileInBackground())
+        {
+            continue;
+        }
         CCompiledFunc * info = CompileCode();
         if (info == nullptr || m_EndEmulation)
         {
@@ -149,6 +186,9 @@ void CRecompiler::RecompilerMain_VirtualTable()
         }
 
         table[TableEntry] = info;
+        SegmentBlocks(info).TableSlots.push_back(PC);
+        LinkBlock(PC, info);
+        info->IncHitCount();
         (info->Function())();
     }
 }
@@ -336,6 +376,10 @@ void CRecompiler::RecompilerMain_Lookup()
             CCompiledFunc * info = JumpTable()[PhysicalAddr >> 2];
             if (info == nullptr)
             {
+                if (bBackgroundCompile() && !CompileInBackground())
+                {
+                    continue;
+                }
                 info = CompileCode();
                 if (info == nullptr || m_EndEmulation)
                 {
@@ -345,8 +389,10 @@ void CRecompiler::RecompilerMain_Lookup()
                 {
                     m_MMU.ProtectMemory(PROGRAM_COUNTER & ~0xFFF, PROGRAM_COUNTER | 0xFFF);
                 }
-                JumpTable()[PhysicalAddr >> 2] = info;
+                SetJumpTableEntry(PhysicalAddr, info);
+                LinkBlock(PROGRAM_COUNTER, info);
             }
+            info->IncHitCount();
             (info->Function())();
         }
         else
@@ -540,6 +586,10 @@ void CRecompiler::RecompilerMain_Lookup_TLB()
 
             if (info == nullptr)
             {
+                if (bBackgroundCompile() && !CompileInBackground())
+                {
+                    continue;
+                }
                 info = CompileCode();
                 if (info == nullptr || m_EndEmulation)
                 {
@@ -549,8 +599,10 @@ void CRecompiler::RecompilerMain_Lookup_TLB()
                 {
                     m_MMU.ProtectMemory(PROGRAM_COUNTER & ~0xFFF, PROGRAM_COUNTER | 0xFFF);
                 }
-                JumpTable()[PhysicalAddr >> 2] = info;
+                SetJumpTableEntry(PhysicalAddr, info);
+                LinkBlock(PROGRAM_COUNTER, info);
             }
+            info->IncHitCount();
             (info->Function())();
         }
         else
@@ -582,6 +634,10 @@ void CRecompiler::RecompilerMain_Lookup_validate()
             CCompiledFunc * info = JumpTable()[PhysicalAddr >> 2];
             if (info == nullptr)
             {
+                if (bBackgroundCompile() && !CompileInBackground())
+                {
+                    continue;
+                }
                 info = CompileCode();
                 if (info == nullptr || m_EndEmulation)
                 {
@@ -591,18 +647,18 @@ void CRecompiler::RecompilerMain_Lookup_validate()
                 {
                     m_MMU.ProtectMemory(PROGRAM_COUNTER & ~0xFFF, PROGRAM_COUNTER | 0xFFF);
                 }
-                JumpTable()[PhysicalAddr >> 2] = info;
+                SetJumpTableEntry(PhysicalAddr, info);
             }
             else
             {
-                if (*(info->MemLocation(0)) != info->MemContents(0) ||
-                    *(info->MemLocation(1)) != info->MemContents(1))
+                if (!ValidCompiledCode(info))
                 {
                     ClearRecompCode_Virt((info->EnterPC() - 0x1000) & ~0xFFF, 0x3000, Remove_ValidateFunc);
                     info = nullptr;
                     continue;
                 }
             }
+            info->IncHitCount();
             (info->Function())();
         }
         else
@@ -650,6 +706,10 @@ void CRecompiler::RecompilerMain_Lookup_validate_TLB()
 
             if (info == nullptr)
             {
+                if (bBackgroundCompile() && !CompileInBackground())
+                {
+                    continue;
+                }
                 info = CompileCode();
                 if (info == nullptr || m_EndEmulation)
                 {
@@ -659,12 +719,11 @@ void CRecompiler::RecompilerMain_Lookup_validate_TLB()
                 {
                     m_MMU.ProtectMemory(PC & ~0xFFF, PC | 0xFFF);
                 }
-                JumpTable()[PhysicalAddr >> 2] = info;
+                SetJumpTableEntry(PhysicalAddr, info);
             }
             else
             {
-                if (*(info->MemLocation(0)) != info->MemContents(0) ||
-                    *(info->MemLocation(1)) != info->MemContents(1))
+                if (!ValidCompiledCode(info))
                 {
                     if (PhysicalAddr > 0x1000)
                     {
@@ -684,6 +743,7 @@ void CRecompiler::RecompilerMain_Lookup_validate_TLB()
                 }
             }
 
+            info->IncHitCount();
             if (bRecordExecutionTimes())
             {
                 uint64_t PreNonCPUTime = g_System->m_CPU_Usage.NonCPUTime();
@@ -748,12 +808,24 @@ void CRecompiler::Reset()
 void CRecompiler::ResetRecompCode(bool bAllocate)
 {
     WriteTrace(TraceRecompiler, TraceDebug, "Start");
+    WaitForBackgroundCompile();
+    if (m_CompileFinished)
+    {
+        delete m_CompiledFunc;
+        m_CompiledFunc = nullptr;
+        m_CompileFinished = false;
+        m_CompileBusy = false;
+    }
     CRecompMemory::Reset();
     CFunctionMap::Reset(bAllocate);
+    m_LinkTargets.clear();
+    m_BlockProfiler.ResetEntryCounters();
+    m_SegmentBlocks.clear();
+    m_SegmentBlocks.resize(SegmentCount());
 
-    for (CCompiledFuncList::iterator iter = m_Functions.begin(); iter != m_Functions.end(); iter++)
+    for (uint32_t i = 0, n = m_Functions.Capacity(); i < n; i++)
     {
-        CCompiledFunc * Func = iter->second;
+        CCompiledFunc * Func = m_Functions.Chain(i);
         while (Func != nullptr)
         {
             CCompiledFunc * CurrentFunc = Func;
@@ -762,10 +834,363 @@ void CRecompiler::ResetRecompCode(bool bAllocate)
             delete CurrentFunc;
         }
     }
-    m_Functions.clear();
+    m_Functions.Clear();
+    WriteTrace(TraceRecompiler, TraceDebug, "Done");
+}
+
+bool CRecompiler::CompileInBackground()
+{
+    PublishCompiledCode();
+    if (FindCompiledCode(PROGRAM_COUNTER) != nullptr)
+    {
+        return true;
+    }
+
+    uint32_t pAddr;
+    if (!m_CompileBusy && m_MMU.TranslateVaddr(PROGRAM_COUNTER, pAddr))
+    {
+        CheckRecompMem();
+        m_CompilePC = PROGRAM_COUNTER;
+        m_CompileHitCounter = NewHitCounter();
+        m_CompileStale = false;
+        m_CompileBusy = true;
+        m_CompileRequest.Trigger();
+    }
+    InterpretBlock();
+    return false;
+}
+
+void CRecompiler::InterpretBlock()
+{
+    // Run until the block leaves through a jump, exception or interrupt
+    while (!m_EndEmulation)
+    {
+        uint32_t PrevPC = PROGRAM_COUNTER;
+        CInterpreterCPU::ExecuteOps(g_System->CountPerOp());
+        if (R4300iOp::m_NextInstruction == NORMAL && PROGRAM_COUNTER != PrevPC + 4)
+        {
+            break;
+        }
+    }
+}
+
+void CRecompiler::PublishCompiledCode()
+{
+    if (!m_CompileFinished)
+    {
+        return;
+    }
+
+    CCompiledFunc * Func;
+    {
+        CGuard Guard(m_CompileCS);
+        Func = m_CompiledFunc;
+        m_CompiledFunc = nullptr;
+        m_CompileFinished = false;
+        m_CompileBusy = false;
+    }
+    uint64_t * HitCounter = m_CompileHitCounter;
+    m_CompileHitCounter = nullptr;
+    if (Func == nullptr)
+    {
+        ReleaseHitCounter(HitCounter);
+        return;
+    }
+    // Memory may have changed while the block was being compiled. Stores from the interpreter do not
+    // always bump a page generation, so compare the words the block was compiled from with memory now
+    if (m_CompileStale || !CodeMatchesHash(Func))
+    {
+        WriteTrace(TraceRecompiler, TraceInfo, "Dropping background compiled block %X", Func->EnterPC());
+        delete Func;
+        ReleaseHitCounter(HitCounter);
+        return;
+    }
+    WriteTrace(TraceRecompiler, TraceDebug, "Publishing background compiled block %X", Func->EnterPC());
+    AddCompiledFunc(Func);
+}
+
+void CRecompiler::WaitForBackgroundCompile()
+{
+    while (m_CompileBusy && !m_CompileFinished)
+    {
+        pjutil::Sleep(0);
+    }
+}
+
+void CRecompiler::CompileThread()
+{
+    WriteTrace(TraceRecompiler, TraceDebug, "Start");
+    for (;;)
+    {
+        m_CompileRequest.IsTriggered(SyncEvent::INFINITE_TIMEOUT);
+        if (m_CompileThreadEnd)
+        {
+            break;
+        }
+
+        WriteTrace(TraceRecompiler, TraceDebug, "Compile Block-Start: Program Counter: %X", m_CompilePC);
+        CCompiledFunc * Func = nullptr;
+        CCodeBlock CodeBlock(m_CompilePC, *g_RecompPos, m_BlockProfiler.NewEntryCounter(m_CompilePC), m_CompileHitCounter);
+        if (CodeBlock.Compile())
+        {
+            Func = new CCompiledFunc(CodeBlock);
+        }
+
+        CGuard Guard(m_CompileCS);
+        m_CompiledFunc = Func;
+        m_CompileFinished = true;
+    }
     WriteTrace(TraceRecompiler, TraceDebug, "Done");
 }
 
+void CRecompiler::StopCompileThread()
+{
+    if (!m_CompileThread.isRunning())
+    {
+        return;
+    }
+    WaitForBackgroundCompile();
+    m_CompileThreadEnd = true;
+    m_CompileRequest.Trigger();
+    while (m_CompileThread.isRunning())
+    {
+        pjutil::Sleep(1);
+    }
+}
+
+void CRecompiler::RemoveColdSegment()
+{
+    WriteTrace(TraceRecompiler, TraceDebug, "Start");
+
+    // Pick the segment with the least hits since the last eviction, never the one being filled
+    std::vector<uint64_t> SegmentHits(SegmentCount(), 0);
+    for (uint32_t i = 0, n = SegmentCount(); i < n; i++)
+    {
+        const SEGMENT_FUNCS & Funcs = m_SegmentBlocks[i].Funcs;
+        for (size_t Func = 0, NumFuncs = Funcs.size(); Func < NumFuncs; Func++)
+        {
+            SegmentHits[i] += Funcs[Func]->HitCount();
+        }
+    }
+
+    uint32_t ColdSegment = CurrentSegment() == 0 ? 1 : 0;
+    for (uint32_t i = 0, n = SegmentCount(); i < n; i++)
+    {
+        if (i != CurrentSegment() && SegmentHits[i] < SegmentHits[ColdSegment])
+        {
+            ColdSegment = i;
+        }
+    }
+    WriteTrace(TraceRecompiler, TraceInfo, "Evicting code segment %d (hits: %lld)", ColdSegment, SegmentHits[ColdSegment]);
+    RemoveSegmentBlocks(ColdSegment);
+
+    for (uint32_t i = 0, n = SegmentCount(); i < n; i++)
+    {
+        const SEGMENT_FUNCS & Funcs = m_SegmentBlocks[i].Funcs;
+        for (size_t Func = 0, NumFuncs = Funcs.size(); Func < NumFuncs; Func++)
+        {
+            Funcs[Func]->AgeHitCount();
+        }
+    }
+    UseSegment(ColdSegment);
+    WriteTrace(TraceRecompiler, TraceDebug, "Done");
+}
+
+void CRecompiler::RemoveSegmentBlocks(uint32_t Segment)
+{
+    const uint8_t * Start = SegmentStart(Segment), * End = SegmentEnd(Segment);
+    SEGMENT_BLOCKS & Blocks = m_SegmentBlocks[Segment];
+
+    // A slot may have been cleared or reused by a block in another segment since it was recorded
+    PCCompiledFunc * JumpTable = CFunctionMap::JumpTable();
+    for (size_t i = 0, n = Blocks.JumpSlots.size(); JumpTable != nullptr && i < n; i++)
+    {
+        PCCompiledFunc & Entry = JumpTable[Blocks.JumpSlots[i]];
+        if (Entry != nullptr && (const uint8_t *)Entry->Function() >= Start && (const uint8_t *)Entry->Function() < End)
+        {
+            Entry = nullptr;
+        }
+    }
+
+    PCCompiledFunc_TABLE * FunctionTable = CFunctionMap::FunctionTable();
+    for (size_t i = 0, n = Blocks.TableSlots.size(); FunctionTable != nullptr && i < n; i++)
+    {
+        uint32_t Address = Blocks.TableSlots[i];
+        PCCompiledFunc_TABLE table = FunctionTable[Address >> 0xC];
+        if (table == nullptr)
+        {
+            continue;
+        }
+        PCCompiledFunc & Entry = table[(Address & 0xFFF) >> 2];
+        if (Entry != nullptr && (const uint8_t *)Entry->Function() >= Start && (const uint8_t *)Entry->Function() < End)
+        {
+            Entry = nullptr;
+        }
+    }
+
+    for (size_t i = 0, n = Blocks.Funcs.size(); i < n; i++)
+    {
+        CCompiledFunc * Func = Blocks.Funcs[i];
+        RemoveBlockLinks(Func);
+        m_BlockProfile.erase(Func->Function());
+        m_Functions.Remove(Func);
+        delete Func;
+    }
+    Blocks.Funcs.clear();
+    Blocks.JumpSlots.clear();
+    Blocks.TableSlots.clear();
+    Blocks.HitCounters.clear();
+}
+
+uint64_t * CRecompiler::NewHitCounter()
+{
+#if defined(__i386__) || defined(_M_IX86)
+    // Chained jumps never return to the lookup loop, so linked blocks count their own entries
+    // for the cold segment choice. The counter lives with the segment the block is compiled into.
+    if (m_BlockChaining)
+    {
+        SEGMENT_HIT_COUNTERS & HitCounters = m_SegmentBlocks[CurrentSegment()].HitCounters;
+        HitCounters.push_back(0);
+        return &HitCounters.back();
+    }
+#endif
+    return nullptr;
+}
+
+void CRecompiler::ReleaseHitCounter(uint64_t * HitCounter)
+{
+    // Nothing is allocated between handing out a counter and its compile finishing, so a
+    // counter left unused by a failed or dropped compile is still the newest in its segment
+    if (HitCounter == nullptr)
+    {
+        return;
+    }
+    SEGMENT_HIT_COUNTERS & HitCounters = m_SegmentBlocks[CurrentSegment()].HitCounters;
+    if (!HitCounters.empty() && &HitCounters.back() == HitCounter)
+    {
+        HitCounters.pop_back();
+    }
+}
+
+void CRecompiler::SetJumpTableEntry(uint32_t PhysicalAddr, CCompiledFunc * Func)
+{
+    JumpTable()[PhysicalAddr >> 2] = Func;
+    SegmentBlocks(Func).JumpSlots.push_back(PhysicalAddr >> 2);
+}
+
+void CRecompiler::LinkBlock(uint32_t EnterPC, CCompiledFunc * Func)
+{
+    if (!m_BlockChaining || Func->EnterPC() != EnterPC || EnterPC < 0x80000000 || EnterPC >= 0xC0000000)
+    {
+        return;
+    }
+
+    LINK_TARGETS::iterator itr = m_LinkTargets.find(EnterPC);
+    if (itr == m_LinkTargets.end())
+    {
+        LINK_TARGET Target;
+        Target.Func = nullptr;
+        itr = m_LinkTargets.insert(LINK_TARGETS::value_type(EnterPC, Target)).first;
+    }
+    if (itr->second.Func == Func)
+    {
+        return;
+    }
+    itr->second.Func = Func;
+
+    LINK_LOCATIONS & JumpLocs = itr->second.JumpLocs;
+    for (size_t i = 0, n = JumpLocs.size(); i < n; i++)
+    {
+        *JumpLocs[i] = (uint32_t)((const uint8_t *)Func->Function() - ((const uint8_t *)JumpLocs[i] + 4));
+    }
+}
+
+void CRecompiler::AddBlockLinks(const CCompiledFunc * Func)
+{
+    const CCodeBlock::BLOCK_LINKS & Links = Func->Links();
+    for (size_t i = 0, n = Links.size(); i < n; i++)
+    {
+        LINK_TARGETS::iterator itr = m_LinkTargets.find(Links[i].TargetPC);
+        if (itr == m_LinkTargets.end())
+        {
+            LINK_TARGET Target;
+            Target.Func = nullptr;
+            itr = m_LinkTargets.insert(LINK_TARGETS::value_type(Links[i].TargetPC, Target)).first;
+        }
+        itr->second.JumpLocs.push_back(Links[i].JumpLoc);
+        if (itr->second.Func != nullptr)
+        {
+            *Links[i].JumpLoc = (uint32_t)((const uint8_t *)itr->second.Func->Function() - ((const uint8_t *)Links[i].JumpLoc + 4));
+        }
+    }
+}
+
+void CRecompiler::UnlinkBlocks(uint32_t Address, uint32_t Length)
+{
+    // Unlinked jumps have a displacement of 0 and fall through to the block's ret
+    LINK_TARGETS::iterator itr = m_LinkTargets.lower_bound(Address);
+    while (itr != m_LinkTargets.end() && itr->first - Address < Length)
+    {
+        LINK_LOCATIONS & JumpLocs = itr->second.JumpLocs;
+        for (size_t i = 0, n = JumpLocs.size(); i < n; i++)
+        {
+            *JumpLocs[i] = 0;
+        }
+        if (JumpLocs.empty())
+        {
+            itr = m_LinkTargets.erase(itr);
+            continue;
+        }
+        itr->second.Func = nullptr;
+        itr++;
+    }
+}
+
+void CRecompiler::RemoveBlockLinks(const CCompiledFunc * Func)
+{
+    // Jumps out of the block go away with its code
+    const CCodeBlock::BLOCK_LINKS & Links = Func->Links();
+    for (size_t i = 0, n = Links.size(); i < n; i++)
+    {
+        LINK_TARGETS::iterator itr = m_LinkTargets.find(Links[i].TargetPC);
+        if (itr == m_LinkTargets.end())
+        {
+            continue;
+        }
+        LINK_LOCATIONS & JumpLocs = itr->second.JumpLocs;
+        for (size_t Loc = 0; Loc < JumpLocs.size(); Loc++)
+        {
+            if (JumpLocs[Loc] == Links[i].JumpLoc)
+            {
+                JumpLocs[Loc] = JumpLocs.back();
+                JumpLocs.pop_back();
+                break;
+            }
+        }
+        if (itr->second.Func == nullptr && JumpLocs.empty())
+        {
+            m_LinkTargets.erase(itr);
+        }
+    }
+
+    // Jumps into the block fall back to the lookup loop
+    LINK_TARGETS::iterator itr = m_LinkTargets.find(Func->EnterPC());
+    if (itr == m_LinkTargets.end() || itr->second.Func != Func)
+    {
+        return;
+    }
+    LINK_LOCATIONS & JumpLocs = itr->second.JumpLocs;
+    for (size_t i = 0, n = JumpLocs.size(); i < n; i++)
+    {
+        *JumpLocs[i] = 0;
+    }
+    itr->second.Func = nullptr;
+    if (JumpLocs.empty())
+    {
+        m_LinkTargets.erase(itr);
+    }
+}
+
 void CRecompiler::RecompilerMain_ChangeMemory()
 {
     g_Notify->BreakPoint(__FILE__, __LINE__);
@@ -946,34 +1371,89 @@ CCompiledFunc * CRecompiler::CompileCode()
         return nullptr;
     }
 
-    CCompiledFuncList::iterator iter = m_Functions.find(PROGRAM_COUNTER);
-    if (iter != m_Functions.end())
+    CCompiledFunc * ExistingFunc = FindCompiledCode(PROGRAM_COUNTER);
+    if (ExistingFunc != nullptr)
     {
-        WriteTrace(TraceRecompiler, TraceInfo, "Existing functions for address (Program Counter: %X pAddr: %X)", PROGRAM_COUNTER, pAddr);
-        for (CCompiledFunc * Func = iter->second; Func != nullptr; Func = Func->Next())
+        WriteTrace(TraceRecompiler, TraceInfo, "Using existing compiled code (Program Counter: %X pAddr: %X)", PROGRAM_COUNTER, pAddr);
+        return ExistingFunc;
+    }
+
+    // The compile thread owns the code buffer while it is busy
+    WaitForBackgroundCompile();
+    PublishCompiledCode();
+
+    CCompiledFunc * Func = CompileBlock(PROGRAM_COUNTER);
+    WriteTrace(TraceRecompiler, TraceVerbose, "Done");
+    return Func;
+}
+
+CCompiledFunc * CRecompiler::FindCompiledCode(uint32_t EnterPC)
+{
+    // Several versions of a block can share an entry, so only the hash tells them apart
+    for (CCompiledFunc * Func = m_Functions.Find(EnterPC); Func != nullptr; Func = Func->Next())
+    {
+        if (Func->PagesUnchanged(m_MMU) || CodeMatchesHash(Func))
         {
-            uint32_t PAddr;
-            if (m_MMU.TranslateVaddr(Func->MinPC(), PAddr))
-            {
-                MD5Digest Hash;
-                MD5(m_MMU.Rdram() + PAddr, (Func->MaxPC() - Func->MinPC()) + 4).get_digest(Hash);
-                if (memcmp(Hash.digest, Func->Hash().digest, sizeof(Hash.digest)) == 0)
-                {
-                    WriteTrace(TraceRecompiler, TraceInfo, "Using existing compiled code (Program Counter: %X pAddr: %X)", PROGRAM_COUNTER, pAddr);
-                    return Func;
-                }
-            }
+            return Func;
         }
     }
+    return nullptr;
+}
 
+bool CRecompiler::ValidCompiledCode(CCompiledFunc * Func)
+{
+    if (Func->PagesUnchanged(m_MMU))
+    {
+        return true;
+    }
+    // Plugin calls bump every page, so a changed generation usually means nothing was written
+    // to this block. Fall back to the entry words check the validate loops have always done.
+    if (*(Func->MemLocation(0)) != Func->MemContents(0) ||
+        *(Func->MemLocation(1)) != Func->MemContents(1))
+    {
+        return false;
+    }
+    Func->UpdatePageGenerations(m_MMU);
+    return true;
+}
+
+bool CRecompiler::CodeMatchesHash(CCompiledFunc * Func)
+{
+    uint32_t PAddr;
+    if (!m_MMU.TranslateVaddr(Func->MinPC(), PAddr))
+    {
+        return false;
+    }
+    MD5Digest Hash;
+    MD5(m_MMU.Rdram() + PAddr, (Func->MaxPC() - Func->MinPC()) + 4).get_digest(Hash);
+    if (memcmp(Hash.digest, Func->Hash().digest, sizeof(Hash.digest)) != 0)
+    {
+        return false;
+    }
+    Func->UpdatePageGenerations(m_MMU);
+    return true;
+}
+
+void CRecompiler::AddCompiledFunc(CCompiledFunc * Func)
+{
+    m_Functions.Add(Func);
+    SegmentBlocks(Func).Funcs.push_back(Func);
+    m_BlockProfiler.AddBlock(Func);
+    AddBlockLinks(Func);
+}
+
+CCompiledFunc * CRecompiler::CompileBlock(uint32_t EnterPC)
+{
     CheckRecompMem();
 
     //uint32_t StartTime = timeGetTime();
-    WriteTrace(TraceRecompiler, TraceDebug, "Compile Block-Start: Program Counter: %X pAddr: %X", PROGRAM_COUNTER, pAddr);
+    WriteTrace(TraceRecompiler, TraceDebug, "Compile Block-Start: Program Counter: %X", EnterPC);
 
-    CCodeBlock CodeBlock(PROGRAM_COUNTER, *g_RecompPos);
+    uint64_t * HitCounter = NewHitCounter();
+    CCodeBlock CodeBlock(EnterPC, *g_RecompPos, m_BlockProfiler.NewEntryCounter(EnterPC), HitCounter);
     if (!CodeBlock.Compile())
     {
+        ReleaseHitCounter(HitCounter);
         return nullptr;
     }
 
@@ -983,12 +1463,7 @@ CCompiledFunc * CRecompiler::CompileCode()
     }
 
     CCompiledFunc * Func = new CCompiledFunc(CodeBlock);
-    std::pair<CCompiledFuncList::iterator, bool> ret = m_Functions.insert(CCompiledFuncList::value_type(Func->EnterPC(), Func));
-    if (ret.second == false)
-    {
-        Func->SetNext(ret.first->second->Next());
-        ret.first->second->SetNext(Func);
-    }
+    AddCompiledFunc(Func);
 
     if (g_ModuleLogLevel[TraceRecompiler] >= TraceDebug)
     {
@@ -1014,12 +1489,16 @@ CCompiledFunc * CRecompiler::CompileCode()
             WriteTrace(TraceRecompiler, TraceDebug, "%s", dumpline.c_str());
         }
     }
-    WriteTrace(TraceRecompiler, TraceVerbose, "Done");
     return Func;
 }
 
 void CRecompiler::ClearRecompCode_Phys(uint32_t Address, int length, REMOVE_REASON Reason)
 {
+    if (m_CompileBusy)
+    {
+        m_CompileStale = true;
+    }
+    m_MMU.UpdatePageGeneration(Address, length);
     if (g_System->LookUpMode() == FuncFind_VirtualLookup)
     {
         ClearRecompCode_Virt(Address + 0x80000000, length, Reason);
@@ -1047,6 +1526,8 @@ void CRecompiler::ClearRecompCode_Phys(uint32_t Address, int length, REMOVE_REAS
             }
             WriteTrace(TraceRecompiler, TraceInfo, "Resetting jump table, Addr: %X  len: %d", Address, ClearLen);
             memset((uint8_t *)JumpTable() + Address, 0, ClearLen);
+            UnlinkBlocks(Address + 0x80000000, ClearLen);
+            UnlinkBlocks(Address + 0xA0000000, ClearLen);
             if (g_System->bSMM_Protect())
             {
                 m_MMU.UnProtectMemory(Address + 0x80000000, Address + 0x80000004);
@@ -1061,6 +1542,10 @@ void CRecompiler::ClearRecompCode_Phys(uint32_t Address, int length, REMOVE_REAS
 
 void CRecompiler::ClearRecompCode_Virt(uint32_t Address, int length, REMOVE_REASON Reason)
 {
+    if (m_CompileBusy)
+    {
+        m_CompileStale = true;
+    }
     uint32_t AddressIndex, WriteStart;
     int DataInBlock, DataToWrite, DataLeft;
 
@@ -1076,6 +1561,14 @@ void CRecompiler::ClearRecompCode_Virt(uint32_t Address, int length, REMOVE_REAS
         DataLeft = length - DataToWrite;
 
         {
+            uint32_t pAddr = 0;
+            if (m_MMU.TranslateVaddr(Address, pAddr))
+            {
+                m_MMU.UpdatePageGeneration(pAddr, length);
+            }
+        }
+        {
+            UnlinkBlocks(Address & ~0xFFF, 0x1000);
             PCCompiledFunc_TABLE & table = FunctionTable()[AddressIndex];
             if (table)
             {
@@ -1136,9 +1629,15 @@ void CRecompiler::DumpFunctionTimes()
     {
         Log.LogF("%X,0x%X,%d\r\n", (uint32_t)itr->first, itr->second.Address, (uint32_t)itr->second.TimeTaken);
     }
+
+    if (m_BlockProfiler.Active())
+    {
+        m_BlockProfiler.Dump();
+    }
 }
 
 void CRecompiler::ResetFunctionTimes()
 {
     m_BlockProfile.clear();
+    m_BlockProfiler.Reset();
 }
\ No newline at end of file
@@ -3,10 +3,17 @@
 #include <Project64-core/N64System/Mips/Register.h>
 #include <Project64-core/N64System/Mips/MemoryVirtualMem.h>
 #include <Project64-core/N64System/Recompiler/FunctionMap.h>
+#include <Project64-core/N64System/Recompiler/CompiledFuncList.h>
 #include <Project64-core/N64System/Recompiler/RecompilerMemory.h>
+#include <Project64-core/N64System/Recompiler/BlockProfiler.h>
 #include <Project64-core/N64System/Profiling.h>
 #include <Project64-core/Settings/RecompilerSettings.h>
 #include <Project64-core/Settings/DebugSettings.h>
+#include <Common/Thread.h>
+#include <Common/SyncEvent.h>
+#include <Common/CriticalSection.h>
+#include <atomic>
+#include <deque>
 
 class CRecompiler :
     protected CDebugSettings,
@@ -39,16 +46,22 @@ public:
     void Run();
     void Reset();
     void ResetRecompCode(bool bAllocate);
+    void RemoveColdSegment();
 
     // Self-modifying code methods
     void ClearRecompCode_Virt(uint32_t VirtualAddress, int32_t length, REMOVE_REASON Reason);
     void ClearRecompCode_Phys(uint32_t PhysicalAddress, int32_t length, REMOVE_REASON Reason);
 
+    // The compile thread reads the TLB maps and the code buffer, anything changing them waits for it first
+    void WaitForBackgroundCompile();
+
     void ResetMemoryStackPos();
     void ResetFunctionTimes();
     void DumpFunctionTimes();
 
     uint32_t& MemoryStackPos() { return m_MemoryStack; }
+    const CCompiledFuncList & Functions() const { return m_Functions; }
+    bool bBlockChaining() const { return m_BlockChaining; }
 
 private:
     CRecompiler();
@@ -56,6 +69,54 @@ private:
     CRecompiler& operator=(const CRecompiler&);
 
     CCompiledFunc * CompileCode();
+    CCompiledFunc * CompileBlock(uint32_t EnterPC);
+    CCompiledFunc * FindCompiledCode(uint32_t EnterPC);
+    bool ValidCompiledCode(CCompiledFunc * Func);
+    bool CodeMatchesHash(CCompiledFunc * Func);
+    void AddCompiledFunc(CCompiledFunc * Func);
+
+    // Background compilation, new blocks run in the interpreter until their code is ready
+    bool bBackgroundCompile() const { return m_BackgroundCompile; }
+    bool CompileInBackground();
+    void InterpretBlock();
+    void PublishCompiledCode();
+    void CompileThread();
+    void StopCompileThread();
+    static uint32_t stCompileThread(void * lpThreadParameter) { ((CRecompiler *)lpThreadParameter)->CompileThread(); return 0; }
+    void RemoveSegmentBlocks(uint32_t Segment);
+
+    // Direct jumps between compiled blocks, patched when the target is installed in the lookup table
+    void LinkBlock(uint32_t EnterPC, CCompiledFunc * Func);
+    void AddBlockLinks(const CCompiledFunc * Func);
+    void UnlinkBlocks(uint32_t Address, uint32_t Length);
+    void RemoveBlockLinks(const CCompiledFunc * Func);
+
+    // Blocks compiled into each code segment and the lookup slots they were installed in,
+    // so evicting a segment only clears its own entries
+    typedef std::vector<CCompiledFunc *> SEGMENT_FUNCS;
+    typedef std::vector<uint32_t> SEGMENT_SLOTS;
+    typedef std::deque<uint64_t> SEGMENT_HIT_COUNTERS; // Grown at the back so counters never move
+    typedef struct
+    {
+        SEGMENT_FUNCS Funcs;
+        SEGMENT_SLOTS JumpSlots;    // Indexes into JumpTable()
+        SEGMENT_SLOTS TableSlots;   // Virtual addresses in FunctionTable()
+        SEGMENT_HIT_COUNTERS HitCounters;
+    } SEGMENT_BLOCKS;
+    typedef std::vector<SEGMENT_BLOCKS> SEGMENT_BLOCK_LIST;
+
+    SEGMENT_BLOCKS & SegmentBlocks(const CCompiledFunc * Func) { return m_SegmentBlocks[SegmentOf((const void *)Func->Function())]; }
+    void SetJumpTableEntry(uint32_t PhysicalAddr, CCompiledFunc * Func);
+    uint64_t * NewHitCounter();
+    void ReleaseHitCounter(uint64_t * HitCounter);
+
+    typedef std::vector<uint32_t *> LINK_LOCATIONS;
+    typedef struct
+    {
+        CCompiledFunc * Func;
+        LINK_LOCATIONS  JumpLocs;
+    } LINK_TARGET;
+    typedef std::map<uint32_t, LINK_TARGET> LINK_TARGETS;
 
     typedef struct
     {
@@ -75,11 +136,27 @@ private:
     void RecompilerMain_Lookup_validate_TLB();
 
     CCompiledFuncList  m_Functions;
+    CBlockProfiler     m_BlockProfiler;
     CMipsMemoryVM    & m_MMU;
     CRegisters       & m_Registers;
     bool             & m_EndEmulation;
     uint32_t           m_MemoryStack;
     FUNCTION_PROFILE m_BlockProfile;
+    bool               m_BlockChaining;
+    LINK_TARGETS       m_LinkTargets;
+    SEGMENT_BLOCK_LIST m_SegmentBlocks;
+
+    bool               m_BackgroundCompile;
+    CThread            m_CompileThread;
+    SyncEvent          m_CompileRequest;
+    CriticalSection    m_CompileCS;
+    std::atomic<bool>  m_CompileThreadEnd;
+    std::atomic<bool>  m_CompileBusy;
+    std::atomic<bool>  m_CompileFinished;
+    std::atomic<bool>  m_CompileStale;
+    uint32_t           m_CompilePC;
+    uint64_t         * m_CompileHitCounter;
+    CCompiledFunc    * m_CompiledFunc;
 
     // Quick access to registers
     uint32_t            & PROGRAM_COUNTER;
@@ -6,7 +6,11 @@
 
 CRecompMemory::CRecompMemory() :
 m_RecompCode(nullptr),
-m_RecompSize(0)
+m_RecompSize(0),
+m_SegmentCount(0),
+m_SegmentsCommitted(0),
+m_SegmentsUsed(0),
+m_CurrentSegment(0)
 {
     m_RecompPos = nullptr;
 }
@@ -15,7 +19,7 @@ CRecompMemory::~CRecompMemory()
 {
     if (m_RecompCode)
     {
-		FreeAddressSpace(m_RecompCode,MaxCompileBufferSize + 4);
+		FreeAddressSpace(m_RecompCode,(m_SegmentCount * SegmentSize) + 4);
         m_RecompCode = nullptr;
     }
     m_RecompPos = nullptr;
@@ -24,8 +28,19 @@ CRecompMemory::~CRecompMemory()
 bool CRecompMemory::AllocateMemory()
 {
     WriteTrace(TraceRecompiler, TraceDebug, "Start");
-    uint8_t * RecompCodeBase = (uint8_t *)AllocateAddressSpace(MaxCompileBufferSize + 4);
-    WriteTrace(TraceRecompiler, TraceDebug, "RecompCodeBase = %X", RecompCodeBase);
+    uint32_t CacheSize = g_Settings->LoadDword(Setting_CodeCacheSize) * 0x100000;
+    if (CacheSize < MinCodeCacheSegments * SegmentSize)
+    {
+        CacheSize = MinCodeCacheSegments * SegmentSize;
+    }
+    if (CacheSize > MaxCodeCacheSize)
+    {
+        CacheSize = MaxCodeCacheSize;
+    }
+    m_SegmentCount = CacheSize / SegmentSize;
+
+    uint8_t * RecompCodeBase = (uint8_t *)AllocateAddressSpace((m_SegmentCount * SegmentSize) + 4);
+    WriteTrace(TraceRecompiler, TraceDebug, "RecompCodeBase = %X (segments: %d)", RecompCodeBase, m_SegmentCount);
     if (RecompCodeBase == nullptr)
     {
         WriteTrace(TraceRecompiler, TraceError, "Failed to allocate RecompCodeBase");
@@ -33,56 +48,79 @@ bool CRecompMemory::AllocateMemory()
         return false;
     }
 
-    m_RecompCode = (uint8_t *)CommitMemory(RecompCodeBase, InitialCompileBufferSize, MEM_EXECUTE_READWRITE);
+    m_RecompCode = (uint8_t *)CommitMemory(RecompCodeBase, SegmentSize, MEM_EXECUTE_READWRITE);
     if (m_RecompCode == nullptr)
     {
         WriteTrace(TraceRecompiler, TraceError, "Failed to commit initial buffer");
-		FreeAddressSpace(RecompCodeBase,MaxCompileBufferSize + 4);
+		FreeAddressSpace(RecompCodeBase,(m_SegmentCount * SegmentSize) + 4);
         g_Notify->DisplayError(MSG_MEM_ALLOC_ERROR);
         return false;
     }
-    m_RecompSize = InitialCompileBufferSize;
+    m_RecompSize = SegmentSize;
+    m_SegmentsCommitted = 1;
+    m_SegmentsUsed = 1;
+    m_CurrentSegment = 0;
     m_RecompPos = m_RecompCode;
-    memset(m_RecompCode, 0, InitialCompileBufferSize);
+    memset(m_RecompCode, 0, SegmentSize);
     WriteTrace(TraceRecompiler, TraceDebug, "Done");
     return true;
 }
 
 void CRecompMemory::CheckRecompMem()
 {
-    uint32_t Size = (uint32_t)((uint8_t *)m_RecompPos - (uint8_t *)m_RecompCode);
-    if ((Size + 0x20000) < m_RecompSize)
+    if ((m_RecompPos + 0x20000) < SegmentEnd(m_CurrentSegment))
     {
         return;
     }
-    if (m_RecompSize == MaxCompileBufferSize)
+    if (m_SegmentsUsed < m_SegmentCount)
     {
-        g_Recompiler->ResetRecompCode(true);
+        uint32_t Segment = m_SegmentsUsed;
+        if (Segment >= m_SegmentsCommitted)
+        {
+            void * MemAddr = CommitMemory(SegmentStart(Segment), SegmentSize, MEM_EXECUTE_READWRITE);
+            if (MemAddr == nullptr)
+            {
+                WriteTrace(TraceRecompiler, TraceError, "Failed to increase buffer");
+                g_Notify->FatalError(MSG_MEM_ALLOC_ERROR);
+            }
+            m_SegmentsCommitted += 1;
+            m_RecompSize += SegmentSize;
+        }
+        m_SegmentsUsed += 1;
+        UseSegment(Segment);
         return;
     }
-    void * MemAddr = CommitMemory(m_RecompCode + m_RecompSize, IncreaseCompileBufferSize, MEM_EXECUTE_READWRITE);
-    if (MemAddr == nullptr)
-    {
-        WriteTrace(TraceRecompiler, TraceError, "Failed to increase buffer");
-        g_Notify->FatalError(MSG_MEM_ALLOC_ERROR);
-    }
-    m_RecompSize += IncreaseCompileBufferSize;
+    g_Recompiler->RemoveColdSegment();
+}
+
+uint32_t CRecompMemory::SegmentOf(const void * Location) const
+{
+    return (uint32_t)(((const uint8_t *)Location - m_RecompCode) / SegmentSize);
+}
+
+void CRecompMemory::UseSegment(uint32_t Segment)
+{
+    WriteTrace(TraceRecompiler, TraceInfo, "Using code segment %d", Segment);
+    m_CurrentSegment = Segment;
+    m_RecompPos = SegmentStart(Segment);
 }
 
 void CRecompMemory::Reset()
 {
+    m_SegmentsUsed = 1;
+    m_CurrentSegment = 0;
     m_RecompPos = m_RecompCode;
 }
 
 void CRecompMemory::ShowMemUsed()
 {
-    uint32_t Size = m_RecompPos - m_RecompCode;
+    uint32_t Size = ((m_SegmentsUsed - 1) * SegmentSize) + (uint32_t)(m_RecompPos - SegmentStart(m_CurrentSegment));
     uint32_t MB = Size / 0x100000;
     Size -= MB * 0x100000;
     uint32_t KB = Size / 1024;
     Size -= KB * 1024;
 
-    uint32_t TotalAvaliable = m_RecompSize / 0x100000;
+    uint32_t TotalAvaliable = (m_SegmentCount * SegmentSize) / 0x100000;
 
     g_Notify->DisplayMessage(0, stdstr_f("Memory used: %d mb %-3d kb %-3d bytes     Total Available: %d mb", MB, KB, Size, TotalAvaliable).c_str());
-}
\ No newline at end of file
+}
@@ -1,6 +1,9 @@
 #pragma once
 #include <Project64-core/N64System/Recompiler/x86/x86ops.h>
 
+// The code buffer is split into fixed size segments. Code is appended to the
+// current segment; once every segment has been used, the coldest one is evicted
+// and reused instead of throwing away all compiled code.
 class CRecompMemory
 {
 protected:
@@ -12,6 +15,13 @@ protected:
     void Reset();
     void ShowMemUsed();
 
+    uint32_t  SegmentCount() const { return m_SegmentCount; }
+    uint32_t  CurrentSegment() const { return m_CurrentSegment; }
+    uint32_t  SegmentOf(const void * Location) const;
+    uint8_t * SegmentStart(uint32_t Segment) const { return m_RecompCode + (Segment * SegmentSize); }
+    uint8_t * SegmentEnd(uint32_t Segment) const { return m_RecompCode + ((Segment + 1) * SegmentSize); }
+    void      UseSegment(uint32_t Segment);
+
 public:
     uint8_t** RecompPos() { return &m_RecompPos; }
 
@@ -22,8 +32,12 @@ private:
     uint8_t * m_RecompCode;
     uint32_t  m_RecompSize;
     uint8_t * m_RecompPos;
+    uint32_t  m_SegmentCount;
+    uint32_t  m_SegmentsCommitted;
+    uint32_t  m_SegmentsUsed;
+    uint32_t  m_CurrentSegment;
 
-    enum { MaxCompileBufferSize = 0x03C00000 };
-    enum { InitialCompileBufferSize = 0x00500000 };
-    enum { IncreaseCompileBufferSize = 0x00100000 };
+    enum { SegmentSize = 0x00400000 };
+    enum { MinCodeCacheSegments = 2 };
+    enum { MaxCodeCacheSize = 0x20000000 };
 };
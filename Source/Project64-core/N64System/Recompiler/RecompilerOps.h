@@ -208,6 +208,9 @@ public:
     virtual void UnknownOpcode() = 0;
 
     virtual void EnterCodeBlock() = 0;
+#if defined(__i386__) || defined(_M_IX86)
+    virtual void CompileEntryCounter(uint64_t * Counter) = 0;
+#endif
     virtual void ExitCodeBlock() = 0;
     virtual void CompileExitCode() = 0;
     virtual void CompileCop1Test() = 0;
@@ -3789,6 +3789,7 @@ void CX86RecompilerOps::SB()
     }
     Compile_StoreInstructClean(TempReg1, 4);
     TestWriteBreakpoint(TempReg1, (void *)x86TestWriteBreakpoint8, "x86TestWriteBreakpoint8");
+    UpdatePageGeneration(TempReg1);
 
     if (g_System->bUseTlb())
     {
@@ -3886,6 +3887,7 @@ void CX86RecompilerOps::SH()
         AddConstToX86Reg(TempReg1, (int16_t)m_Opcode.immediate);
     }
     TestWriteBreakpoint(TempReg1, (void *)x86TestWriteBreakpoint16, "x86TestWriteBreakpoint16");
+    UpdatePageGeneration(TempReg1);
 
     if (g_System->bUseTlb())
     {
@@ -3972,6 +3974,7 @@ void CX86RecompilerOps::SWL()
         AddConstToX86Reg(TempReg1, (int16_t)m_Opcode.immediate);
     }
     TestWriteBreakpoint(TempReg1, (void *)x86TestWriteBreakpoint32, "x86TestWriteBreakpoint32");
+    UpdatePageGeneration(TempReg1);
 
     x86Reg TempReg2 = x86_Unknown;
     if (g_System->bUseTlb())
@@ -4130,6 +4133,7 @@ void CX86RecompilerOps::SW(bool bCheckLLbit)
         }
         Compile_StoreInstructClean(TempReg1, 4);
         TestWriteBreakpoint(TempReg1, (void *)x86TestWriteBreakpoint32, "x86TestWriteBreakpoint32");
+        UpdatePageGeneration(TempReg1);
         if (g_System->bUseTlb())
         {
             TempReg2 = Map_TempReg(x86_Any, -1, false);
@@ -4234,6 +4238,7 @@ void CX86RecompilerOps::SWR()
         AddConstToX86Reg(TempReg1, (int16_t)m_Opcode.immediate);
     }
     TestWriteBreakpoint(TempReg1, (void *)x86TestWriteBreakpoint32, "x86TestWriteBreakpoint32");
+    UpdatePageGeneration(TempReg1);
     if (g_System->bUseTlb())
     {
         TempReg2 = Map_TempReg(x86_Any, -1, false);
@@ -4689,6 +4694,7 @@ void CX86RecompilerOps::SWC1()
         AddConstToX86Reg(TempReg1, (int16_t)m_Opcode.immediate);
     }
     TestWriteBreakpoint(TempReg1, (void *)x86TestWriteBreakpoint32, "x86TestWriteBreakpoint32");
+    UpdatePageGeneration(TempReg1);
     if (g_System->bUseTlb())
     {
         x86Reg TempReg2 = Map_TempReg(x86_Any, -1, false);
@@ -4765,6 +4771,7 @@ void CX86RecompilerOps::SDC1()
         AddConstToX86Reg(TempReg1, (int16_t)m_Opcode.immediate);
     }
     TestWriteBreakpoint(TempReg1, (void *)x86TestWriteBreakpoint64, "x86TestWriteBreakpoint64");
+    UpdatePageGeneration(TempReg1);
     if (g_System->bUseTlb())
     {
         x86Reg TempReg2 = Map_TempReg(x86_Any, -1, false);
@@ -4862,6 +4869,7 @@ void CX86RecompilerOps::SD()
         Compile_StoreInstructClean(TempReg1, 8);
 
         TestWriteBreakpoint(TempReg1, (void *)x86TestWriteBreakpoint64, "x86TestWriteBreakpoint64");
+        UpdatePageGeneration(TempReg1);
         if (g_System->bUseTlb())
         {
             TempReg2 = Map_TempReg(x86_Any, -1, false);
@@ -9228,6 +9236,13 @@ void CX86RecompilerOps::EnterCodeBlock()
 #endif
 }
 
+void CX86RecompilerOps::CompileEntryCounter(uint64_t * Counter)
+{
+    // Also runs when a chained block jumps here, so every entry is counted
+    AddConstToVariable(1, (uint32_t *)Counter, "EntryCounter");
+    AdcConstToVariable((uint32_t *)Counter + 1, "EntryCounter + 4", 0);
+}
+
 void CX86RecompilerOps::ExitCodeBlock()
 {
     if (g_SyncSystem)
@@ -9251,6 +9266,40 @@ void CX86RecompilerOps::ExitCodeBlock()
     Ret();
 }
 
+void CX86RecompilerOps::ExitCodeBlockChained(uint32_t TargetPC, CRegInfo & ExitRegSet)
+{
+    // The jump starts out pointing at the following ret, the recompiler patches it
+    // to the target block once that is compiled and points it back when it is removed.
+    //
+    // Blocks are entered as a plain void function called from the lookup loop, so an entry
+    // only relies on the return address on the stack and the callee saved registers. Popping
+    // those here leaves the stack as the call found it, and EAX is scratch at any call boundary.
+    // No MIPS register may still live in a host register, WriteBackRegisters has flushed them.
+    for (int32_t i = 0, n = sizeof(x86_Registers) / sizeof(x86_Registers[0]); i < n; i++)
+    {
+        if (ExitRegSet.GetX86Mapped(x86_Registers[i]) != CRegInfo::NotMapped)
+        {
+            g_Notify->BreakPoint(__FILE__, __LINE__);
+        }
+    }
+    MoveZxVariableToX86regByte(&g_System->m_EndEmulation, "m_EndEmulation", x86_EAX);
+    TestX86RegToX86Reg(x86_EAX, x86_EAX);
+#ifdef _DEBUG
+    Pop(x86_ESI);
+#else
+    Pop(x86_EBX);
+    Pop(x86_ESI);
+    Pop(x86_EDI);
+#endif
+    JneLabel8("ExitBlock", 0);
+    uint8_t * Jump = *g_RecompPos - 1;
+    JmpLabel32("BlockLink", 0);
+    m_Section->m_BlockInfo->AddLink(TargetPC, (uint32_t *)(*g_RecompPos - 4));
+    CPU_Message("      ExitBlock:");
+    SetJump8(Jump, *g_RecompPos);
+    Ret();
+}
+
 void CX86RecompilerOps::CompileExitCode()
 {
     for (EXIT_LIST::iterator ExitIter = m_ExitInfo.begin(); ExitIter != m_ExitInfo.end(); ExitIter++)
@@ -10394,7 +10443,14 @@ void CX86RecompilerOps::CompileExit(uint32_t JumpPC, uint32_t TargetPC, CRegInfo
         }
         ExitCodeBlock();
 #else
-        ExitCodeBlock();
+        if (reason == CExitInfo::Normal && g_Recompiler != nullptr && g_Recompiler->bBlockChaining() && TargetPC >= 0x80000000 && TargetPC < 0xC0000000)
+        {
+            ExitCodeBlockChained(TargetPC, ExitRegSet);
+        }
+        else
+        {
+            ExitCodeBlock();
+        }
 #endif
         break;
     case CExitInfo::DoCPU_Action:
@@ -10550,6 +10606,40 @@ void CX86RecompilerOps::Compile_StoreInstructClean(x86Reg AddressReg, int32_t Le
     X86Protected(StoreTemp1) = false;*/
 }
 
+void CX86RecompilerOps::UpdatePageGeneration(x86Reg AddressReg)
+{
+    // Only the validate lookup loops read page generations
+    if (!g_System->bSMM_ValidFunc())
+    {
+        return;
+    }
+    x86Reg TempReg = Map_TempReg(x86_Any, -1, false);
+    MoveX86RegToX86Reg(AddressReg, TempReg);
+    if (g_System->bUseTlb())
+    {
+        ShiftRightUnsignImmed(TempReg, 12);
+        MoveVariableDispToX86Reg(g_MMU->m_TLB_WriteMap, "MMU->TLB_WriteMap", TempReg, TempReg, 4);
+        AddX86RegToX86Reg(TempReg, AddressReg);
+        SubConstFromX86Reg(TempReg, (uint32_t)g_MMU->Rdram());
+    }
+    ShiftRightUnsignImmed(TempReg, 12);
+    AndConstToX86Reg(TempReg, CMipsMemoryVM::PageGenerationMask);
+    AddConstToVariableDisp(1, g_MMU->PageGenerations(), "PageGeneration", TempReg, Multip_x4);
+    m_RegWorkingSet.SetX86Protected(TempReg, false);
+    m_RegWorkingSet.SetX86Mapped(TempReg, CRegInfo::NotMapped);
+}
+
+void CX86RecompilerOps::UpdatePageGeneration_Const(uint32_t PAddr)
+{
+    if (!g_System->bSMM_ValidFunc())
+    {
+        return;
+    }
+    char VarName[100];
+    sprintf(VarName, "PageGeneration[%X]", (PAddr >> 12) & CMipsMemoryVM::PageGenerationMask);
+    AddConstToVariable(1, &g_MMU->PageGenerations()[(PAddr >> 12) & CMipsMemoryVM::PageGenerationMask], VarName);
+}
+
 void CX86RecompilerOps::SB_Const(uint8_t Value, uint32_t VAddr)
 {
     char VarName[100];
@@ -10564,6 +10654,7 @@ void CX86RecompilerOps::SB_Const(uint8_t Value, uint32_t VAddr)
         ShiftRightUnsignImmed(TempReg2, 12);
         MoveVariableDispToX86Reg(g_MMU->m_TLB_WriteMap, "MMU->TLB_WriteMap", TempReg2, TempReg2, 4);
         CompileWriteTLBMiss(TempReg1, TempReg2);
+        UpdatePageGeneration(TempReg1);
         MoveConstByteToX86regPointer(Value, TempReg1, TempReg2);
         return;
     }
@@ -10587,6 +10678,7 @@ void CX86RecompilerOps::SB_Const(uint8_t Value, uint32_t VAddr)
     case 0x00700000:
         sprintf(VarName, "RDRAM + %X", PAddr);
         MoveConstByteToVariable(Value, PAddr + g_MMU->Rdram(), VarName);
+        UpdatePageGeneration_Const(PAddr);
         break;
     default:
         if (ShowUnhandledMemory())
@@ -10612,6 +10704,7 @@ void CX86RecompilerOps::SB_Register(x86Reg Reg, uint32_t VAddr)
         ShiftRightUnsignImmed(TempReg2, 12);
         MoveVariableDispToX86Reg(g_MMU->m_TLB_WriteMap, "MMU->TLB_WriteMap", TempReg2, TempReg2, 4);
         CompileWriteTLBMiss(TempReg1, TempReg2);
+        UpdatePageGeneration(TempReg1);
         MoveX86regByteToX86regPointer(Reg, TempReg1, TempReg2);
         return;
     }
@@ -10638,6 +10731,7 @@ void CX86RecompilerOps::SB_Register(x86Reg Reg, uint32_t VAddr)
     case 0x00700000:
         sprintf(VarName, "RDRAM + %X", PAddr);
         MoveX86regByteToVariable(Reg, PAddr + g_MMU->Rdram(), VarName);
+        UpdatePageGeneration_Const(PAddr);
         break;
     default:
         if (ShowUnhandledMemory())
@@ -10661,6 +10755,7 @@ void CX86RecompilerOps::SH_Const(uint16_t Value, uint32_t VAddr)
         ShiftRightUnsignImmed(TempReg2, 12);
         MoveVariableDispToX86Reg(g_MMU->m_TLB_WriteMap, "MMU->TLB_WriteMap", TempReg2, TempReg2, 4);
         CompileWriteTLBMiss(TempReg1, TempReg2);
+        UpdatePageGeneration(TempReg1);
         MoveConstHalfToX86regPointer(Value, TempReg1, TempReg2);
         return;
     }
@@ -10687,6 +10782,7 @@ void CX86RecompilerOps::SH_Const(uint16_t Value, uint32_t VAddr)
     case 0x00700000:
         sprintf(VarName, "RDRAM + %X", PAddr);
         MoveConstHalfToVariable(Value, PAddr + g_MMU->Rdram(), VarName);
+        UpdatePageGeneration_Const(PAddr);
         break;
     default:
         if (ShowUnhandledMemory())
@@ -10712,6 +10808,7 @@ void CX86RecompilerOps::SH_Register(x86Reg Reg, uint32_t VAddr)
         ShiftRightUnsignImmed(TempReg2, 12);
         MoveVariableDispToX86Reg(g_MMU->m_TLB_WriteMap, "MMU->TLB_WriteMap", TempReg2, TempReg2, 4);
         CompileWriteTLBMiss(TempReg1, TempReg2);
+        UpdatePageGeneration(TempReg1);
         MoveX86regHalfToX86regPointer(Reg, TempReg1, TempReg2);
         return;
     }
@@ -10738,6 +10835,7 @@ void CX86RecompilerOps::SH_Register(x86Reg Reg, uint32_t VAddr)
     case 0x00700000:
         sprintf(VarName, "RDRAM + %X", PAddr);
         MoveX86regHalfToVariable(Reg, PAddr + g_MMU->Rdram(), VarName);
+        UpdatePageGeneration_Const(PAddr);
         break;
     default:
         if (ShowUnhandledMemory())
@@ -10762,6 +10860,7 @@ void CX86RecompilerOps::SW_Const(uint32_t Value, uint32_t VAddr)
         ShiftRightUnsignImmed(TempReg2, 12);
         MoveVariableDispToX86Reg(g_MMU->m_TLB_WriteMap, "MMU->TLB_WriteMap", TempReg2, TempReg2, 4);
         CompileWriteTLBMiss(TempReg1, TempReg2);
+        UpdatePageGeneration(TempReg1);
         MoveConstToX86regPointer(Value, TempReg1, TempReg2);
         return;
     }
@@ -10788,6 +10887,7 @@ void CX86RecompilerOps::SW_Const(uint32_t Value, uint32_t VAddr)
     case 0x00700000:
         sprintf(VarName, "RDRAM + %X", PAddr);
         MoveConstToVariable(Value, PAddr + g_MMU->Rdram(), VarName);
+        UpdatePageGeneration_Const(PAddr);
         break;
     case 0x03F00000:
         switch (PAddr)
@@ -11335,6 +11435,7 @@ void CX86RecompilerOps::SW_Register(x86Reg Reg, uint32_t VAddr)
         ShiftRightUnsignImmed(TempReg2, 12);
         MoveVariableDispToX86Reg(g_MMU->m_TLB_WriteMap, "MMU->TLB_WriteMap", TempReg2, TempReg2, 4);
         CompileWriteTLBMiss(TempReg1, TempReg2);
+        UpdatePageGeneration(TempReg1);
         MoveX86regToX86regPointer(Reg, TempReg1, TempReg2);
         return;
     }
@@ -11364,6 +11465,7 @@ void CX86RecompilerOps::SW_Register(x86Reg Reg, uint32_t VAddr)
     case 0x00700000:
         sprintf(VarName, "RDRAM + %X", PAddr);
         MoveX86regToVariable(Reg, PAddr + g_MMU->Rdram(), VarName);
+        UpdatePageGeneration_Const(PAddr);
         break;
     case 0x04000000:
         switch (PAddr)
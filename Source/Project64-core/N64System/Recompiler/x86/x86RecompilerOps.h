@@ -206,7 +206,9 @@ public:
     void TestReadBreakpoint(x86Reg AddressReg, void * FunctAddress, const char * FunctName);
     void TestBreakpoint(x86Reg AddressReg, void * FunctAddress, const char * FunctName);
     void EnterCodeBlock();
+    void CompileEntryCounter(uint64_t * Counter);
     void ExitCodeBlock();
+    void ExitCodeBlockChained(uint32_t TargetPC, CRegInfo & ExitRegSet);
     void CompileExitCode();
     void CompileCop1Test();
     void CompileInPermLoop(CRegInfo & RegSet, uint32_t ProgramCounter);
@@ -362,6 +364,8 @@ private:
     void SW(bool bCheckLLbit);
     void CompileExit(uint32_t JumpPC, uint32_t TargetPC, CRegInfo &ExitRegSet, CExitInfo::EXIT_REASON reason, bool CompileNow, void(*x86Jmp)(const char * Label, uint32_t Value));
     void Compile_StoreInstructClean(x86Reg AddressReg, int32_t Length);
+    void UpdatePageGeneration(x86Reg AddressReg);
+    void UpdatePageGeneration_Const(uint32_t PAddr);
     void ResetMemoryStack();
 
     EXIT_LIST m_ExitInfo;
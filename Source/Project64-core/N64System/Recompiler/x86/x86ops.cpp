@@ -87,6 +87,15 @@ void CX86Ops::AddConstToVariable(uint32_t Const, void *Variable, const char * Va
     AddCode32(Const);
 }
 
+void CX86Ops::AddConstToVariableDisp(uint32_t Const, void * Variable, const char * VariableName, x86Reg AddrReg, Multipler Multiply)
+{
+    CPU_Message("      add dword ptr [%s+%s*%i], 0x%X", VariableName, x86_Name(AddrReg), Multiply, Const);
+    AddCode16(0x0481);
+    AddCode8((uint8_t)(0x05 + CalcMultiplyCode(Multiply) + (AddrReg * 0x8)));
+    AddCode32((uint32_t)(Variable));
+    AddCode32(Const);
+}
+
 void CX86Ops::AddConstToX86Reg(x86Reg reg, uint32_t Const)
 {
     if (Const == 0)
@@ -60,6 +60,7 @@ protected:
     static void AdcVariableToX86reg(x86Reg reg, void * Variable, const char * VariableName);
     static void AdcX86RegToX86Reg(x86Reg Destination, x86Reg Source);
     static void AddConstToVariable(uint32_t Const, void *Variable, const char * VariableName);
+    static void AddConstToVariableDisp(uint32_t Const, void * Variable, const char * VariableName, x86Reg AddrReg, Multipler Multiply);
     static void AddConstToX86Reg(x86Reg Reg, uint32_t Const);
     static void AddVariableToX86reg(x86Reg reg, void * Variable, const char * VariableName);
     static void AddX86regToVariable(x86Reg reg, void * Variable, const char * VariableName);
@@ -0,0 +1,189 @@
+#include "stdafx.h"
+#include <Project64-core/N64System/RewindBuffer.h>
+
+CRewindBuffer::CRewindBuffer(uint32_t MaxSize) :
+    m_MaxSize(MaxSize),
+    m_Newest(0),
+    m_HaveNewest(false),
+    m_DeltaSize(0),
+    m_TotalCaptureTime(0),
+    m_Captures(0),
+    m_Rewinds(0)
+{
+}
+
+CSaveStateBuffer & CRewindBuffer::State()
+{
+    CSaveStateBuffer & Buffer = m_State[m_Newest ^ 1];
+    Buffer.Clear();
+    return Buffer;
+}
+
+CSaveStateBuffer & CRewindBuffer::ExtraInfo()
+{
+    CSaveStateBuffer & Buffer = m_ExtraInfo[m_Newest ^ 1];
+    Buffer.Clear();
+    return Buffer;
+}
+
+void CRewindBuffer::Capture(HighResTimeStamp StartTime)
+{
+    uint32_t Captured = m_Newest ^ 1;
+    if (m_HaveNewest &&
+        m_State[Captured].Length() == m_State[m_Newest].Length() &&
+        m_ExtraInfo[Captured].Length() == m_ExtraInfo[m_Newest].Length())
+    {
+        DELTA Delta;
+        Delta.swap(m_Spare);
+        Delta.clear();
+        Encode(m_State[m_Newest], m_State[Captured], Delta);
+        Encode(m_ExtraInfo[m_Newest], m_ExtraInfo[Captured], Delta);
+        m_DeltaSize += (uint32_t)Delta.size();
+        m_Deltas.push_back(DELTA());
+        m_Deltas.back().swap(Delta);
+    }
+    else
+    {
+        // The layout changed (RDRAM size or disk), older snapshots can not be rebuilt from this one
+        while (!m_Deltas.empty())
+        {
+            DropOldest();
+        }
+    }
+    m_Newest = Captured;
+    m_HaveNewest = true;
+
+    while (!m_Deltas.empty() && MemoryUsed() > m_MaxSize)
+    {
+        DropOldest();
+    }
+
+    HighResTimeStamp EndTime;
+    EndTime.SetToNow();
+    m_TotalCaptureTime += EndTime.GetMicroSeconds() - StartTime.GetMicroSeconds();
+    m_Captures += 1;
+}
+
+bool CRewindBuffer::Rewind(uint32_t Snapshots)
+{
+    if (!m_HaveNewest)
+    {
+        return false;
+    }
+    for (uint32_t i = 1; i < Snapshots && !m_Deltas.empty(); i++)
+    {
+        DELTA & Delta = m_Deltas.back();
+        const uint32_t * Runs = (const uint32_t *)&Delta[0];
+        Runs = Apply(Runs, m_State[m_Newest]);
+        Apply(Runs, m_ExtraInfo[m_Newest]);
+
+        m_DeltaSize -= (uint32_t)Delta.size();
+        if (Delta.capacity() > m_Spare.capacity())
+        {
+            m_Spare.swap(Delta);
+        }
+        m_Deltas.pop_back();
+    }
+    m_Rewinds += 1;
+    return true;
+}
+
+void CRewindBuffer::Clear()
+{
+    while (!m_Deltas.empty())
+    {
+        DropOldest();
+    }
+    m_HaveNewest = false;
+}
+
+uint32_t CRewindBuffer::MemoryUsed() const
+{
+    // The newest snapshot and the buffer the next one is serialised into are both held in full
+    return m_HaveNewest ? (m_State[m_Newest].Length() + m_ExtraInfo[m_Newest].Length()) * 2 + m_DeltaSize : 0;
+}
+
+void CRewindBuffer::DropOldest()
+{
+    DELTA & Delta = m_Deltas.front();
+    m_DeltaSize -= (uint32_t)Delta.size();
+    if (Delta.capacity() > m_Spare.capacity())
+    {
+        m_Spare.swap(Delta);
+    }
+    m_Deltas.pop_front();
+}
+
+void CRewindBuffer::Encode(const CSaveStateBuffer & Old, const CSaveStateBuffer & New, DELTA & Delta)
+{
+    // Runs of (words to skip, words changed, changed words XOR old words), a partial word at
+    // the end is padded out to a whole one so every run stays word aligned
+    const uint32_t * OldWords = (const uint32_t *)Old.Data();
+    const uint32_t * NewWords = (const uint32_t *)New.Data();
+    uint32_t Words = New.Length() / sizeof(uint32_t);
+
+    for (uint32_t i = 0; i < Words;)
+    {
+        uint32_t Start = i;
+        while (i < Words && OldWords[i] == NewWords[i])
+        {
+            i++;
+        }
+        uint32_t Skip = i - Start;
+
+        // A lone unchanged word is cheaper to keep inside a run than the two words that start a new run
+        Start = i;
+        while (i < Words && (OldWords[i] != NewWords[i] || (i + 1 < Words && OldWords[i + 1] != NewWords[i + 1])))
+        {
+            i++;
+        }
+        uint32_t Count = i - Start;
+
+        size_t Pos = Delta.size();
+        Delta.resize(Pos + (2 + Count) * sizeof(uint32_t));
+        uint32_t * Run = (uint32_t *)&Delta[Pos];
+        Run[0] = Skip;
+        Run[1] = Count;
+        for (uint32_t x = 0; x < Count; x++)
+        {
+            Run[2 + x] = OldWords[Start + x] ^ NewWords[Start + x];
+        }
+    }
+
+    uint32_t Remaining = New.Length() % sizeof(uint32_t);
+    if (Remaining != 0)
+    {
+        uint32_t OldTail = 0, NewTail = 0;
+        memcpy(&OldTail, Old.Data() + Words * sizeof(uint32_t), Remaining);
+        memcpy(&NewTail, New.Data() + Words * sizeof(uint32_t), Remaining);
+        uint32_t Tail = OldTail ^ NewTail;
+        Delta.insert(Delta.end(), (const uint8_t *)&Tail, (const uint8_t *)&Tail + sizeof(Tail));
+    }
+}
+
+const uint32_t * CRewindBuffer::Apply(const uint32_t * Delta, CSaveStateBuffer & Buffer)
+{
+    uint32_t * Words = (uint32_t *)Buffer.Data();
+    uint32_t WordCount = Buffer.Length() / sizeof(uint32_t);
+
+    for (uint32_t i = 0; i < WordCount;)
+    {
+        i += Delta[0];
+        uint32_t Count = Delta[1];
+        Delta += 2;
+        for (uint32_t x = 0; x < Count; x++)
+        {
+            Words[i++] ^= *Delta++;
+        }
+    }
+
+    uint32_t Remaining = Buffer.Length() % sizeof(uint32_t);
+    if (Remaining != 0)
+    {
+        uint32_t Tail = 0;
+        memcpy(&Tail, Buffer.Data() + WordCount * sizeof(uint32_t), Remaining);
+        Tail ^= *Delta++;
+        memcpy(Buffer.Data() + WordCount * sizeof(uint32_t), &Tail, Remaining);
+    }
+    return Delta;
+}
@@ -0,0 +1,58 @@
+#pragma once
+#include <Project64-core/N64System/SaveStateWriter.h>
+#include <Common/HighResTimeStamp.h>
+#include <deque>
+#include <vector>
+
+// Recent save states held in memory so the game can be stepped back. Only the newest
+// snapshot is kept whole, each older one is stored as the run length encoded XOR against
+// the snapshot taken after it, so memory that did not change between two captures costs
+// next to nothing. The oldest snapshots are dropped to stay inside the memory budget.
+class CRewindBuffer
+{
+public:
+    CRewindBuffer(uint32_t MaxSize);
+
+    // Buffers to serialise the next snapshot into, followed by Capture to keep it. StartTime
+    // is when serialising started so the capture cost covers both steps.
+    CSaveStateBuffer & State();
+    CSaveStateBuffer & ExtraInfo();
+    void Capture(HighResTimeStamp StartTime);
+
+    // Steps back to the snapshot Snapshots captures ago (1 = newest), the snapshots after
+    // it are discarded. Returns false if nothing has been captured.
+    bool Rewind(uint32_t Snapshots);
+    CSaveStateBuffer & NewestState() { return m_State[m_Newest]; }
+    CSaveStateBuffer & NewestExtraInfo() { return m_ExtraInfo[m_Newest]; }
+
+    void Clear();
+
+    uint32_t Snapshots() const { return m_HaveNewest ? (uint32_t)m_Deltas.size() + 1 : 0; }
+    uint32_t MemoryUsed() const;
+    uint32_t AverageCaptureTime() const { return m_Captures != 0 ? (uint32_t)(m_TotalCaptureTime / m_Captures) : 0; }
+    uint32_t Captures() const { return m_Captures; }
+    uint32_t Rewinds() const { return m_Rewinds; }
+
+private:
+    CRewindBuffer();
+    CRewindBuffer(const CRewindBuffer&);
+    CRewindBuffer& operator=(const CRewindBuffer&);
+
+    typedef std::vector<uint8_t> DELTA;
+
+    static void Encode(const CSaveStateBuffer & Old, const CSaveStateBuffer & New, DELTA & Delta);
+    static const uint32_t * Apply(const uint32_t * Delta, CSaveStateBuffer & Buffer);
+    void DropOldest();
+
+    uint32_t m_MaxSize;
+    CSaveStateBuffer m_State[2];
+    CSaveStateBuffer m_ExtraInfo[2];
+    uint32_t m_Newest;
+    bool m_HaveNewest;
+    std::deque<DELTA> m_Deltas; // Oldest first, the last one turns the newest snapshot into the one before it
+    uint32_t m_DeltaSize;
+    DELTA m_Spare;
+    uint64_t m_TotalCaptureTime;
+    uint32_t m_Captures;
+    uint32_t m_Rewinds;
+};
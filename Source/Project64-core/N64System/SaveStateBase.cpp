@@ -0,0 +1,150 @@
+#include "stdafx.h"
+#include <Project64-core/N64System/SaveStateBase.h>
+#include <Common/File.h>
+
+CSaveStateBase::CSaveStateBase(CMipsMemoryVM & MMU) :
+    m_MMU(MMU),
+    m_Rdram(nullptr),
+    m_RdramSize(0)
+{
+}
+
+CSaveStateBase::~CSaveStateBase()
+{
+    delete[] m_Rdram;
+    m_Rdram = nullptr;
+}
+
+CPath CSaveStateBase::BaseFile(const CPath & SaveFile, const MD5Digest & Digest) const
+{
+    CPath FileName(SaveFile);
+    FileName.SetNameExtension(stdstr_f("%s.%s.pjbase", g_Settings->LoadStringVal(Rdb_GoodName).c_str(), MD5Digest(Digest).String().c_str()).c_str());
+    return FileName;
+}
+
+bool CSaveStateBase::ChangedPages(const CPath & SaveFile, uint32_t RdramSize, PAGE_LIST & Pages)
+{
+    Pages.clear();
+    if (m_Rdram == nullptr || m_RdramSize != RdramSize || !BaseFile(SaveFile, m_Digest).Exists())
+    {
+        return Rebase(SaveFile, RdramSize);
+    }
+
+    // Every page is compared, page generations are not bumped by all writers in every CPU mode
+    const uint8_t * Rdram = m_MMU.Rdram();
+    uint32_t PageCount = RdramSize >> 12;
+    for (uint32_t Page = 0; Page < PageCount; Page++)
+    {
+        if (memcmp(Rdram + (Page << 12), m_Rdram + (Page << 12), 0x1000) != 0)
+        {
+            Pages.push_back(Page);
+        }
+    }
+    if (Pages.size() > PageCount / 2)
+    {
+        Pages.clear();
+        return Rebase(SaveFile, RdramSize);
+    }
+    return true;
+}
+
+bool CSaveStateBase::Rebase(const CPath & SaveFile, uint32_t RdramSize)
+{
+    if (m_RdramSize != RdramSize)
+    {
+        delete[] m_Rdram;
+        m_Rdram = new uint8_t[RdramSize];
+        m_RdramSize = RdramSize;
+    }
+    memcpy(m_Rdram, m_MMU.Rdram(), RdramSize);
+    MD5(m_Rdram, RdramSize).get_digest(m_Digest);
+
+    CPath FileName(BaseFile(SaveFile, m_Digest));
+    if (FileName.Exists())
+    {
+        return true;
+    }
+    CFile File;
+    if (!File.Open(FileName, CFileBase::modeWrite | CFileBase::modeCreate) || !File.Write(m_Rdram, RdramSize))
+    {
+        WriteTrace(TraceN64System, TraceError, "Failed to write save state base (%s)", (const char *)FileName);
+        File.Close();
+        FileName.Delete();
+        m_Digest.Reset();
+        return false;
+    }
+    WriteTrace(TraceN64System, TraceInfo, "Wrote save state base (%s)", (const char *)FileName);
+    return true;
+}
+
+bool CSaveStateBase::Load(const CPath & SaveFile, const MD5Digest & Digest, uint32_t RdramSize)
+{
+    if (m_Rdram != nullptr && m_RdramSize == RdramSize && memcmp(m_Digest.digest, Digest.digest, sizeof(Digest.digest)) == 0)
+    {
+        return true;
+    }
+
+    CPath FileName(BaseFile(SaveFile, Digest));
+    CFile File;
+    if (!File.Open(FileName, CFileBase::modeRead) || File.GetLength() != RdramSize)
+    {
+        WriteTrace(TraceN64System, TraceError, "Missing save state base (%s)", (const char *)FileName);
+        return false;
+    }
+
+    uint8_t * Rdram = new uint8_t[RdramSize];
+    MD5Digest FileDigest;
+    if (File.Read(Rdram, RdramSize) != RdramSize)
+    {
+        delete[] Rdram;
+        return false;
+    }
+    MD5(Rdram, RdramSize).get_digest(FileDigest);
+    if (memcmp(FileDigest.digest, Digest.digest, sizeof(Digest.digest)) != 0)
+    {
+        WriteTrace(TraceN64System, TraceError, "Save state base does not match its digest (%s)", (const char *)FileName);
+        delete[] Rdram;
+        return false;
+    }
+
+    delete[] m_Rdram;
+    m_Rdram = Rdram;
+    m_RdramSize = RdramSize;
+    m_Digest = Digest;
+    return true;
+}
+
+void CSaveStateBase::Restore(uint8_t * Rdram) const
+{
+    memcpy(Rdram, m_Rdram, m_RdramSize);
+}
+
+void CSaveStateBase::Prune(const CPath & SaveFile, const DIGEST_LIST & InUse) const
+{
+    CPath SearchFile(SaveFile);
+    SearchFile.SetNameExtension(stdstr_f("%s.*.pjbase", g_Settings->LoadStringVal(Rdb_GoodName).c_str()).c_str());
+    if (!SearchFile.FindFirst())
+    {
+        return;
+    }
+
+    std::vector<CPath> Unused;
+    do
+    {
+        bool Used = SearchFile == BaseFile(SaveFile, m_Digest);
+        for (size_t i = 0, n = InUse.size(); !Used && i < n; i++)
+        {
+            Used = SearchFile == BaseFile(SaveFile, InUse[i]);
+        }
+        if (!Used)
+        {
+            Unused.push_back(SearchFile);
+        }
+    } while (SearchFile.FindNext());
+
+    for (size_t i = 0, n = Unused.size(); i < n; i++)
+    {
+        WriteTrace(TraceN64System, TraceInfo, "Deleting unused save state base (%s)", (const char *)Unused[i]);
+        Unused[i].Delete();
+    }
+}
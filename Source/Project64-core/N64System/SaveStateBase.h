@@ -0,0 +1,44 @@
+#pragma once
+#include <Project64-core/N64System/Mips/MemoryVirtualMem.h>
+#include <Common/md5.h>
+#include <Common/path.h>
+#include <vector>
+
+// RDRAM image that incremental save states are stored against. Only the 4KB pages that
+// differ from the base go into the state, the base is written once next to the states and
+// named after its digest so it is never overwritten while a state still refers to it.
+class CSaveStateBase
+{
+public:
+    typedef std::vector<uint32_t> PAGE_LIST;
+    typedef std::vector<MD5Digest> DIGEST_LIST;
+
+    CSaveStateBase(CMipsMemoryVM & MMU);
+    ~CSaveStateBase();
+
+    // Pages of RDRAM that differ from the base image, a new base is written when there is
+    // none yet or when most of RDRAM has changed since the last one
+    bool ChangedPages(const CPath & SaveFile, uint32_t RdramSize, PAGE_LIST & Pages);
+    const MD5Digest & Digest() const { return m_Digest; }
+
+    // Makes the base with this digest current, loading it from beside SaveFile if needed
+    bool Load(const CPath & SaveFile, const MD5Digest & Digest, uint32_t RdramSize);
+    void Restore(uint8_t * Rdram) const;
+
+    // Deletes the base images of this ROM beside SaveFile that neither the current base
+    // nor any of the digests in InUse refer to
+    void Prune(const CPath & SaveFile, const DIGEST_LIST & InUse) const;
+
+private:
+    CSaveStateBase();
+    CSaveStateBase(const CSaveStateBase&);
+    CSaveStateBase& operator=(const CSaveStateBase&);
+
+    bool Rebase(const CPath & SaveFile, uint32_t RdramSize);
+    CPath BaseFile(const CPath & SaveFile, const MD5Digest & Digest) const;
+
+    CMipsMemoryVM & m_MMU;
+    uint8_t       * m_Rdram;
+    uint32_t        m_RdramSize;
+    MD5Digest       m_Digest;
+};
@@ -0,0 +1,158 @@
+#include "stdafx.h"
+#include <Project64-core/N64System/SaveStateWriter.h>
+#include <Project64-core/3rdParty/zip.h>
+#include <Common/File.h>
+#include <Common/HighResTimeStamp.h>
+#include <Common/Util.h>
+#if defined(ANDROID)
+#include <utime.h>
+#endif
+
+CSaveStateWriter::CSaveStateWriter() :
+    m_Compression(SaveStateCompression_Fast),
+    m_WriterThread(stWriterThread),
+    m_WriteEvent(false),
+    m_IdleEvent(true),
+    m_WriterThreadEnd(false)
+{
+    m_IdleEvent.Trigger();
+}
+
+CSaveStateWriter::~CSaveStateWriter()
+{
+    WaitForIdle();
+    if (m_WriterThread.isRunning())
+    {
+        m_WriterThreadEnd = true;
+        m_WriteEvent.Trigger();
+        while (m_WriterThread.isRunning())
+        {
+            pjutil::Sleep(1);
+        }
+    }
+}
+
+CSaveStateBuffer & CSaveStateWriter::State()
+{
+    WaitForIdle();
+    m_State.Clear();
+    return m_State;
+}
+
+CSaveStateBuffer & CSaveStateWriter::ExtraInfo()
+{
+    WaitForIdle();
+    m_ExtraInfo.Clear();
+    return m_ExtraInfo;
+}
+
+void CSaveStateWriter::Commit(const CPath & SaveFile, const CPath & ExtraInfoFile, const CPath & ZipFile, SAVE_STATE_COMPRESSION Compression)
+{
+    WaitForIdle();
+    m_SaveFile = SaveFile;
+    m_ExtraInfoFile = ExtraInfoFile;
+    m_ZipFile = ZipFile;
+    m_Compression = Compression;
+    m_IdleEvent.Reset();
+
+    if (!m_WriterThread.isRunning())
+    {
+        m_WriterThreadEnd = false;
+        m_WriterThread.Start(this);
+    }
+    m_WriteEvent.Trigger();
+}
+
+void CSaveStateWriter::WaitForIdle()
+{
+    m_IdleEvent.IsTriggered(SyncEvent::INFINITE_TIMEOUT);
+}
+
+bool CSaveStateWriter::WriteZip()
+{
+    CPath TempFile(m_ZipFile);
+    TempFile.SetNameExtension(stdstr_f("%s.tmp", m_ZipFile.GetNameExtension().c_str()).c_str());
+
+    zipFile file = zipOpen(TempFile, 0);
+    if (file == nullptr)
+    {
+        return false;
+    }
+
+    int Method = m_Compression == SaveStateCompression_Stored ? 0 : Z_DEFLATED;
+    int Level = m_Compression == SaveStateCompression_Stored ? 0 : m_Compression == SaveStateCompression_Fast ? Z_BEST_SPEED : Z_DEFAULT_COMPRESSION;
+    bool Saved = zipOpenNewFileInZip(file, m_SaveFile.GetNameExtension().c_str(), nullptr, nullptr, 0, nullptr, 0, nullptr, Method, Level) == ZIP_OK &&
+        zipWriteInFileInZip(file, m_State.Data(), m_State.Length()) == ZIP_OK &&
+        zipCloseFileInZip(file) == ZIP_OK &&
+        zipOpenNewFileInZip(file, m_ExtraInfoFile.GetNameExtension().c_str(), nullptr, nullptr, 0, nullptr, 0, nullptr, Method, Level) == ZIP_OK &&
+        zipWriteInFileInZip(file, m_ExtraInfo.Data(), m_ExtraInfo.Length()) == ZIP_OK &&
+        zipCloseFileInZip(file) == ZIP_OK;
+    if (zipClose(file, "") != ZIP_OK)
+    {
+        Saved = false;
+    }
+
+    if (!Saved || !TempFile.MoveTo(m_ZipFile))
+    {
+        TempFile.Delete();
+        return false;
+    }
+#if defined(ANDROID)
+    utimes((const char *)m_ZipFile, nullptr);
+#endif
+    return true;
+}
+
+bool CSaveStateWriter::WriteFile(const CPath & FileName, const CSaveStateBuffer & Buffer)
+{
+    CPath TempFile(FileName);
+    TempFile.SetNameExtension(stdstr_f("%s.tmp", FileName.GetNameExtension().c_str()).c_str());
+
+    CFile hFile(TempFile, CFileBase::modeWrite | CFileBase::modeCreate);
+    if (!hFile.IsOpen() || !hFile.Write(Buffer.Data(), Buffer.Length()) || !hFile.Flush())
+    {
+        hFile.Close();
+        TempFile.Delete();
+        return false;
+    }
+    hFile.Close();
+
+    if (!TempFile.MoveTo(FileName))
+    {
+        TempFile.Delete();
+        return false;
+    }
+    return true;
+}
+
+void CSaveStateWriter::WriterThread()
+{
+    WriteTrace(TraceN64System, TraceDebug, "Start");
+    while (!m_WriterThreadEnd)
+    {
+        if (!m_WriteEvent.IsTriggered(SyncEvent::INFINITE_TIMEOUT) || m_WriterThreadEnd)
+        {
+            continue;
+        }
+
+        HighResTimeStamp StartTime, EndTime;
+        StartTime.SetToNow();
+        bool Zip = !((const std::string &)m_ZipFile).empty();
+        bool Saved = Zip ? WriteZip() : WriteFile(m_SaveFile, m_State) && WriteFile(m_ExtraInfoFile, m_ExtraInfo);
+        EndTime.SetToNow();
+
+        if (Saved)
+        {
+            const CPath & SaveFile = Zip ? m_ZipFile : m_SaveFile;
+            WriteTrace(TraceN64System, TraceDebug, "Wrote %s (%d bytes) in %d ms", (const char *)SaveFile, m_State.Length() + m_ExtraInfo.Length(), (uint32_t)((EndTime.GetMicroSeconds() - StartTime.GetMicroSeconds()) / 1000));
+            g_Notify->DisplayMessage(3, stdstr_f("%s %s", g_Lang->GetString(MSG_SAVED_STATE).c_str(), stdstr(SaveFile.GetNameExtension()).c_str()).c_str());
+        }
+        else
+        {
+            WriteTrace(TraceN64System, TraceError, "Failed to write %s", (const char *)(Zip ? m_ZipFile : m_SaveFile));
+            g_Notify->DisplayError(GS(MSG_FAIL_OPEN_SAVE));
+        }
+        m_IdleEvent.Trigger();
+    }
+    WriteTrace(TraceN64System, TraceDebug, "Done");
+}
@@ -0,0 +1,80 @@
+#pragma once
+#include <Project64-core/N64System/N64Types.h>
+#include <Common/path.h>
+#include <Common/Thread.h>
+#include <Common/SyncEvent.h>
+#include <vector>
+#include <string.h>
+
+// Save state serialised in memory, written and read with the same calls as a CFile. The
+// buffer is kept between saves so after the first save filling it is a plain copy with no
+// allocation.
+class CSaveStateBuffer
+{
+public:
+    CSaveStateBuffer() : m_ReadPos(0) {}
+
+    void Clear() { m_Data.clear(); m_ReadPos = 0; }
+    void SetLength(uint32_t Length) { m_Data.resize(Length); m_ReadPos = 0; }
+    void Write(const void * Data, uint32_t Length) { m_Data.insert(m_Data.end(), (const uint8_t *)Data, (const uint8_t *)Data + Length); }
+
+    void SeekToBegin() { m_ReadPos = 0; }
+    uint32_t Read(void * Data, uint32_t Length)
+    {
+        uint32_t Available = Length < this->Length() - m_ReadPos ? Length : this->Length() - m_ReadPos;
+        if (Available != 0)
+        {
+            memcpy(Data, &m_Data[m_ReadPos], Available);
+            m_ReadPos += Available;
+        }
+        return Available;
+    }
+
+    uint8_t * Data() { return m_Data.empty() ? nullptr : &m_Data[0]; }
+    const uint8_t * Data() const { return m_Data.empty() ? nullptr : &m_Data[0]; }
+    uint32_t Length() const { return (uint32_t)m_Data.size(); }
+
+private:
+    std::vector<uint8_t> m_Data;
+    uint32_t m_ReadPos;
+};
+
+// Compresses and writes save states on a background thread so the emulation thread only
+// pays for copying the state into memory. Files are written under a temporary name and
+// moved over the old state once complete, a failed save leaves the previous one intact.
+class CSaveStateWriter
+{
+public:
+    CSaveStateWriter();
+    ~CSaveStateWriter();
+
+    // Waits for any state still being written, then hands out the buffers for the next one
+    CSaveStateBuffer & State();
+    CSaveStateBuffer & ExtraInfo();
+
+    // Queues the filled buffers, ZipFile is empty to write plain .pj and .dat files
+    void Commit(const CPath & SaveFile, const CPath & ExtraInfoFile, const CPath & ZipFile, SAVE_STATE_COMPRESSION Compression);
+
+    // Blocks until the last committed state is on disk
+    void WaitForIdle();
+
+private:
+    CSaveStateWriter(const CSaveStateWriter&);
+    CSaveStateWriter& operator=(const CSaveStateWriter&);
+
+    bool WriteZip();
+    bool WriteFile(const CPath & FileName, const CSaveStateBuffer & Buffer);
+    void WriterThread();
+    static uint32_t stWriterThread(void * lpThreadParameter) { ((CSaveStateWriter *)lpThreadParameter)->WriterThread(); return 0; }
+
+    CSaveStateBuffer m_State;
+    CSaveStateBuffer m_ExtraInfo;
+    CPath m_SaveFile;
+    CPath m_ExtraInfoFile;
+    CPath m_ZipFile;
+    SAVE_STATE_COMPRESSION m_Compression;
+    CThread m_WriterThread;
+    SyncEvent m_WriteEvent;
+    SyncEvent m_IdleEvent;
+    volatile bool m_WriterThreadEnd;
+};
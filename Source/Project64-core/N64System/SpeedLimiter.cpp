@@ -2,13 +2,27 @@
 #include "Project64-core/N64System/SpeedLimiter.h"
 
 #include <Common/Util.h>
+#ifndef _WIN32
+#include <time.h>
+#include <errno.h>
+#endif
 
 const uint32_t CSpeedLimiter::m_DefaultSpeed = 60;
 
+enum
+{
+    MinSpinTime = 200, // Microseconds
+    MaxSpinTime = 4000,
+    MaxFramesBehind = 4,
+};
+
 CSpeedLimiter::CSpeedLimiter() :
 m_Frames(0),
 m_Speed(m_DefaultSpeed),
-m_BaseSpeed(m_DefaultSpeed)
+m_BaseSpeed(m_DefaultSpeed),
+m_PaceStart(0),
+m_PacedFrames(0),
+m_SpinTime(MinSpinTime)
 {
 }
 
@@ -25,8 +39,9 @@ void CSpeedLimiter::SetHertz(uint32_t Hertz)
 
 void CSpeedLimiter::FixSpeedRatio()
 {
-    m_MicroSecondsPerFrame = 1000000 / m_Speed;
     m_Frames = 0;
+    m_LastTime.SetMicroSeconds(0);
+    m_PaceStart = 0;
 }
 
 bool CSpeedLimiter::Timer_Process(uint32_t * FrameRate)
@@ -41,16 +56,23 @@ bool CSpeedLimiter::Timer_Process(uint32_t * FrameRate)
     {
         m_Frames = 0;
         m_LastTime = CurrentTime;
+        m_PaceStart = CurrentTimeValue;
+        m_PacedFrames = 0;
         return true;
     }
-    uint64_t CalculatedTime = LastTime + (m_MicroSecondsPerFrame * m_Frames);
-    if (CurrentTimeValue < CalculatedTime)
+
+    // Start pacing again from now when too far behind, rather than running fast to catch up
+    m_PacedFrames += 1;
+    uint64_t CalculatedTime = m_PaceStart + ((uint64_t)m_PacedFrames * 1000000) / m_Speed;
+    if (CurrentTimeValue > CalculatedTime + (uint64_t)MaxFramesBehind * 1000000 / m_Speed)
     {
-        int32_t time = (int)(CalculatedTime - CurrentTimeValue);
-        if (time > 0)
-        {
-            pjutil::Sleep((time / 1000) + 1);
-        }
+        m_PaceStart = CurrentTimeValue;
+        m_PacedFrames = 0;
+    }
+    else if (CurrentTimeValue < CalculatedTime)
+    {
+        WaitUntil(CalculatedTime);
+
         // Refresh current time
         CurrentTime.SetToNow();
         CurrentTimeValue = CurrentTime.GetMicroSeconds();
@@ -66,6 +88,35 @@ bool CSpeedLimiter::Timer_Process(uint32_t * FrameRate)
     return false;
 }
 
+void CSpeedLimiter::WaitUntil(uint64_t Deadline)
+{
+    HighResTimeStamp Now;
+    uint64_t SleepUntil = Deadline - m_SpinTime;
+    if ((uint64_t)Now.SetToNow().GetMicroSeconds() < SleepUntil)
+    {
+#ifdef _WIN32
+        pjutil::Sleep((uint32_t)((SleepUntil - Now.GetMicroSeconds()) / 1000));
+#else
+        // HighResTimeStamp reads CLOCK_MONOTONIC, so the deadline can be slept to directly
+        struct timespec WakeTime;
+        WakeTime.tv_sec = (time_t)(SleepUntil / 1000000);
+        WakeTime.tv_nsec = (long)(SleepUntil % 1000000) * 1000;
+        while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &WakeTime, nullptr) == EINTR)
+        {
+        }
+#endif
+        // Move the spin time towards how late the sleep returned, so the next sleep ends just
+        // before its deadline
+        int64_t Late = (int64_t)(Now.SetToNow().GetMicroSeconds() - SleepUntil);
+        m_SpinTime += (Late + MinSpinTime - m_SpinTime) / 8;
+        if (m_SpinTime < MinSpinTime) { m_SpinTime = MinSpinTime; }
+        if (m_SpinTime > MaxSpinTime) { m_SpinTime = MaxSpinTime; }
+    }
+    while (Now.SetToNow().GetMicroSeconds() < Deadline)
+    {
+    }
+}
+
 void CSpeedLimiter::AlterSpeed( const ESpeedChange SpeedChange )
 {
 	int32_t SpeedFactor = 1;
@@ -27,10 +27,20 @@ private:
     CSpeedLimiter& operator=(const CSpeedLimiter&);
 
     void FixSpeedRatio();
+    void WaitUntil(uint64_t Deadline);
 
 	HighResTimeStamp m_LastTime;
 
-    uint32_t m_Speed, m_BaseSpeed, m_Frames, m_MicroSecondsPerFrame;
+    uint32_t m_Speed, m_BaseSpeed, m_Frames;
+
+    // Frames are paced against absolute deadlines counted from m_PaceStart, so rounding in
+    // the frame length never builds up into drift
+    uint64_t m_PaceStart;
+    uint32_t m_PacedFrames;
+
+    // How long before a deadline to stop sleeping and spin, learnt from how late the OS
+    // wakes the thread
+    int64_t m_SpinTime;
 
 	static const uint32_t m_DefaultSpeed;
 };
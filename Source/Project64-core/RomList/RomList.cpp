@@ -3,6 +3,9 @@
 #include <Project64-core/3rdParty/zip.h>
 #include <Project64-core/N64System/N64Rom.h>
 #include <Project64-core/N64System/N64Disk.h>
+#include <Common/ByteSwap.h>
+#include <Common/Util.h>
+#include <sys/stat.h>
 
 #ifdef _WIN32
 #include <Project64-core/3rdParty/7zip.h>
@@ -36,7 +39,9 @@ CRomList::CRomList() :
 #ifdef _WIN32
     m_ZipIniFile(nullptr),
 #endif
-    m_RomIniFile(nullptr)
+    m_RomIniFile(nullptr),
+    m_ScanWork(true),
+    m_ScanDone(false)
 {
     WriteTrace(TraceRomList, TraceVerbose, "Start");
     if (g_Settings)
@@ -113,32 +118,198 @@ void CRomList::RefreshRomListThread(void)
     RomListReset();
     m_RomInfo.clear();
 
+    LoadRomIndex();
+    m_NewRomIndex.clear();
+    StartScanThreads();
+
     strlist FileNames;
     FillRomList(FileNames, "");
+    FinishScan();
     RomListLoaded();
     SaveRomList(FileNames);
+    SaveRomIndex();
     WriteTrace(TraceRomList, TraceVerbose, "Done");
 }
 
-void CRomList::AddRomToList(const char * RomLocation)
+static bool RomFileStamp(const char * FileName, uint64_t & Size, uint64_t & ModifiedTime)
+{
+#ifdef _WIN32
+    struct _stat64 FileStat;
+    if (_stat64(FileName, &FileStat) != 0)
+#else
+    struct stat FileStat;
+    if (stat(FileName, &FileStat) != 0)
+#endif
+    {
+        return false;
+    }
+    Size = (uint64_t)FileStat.st_size;
+    ModifiedTime = (uint64_t)FileStat.st_mtime;
+    return true;
+}
+
+void CRomList::AddRomToList(const ROM_INFO & RomInfo)
+{
+    int32_t ListPos = m_RomInfo.size();
+    m_RomInfo.push_back(RomInfo);
+    RomAddedToList(ListPos);
+}
+
+void CRomList::QueueRomFile(const char * RomLocation)
 {
     WriteTrace(TraceRomList, TraceVerbose, "Start (RomLocation: \"%s\")", RomLocation);
-    ROM_INFO RomInfo = { 0 };
+    uint64_t FileSize, ModifiedTime;
+    ROM_INDEX::const_iterator itr = m_RomIndex.find(RomLocation);
+    if (itr != m_RomIndex.end() && RomFileStamp(RomLocation, FileSize, ModifiedTime) &&
+        itr->second.FileSize == FileSize && itr->second.ModifiedTime == ModifiedTime)
+    {
+        WriteTrace(TraceRomList, TraceVerbose, "Unchanged since last scan (Valid: %s)", itr->second.Valid ? "true" : "false");
+        m_NewRomIndex[itr->first] = itr->second;
+        if (itr->second.Valid)
+        {
+            // The file name and database details can change without the file changing
+            ROM_INFO RomInfo = itr->second.RomInfo;
+            FillRomFileName(&RomInfo);
+            FillRomExtensionInfo(&RomInfo);
+            AddRomToList(RomInfo);
+        }
+        WriteTrace(TraceRomList, TraceVerbose, "Done");
+        return;
+    }
 
-    strncpy(RomInfo.szFullFileName, RomLocation, (sizeof(RomInfo.szFullFileName) / sizeof(RomInfo.szFullFileName[0])) - 1);
-    if (FillRomInfo(&RomInfo))
+    CGuard Guard(m_ScanCS);
+    m_ScanQueue.push_back(RomLocation);
+    m_ScanWork.Trigger();
+    WriteTrace(TraceRomList, TraceVerbose, "Done");
+}
+
+void CRomList::AddScannedRoms(void)
+{
+    SCAN_RESULTS Results;
     {
-        int32_t ListPos = m_RomInfo.size();
-        m_RomInfo.push_back(RomInfo);
-        RomAddedToList(ListPos);
+        CGuard Guard(m_ScanCS);
+        Results.swap(m_ScanResults);
     }
-    else
+    for (SCAN_RESULTS::const_iterator itr = Results.begin(); itr != Results.end(); itr++)
     {
-        WriteTrace(TraceRomList, TraceVerbose, "Failed to fill ROM information, ignoring");
+        if (itr->FileSize != 0)
+        {
+            m_NewRomIndex[itr->RomInfo.szFullFileName] = *itr;
+        }
+        if (itr->Valid)
+        {
+            AddRomToList(itr->RomInfo);
+        }
+        else
+        {
+            WriteTrace(TraceRomList, TraceVerbose, "Failed to fill ROM information for \"%s\", ignoring", itr->RomInfo.szFullFileName);
+        }
     }
+}
+
+void CRomList::StartScanThreads(void)
+{
+    uint32_t ThreadCount = g_Settings->LoadDword(RomList_ScanThreads);
+    if (ThreadCount == 0)
+    {
+        ThreadCount = 1;
+    }
+    WriteTrace(TraceRomList, TraceDebug, "Starting %d scan threads", ThreadCount);
+
+    m_ScanDone = false;
+    m_ScanWork.Reset();
+    for (uint32_t i = 0; i < ThreadCount; i++)
+    {
+        CThread * Thread = new CThread((CThread::CTHREAD_START_ROUTINE)stScanThread);
+        Thread->Start((void *)this);
+        m_ScanThreads.push_back(Thread);
+    }
+}
+
+void CRomList::FinishScan(void)
+{
+    WriteTrace(TraceRomList, TraceVerbose, "Start");
+    {
+        CGuard Guard(m_ScanCS);
+        m_ScanDone = true;
+        m_ScanWork.Trigger();
+    }
+
+    for (;;)
+    {
+        bool Running = false;
+        for (size_t i = 0; i < m_ScanThreads.size(); i++)
+        {
+            if (m_ScanThreads[i]->isRunning())
+            {
+                Running = true;
+                break;
+            }
+        }
+        AddScannedRoms();
+        if (!Running)
+        {
+            break;
+        }
+        pjutil::Sleep(10);
+    }
+
+    for (size_t i = 0; i < m_ScanThreads.size(); i++)
+    {
+        delete m_ScanThreads[i];
+    }
+    m_ScanThreads.clear();
+    m_ScanQueue.clear();
     WriteTrace(TraceRomList, TraceVerbose, "Done");
 }
 
+void CRomList::ScanThread(void)
+{
+    WriteTrace(TraceRomList, TraceDebug, "Start");
+    for (;;)
+    {
+        std::string RomLocation;
+        {
+            CGuard Guard(m_ScanCS);
+            if (m_ScanQueue.empty())
+            {
+                if (m_ScanDone || m_StopRefresh)
+                {
+                    break;
+                }
+                m_ScanWork.Reset();
+            }
+            else
+            {
+                RomLocation = m_ScanQueue.front();
+                m_ScanQueue.pop_front();
+            }
+        }
+        if (RomLocation.empty())
+        {
+            m_ScanWork.IsTriggered(100);
+            continue;
+        }
+        if (m_StopRefresh)
+        {
+            continue;
+        }
+
+        ROM_INDEX_ENTRY Entry;
+        memset(&Entry, 0, sizeof(Entry));
+        strncpy(Entry.RomInfo.szFullFileName, RomLocation.c_str(), (sizeof(Entry.RomInfo.szFullFileName) / sizeof(Entry.RomInfo.szFullFileName[0])) - 1);
+        Entry.Valid = FillRomInfo(&Entry.RomInfo);
+        if (!RomFileStamp(RomLocation.c_str(), Entry.FileSize, Entry.ModifiedTime))
+        {
+            Entry.FileSize = 0;
+        }
+
+        CGuard Guard(m_ScanCS);
+        m_ScanResults.push_back(Entry);
+    }
+    WriteTrace(TraceRomList, TraceDebug, "Done");
+}
+
 void CRomList::FillRomList(strlist & FileList, const char * Directory)
 {
     WriteTrace(TraceRomList, TraceDebug, "Start (m_GameDir = %s, Directory: %s)", (const char *)m_GameDir, Directory);
@@ -185,7 +356,7 @@ void CRomList::FillRomList(strlist & FileList, const char * Directory)
             WriteTrace(TraceRomList, TraceVerbose, "File has matching extension: \"%s\"", ROM_extensions[i]);
             if (Extension != "7z")
             {
-                AddRomToList(SearchDir);
+                QueueRomFile(SearchDir);
             }
 #ifdef _WIN32
             else
@@ -303,9 +474,7 @@ void CRomList::FillRomList(strlist & FileList, const char * Directory)
                         FillRomExtensionInfo(&RomInfo);
 
                         WriteTrace(TraceUserInterface, TraceDebug, "17");
-                        int32_t ListPos = m_RomInfo.size();
-                        m_RomInfo.push_back(RomInfo);
-                        RomAddedToList(ListPos);
+                        AddRomToList(RomInfo);
                     }
                 }
                 catch (...)
@@ -316,6 +485,7 @@ void CRomList::FillRomList(strlist & FileList, const char * Directory)
 #endif
             break;
         }
+        AddScannedRoms();
     } while (SearchDir.FindNext());
 #ifdef _WIN32
     m_ZipIniFile->FlushChanges();
@@ -507,14 +677,7 @@ bool CRomList::FillRomInfo(ROM_INFO * pRomInfo)
 
     if (LoadDataFromRomFile(pRomInfo->szFullFileName, RomData, sizeof(RomData), &pRomInfo->RomSize, pRomInfo->FileFormat))
     {
-        if (strstr(pRomInfo->szFullFileName, "?") != nullptr)
-        {
-            strcpy(pRomInfo->FileName, strstr(pRomInfo->szFullFileName, "?") + 1);
-        }
-        else
-        {
-            strncpy(pRomInfo->FileName, g_Settings->LoadBool(RomList_ShowFileExtensions) ? CPath(pRomInfo->szFullFileName).GetNameExtension().c_str() : CPath(pRomInfo->szFullFileName).GetName().c_str(), sizeof(pRomInfo->FileName) / sizeof(pRomInfo->FileName[0]));
-        }
+        FillRomFileName(pRomInfo);
 
         if ((CPath(pRomInfo->szFullFileName).GetExtension() != "ndd") && (CPath(pRomInfo->szFullFileName).GetExtension() != "d64"))
         {
@@ -562,6 +725,18 @@ bool CRomList::FillRomInfo(ROM_INFO * pRomInfo)
     return false;
 }
 
+void CRomList::FillRomFileName(ROM_INFO * pRomInfo)
+{
+    if (strstr(pRomInfo->szFullFileName, "?") != nullptr)
+    {
+        strcpy(pRomInfo->FileName, strstr(pRomInfo->szFullFileName, "?") + 1);
+    }
+    else
+    {
+        strncpy(pRomInfo->FileName, g_Settings->LoadBool(RomList_ShowFileExtensions) ? CPath(pRomInfo->szFullFileName).GetNameExtension().c_str() : CPath(pRomInfo->szFullFileName).GetName().c_str(), sizeof(pRomInfo->FileName) / sizeof(pRomInfo->FileName[0]));
+    }
+}
+
 void CRomList::FillRomExtensionInfo(ROM_INFO * pRomInfo)
 {
     // Initialize the structure
@@ -633,38 +808,20 @@ void CRomList::FillRomExtensionInfo(ROM_INFO * pRomInfo)
 
 void CRomList::ByteSwapRomData(uint8_t * Data, int32_t DataLen)
 {
-    int32_t count;
-
     switch (*((uint32_t *)&Data[0]))
     {
     case 0x12408037:
     case 0x07408027: // 64DD IPL
     case 0xD316E848: // 64DD JP disk
     case 0xEE562263: // 64DD US disk
-        for (count = 0; count < DataLen; count += 4)
-        {
-            Data[count] ^= Data[count + 2];
-            Data[count + 2] ^= Data[count];
-            Data[count] ^= Data[count + 2];
-            Data[count + 1] ^= Data[count + 3];
-            Data[count + 3] ^= Data[count + 1];
-            Data[count + 1] ^= Data[count + 3];
-        }
+        HalfSwap32(Data, DataLen);
         break;
     case 0x40072780: // 64DD IPL
     case 0x16D348E8: // 64DD JP disk
     case 0x56EE6322: // 64DD US disk
     case 0x40123780:
     case 0x00000000: // 64DD DEV disk
-        for (count = 0; count < DataLen; count += 4)
-        {
-            Data[count] ^= Data[count + 3];
-            Data[count + 3] ^= Data[count];
-            Data[count] ^= Data[count + 3];
-            Data[count + 1] ^= Data[count + 2];
-            Data[count + 2] ^= Data[count + 1];
-            Data[count + 1] ^= Data[count + 2];
-        }
+        ByteSwap32(Data, DataLen);
         break;
     case 0x80371240:
     case 0x80270740: // 64DD IPL
@@ -751,6 +908,66 @@ void CRomList::SaveRomList(strlist & FileList)
     file.Close();
 }
 
+// LoadRomIndex/SaveRomIndex - what was read from each ROM file, with the size and time
+// stamp of the file when it was read, so a refresh only opens files that have changed
+
+void CRomList::LoadRomIndex(void)
+{
+    WriteTrace(TraceRomList, TraceVerbose, "Start");
+    m_RomIndex.clear();
+
+    CPath FileName(g_Settings->LoadStringVal(RomList_RomIndexCache));
+    CFile file(FileName, CFileBase::modeRead | CFileBase::modeNoTruncate);
+    if (!file.IsOpen())
+    {
+        WriteTrace(TraceRomList, TraceVerbose, "No index");
+        return;
+    }
+
+    int32_t EntrySize = 0, Entries = 0;
+    if (!file.Read(&EntrySize, sizeof(EntrySize)) || EntrySize != sizeof(ROM_INDEX_ENTRY) ||
+        !file.Read(&Entries, sizeof(Entries)))
+    {
+        WriteTrace(TraceRomList, TraceVerbose, "Index is from a different version, ignoring");
+        return;
+    }
+    for (int32_t count = 0; count < Entries; count++)
+    {
+        ROM_INDEX_ENTRY Entry;
+        if (file.Read(&Entry, EntrySize) != (uint32_t)EntrySize)
+        {
+            break;
+        }
+        Entry.RomInfo.szFullFileName[sizeof(Entry.RomInfo.szFullFileName) - 1] = '\0';
+        m_RomIndex[Entry.RomInfo.szFullFileName] = Entry;
+    }
+    WriteTrace(TraceRomList, TraceVerbose, "Done (Entries: %d)", (int32_t)m_RomIndex.size());
+}
+
+void CRomList::SaveRomIndex(void)
+{
+    if (m_StopRefresh)
+    {
+        // Files not reached would be dropped from the index
+        return;
+    }
+    CPath FileName(g_Settings->LoadStringVal(RomList_RomIndexCache));
+    CFile file(FileName, CFileBase::modeWrite | CFileBase::modeCreate);
+
+    int32_t EntrySize = sizeof(ROM_INDEX_ENTRY);
+    file.Write(&EntrySize, sizeof(EntrySize));
+    int32_t Entries = m_NewRomIndex.size();
+    file.Write(&Entries, sizeof(Entries));
+    for (ROM_INDEX::const_iterator itr = m_NewRomIndex.begin(); itr != m_NewRomIndex.end(); itr++)
+    {
+        file.Write(&itr->second, EntrySize);
+    }
+    file.Close();
+
+    m_RomIndex.swap(m_NewRomIndex);
+    m_NewRomIndex.clear();
+}
+
 MD5 CRomList::RomListHash(strlist & FileList)
 {
     stdstr NewFileNames;
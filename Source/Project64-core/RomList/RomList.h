@@ -4,7 +4,11 @@
 #include <Common/StdString.h>
 #include <Common/md5.h>
 #include <Common/Thread.h>
+#include <Common/SyncEvent.h>
+#include <Common/CriticalSection.h>
 #include <Project64-core/N64System/N64Types.h>
+#include <map>
+#include <list>
 
 class CRomList
 {
@@ -64,9 +68,29 @@ protected:
     bool m_StopRefresh;
 
 private:
-    void AddRomToList(const char * RomLocation);
+    // What was read from a ROM file, kept between runs so files that have not changed since
+    // are not opened again
+    struct ROM_INDEX_ENTRY
+    {
+        uint64_t FileSize;
+        uint64_t ModifiedTime;
+        bool Valid;
+        ROM_INFO RomInfo;
+    };
+    typedef std::map<std::string, ROM_INDEX_ENTRY> ROM_INDEX;
+    typedef std::list<ROM_INDEX_ENTRY> SCAN_RESULTS;
+
+    void AddRomToList(const ROM_INFO & RomInfo);
+    void QueueRomFile(const char * RomLocation);
+    void AddScannedRoms(void);
+    void StartScanThreads(void);
+    void FinishScan(void);
+    void ScanThread(void);
+    void LoadRomIndex(void);
+    void SaveRomIndex(void);
     void FillRomList(strlist & FileList, const char * Directory);
     bool FillRomInfo(ROM_INFO * pRomInfo);
+    void FillRomFileName(ROM_INFO * pRomInfo);
     void FillRomExtensionInfo(ROM_INFO * pRomInfo);
     bool LoadDataFromRomFile(const char * FileName, uint8_t * Data, int32_t DataLen, int32_t * RomSize, FILE_FORMAT & FileFormat);
     void SaveRomList(strlist & FileList);
@@ -75,6 +99,7 @@ private:
     static void RefreshSettings(CRomList *);
     static void NotificationCB(const char * Status, CRomList * _this);
     static void RefreshRomListStatic(CRomList * _this);
+    static uint32_t stScanThread(void * lpThreadParameter) { ((CRomList *)lpThreadParameter)->ScanThread(); return 0; }
     static void ByteSwapRomData(uint8_t * Data, int32_t DataLen);
 
     CPath  m_GameDir;
@@ -85,6 +110,16 @@ private:
     CIniFile * m_ZipIniFile;
 #endif
     CThread m_RefreshThread;
+
+    // Files not in the index are read by a pool of scan threads, the refresh thread adds
+    // their results to the list as they come in
+    ROM_INDEX m_RomIndex, m_NewRomIndex;
+    std::vector<CThread *> m_ScanThreads;
+    std::list<std::string> m_ScanQueue;
+    SCAN_RESULTS m_ScanResults;
+    CriticalSection m_ScanCS;
+    SyncEvent m_ScanWork;
+    bool m_ScanDone;
     CIniFileBase::SectionList m_GameIdentifiers;
 
     #define DISKSIZE_MAME 0x0435B0C0
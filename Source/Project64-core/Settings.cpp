@@ -107,6 +107,12 @@ void CSettings::AddHowToHandleSetting(const char * BaseDirectory)
     AddHandler(Setting_CN64TimeCritical, new CSettingTypeApplication("Settings", "CN64TimeCritical", false));
     AddHandler(Setting_AutoStart, new CSettingTypeApplication("Settings", "Auto Start", (uint32_t)true));
     AddHandler(Setting_AutoZipInstantSave, new CSettingTypeApplication("Settings", "Auto Zip Saves", (uint32_t)true));
+    AddHandler(Setting_IncrementalSaveStates, new CSettingTypeApplication("Settings", "Incremental Save States", false));
+    AddHandler(Setting_SaveStateCompression, new CSettingTypeApplication("Settings", "Save State Compression", (uint32_t)SaveStateCompression_Fast));
+    AddHandler(Setting_Rewind, new CSettingTypeApplication("Settings", "Rewind", false));
+    AddHandler(Setting_RewindInterval, new CSettingTypeApplication("Settings", "Rewind Interval", (uint32_t)6));
+    AddHandler(Setting_RewindBufferSize, new CSettingTypeApplication("Settings", "Rewind Buffer Size", (uint32_t)128));
+    AddHandler(Setting_MapRomFile, new CSettingTypeApplication("Settings", "Map ROM File", false));
     AddHandler(Setting_EraseGameDefaults, new CSettingTypeApplication("Settings", "Erase on default", (uint32_t)true));
     AddHandler(Setting_CheckEmuRunning, new CSettingTypeApplication("Settings", "Check Running", (uint32_t)true));
 #ifndef _M_X64
@@ -115,6 +121,11 @@ void CSettings::AddHowToHandleSetting(const char * BaseDirectory)
     AddHandler(Setting_ForceInterpreterCPU, new CSettingTypeApplication("Settings", "Force Interpreter CPU", true));
 #endif
     AddHandler(Setting_FixedRdramAddress, new CSettingTypeApplication("Settings", "Fixed Rdram Address", (uint32_t)0));
+    AddHandler(Setting_CodeCacheSize, new CSettingTypeApplication("Settings", "Code Cache Size", (uint32_t)60));
+    AddHandler(Setting_BackgroundCompile, new CSettingTypeApplication("Settings", "Background Compile", false));
+    AddHandler(Setting_BlockChaining, new CSettingTypeApplication("Settings", "Block Chaining", false));
+    AddHandler(Setting_BenchmarkFrames, new CSettingTypeTempNumber(0));
+    AddHandler(Setting_BenchmarkCycles, new CSettingTypeTempNumber(0));
     AddHandler(Setting_Enhancement, new CSettingTypeApplication("Settings", "Enable Enhancement", (uint32_t)true));
     
 	AddHandler(Setting_RememberCheats, new CSettingTypeApplication("Settings", "Remember Cheats", (bool)false));
@@ -307,6 +318,9 @@ void CSettings::AddHowToHandleSetting(const char * BaseDirectory)
     AddHandler(RomList_ShowFileExtensions, new CSettingTypeApplication("Game Directory", "File Extensions", false));
     AddHandler(RomList_7zipCache, new CSettingTypeApplicationPath("Settings", "7zipCache", RomList_7zipCacheDefault));
     AddHandler(RomList_7zipCacheDefault, new CSettingTypeRelativePath("Config", "Project64.zcache"));
+    AddHandler(RomList_RomIndexCache, new CSettingTypeApplicationPath("Settings", "RomIndexCache", RomList_RomIndexCacheDefault));
+    AddHandler(RomList_RomIndexCacheDefault, new CSettingTypeRelativePath("Config", "Project64.rindex"));
+    AddHandler(RomList_ScanThreads, new CSettingTypeApplication("Settings", "Rom List Scan Threads", (uint32_t)8));
 
     AddHandler(GameRunning_LoadingInProgress, new CSettingTypeTempBool(false));
     AddHandler(GameRunning_CPU_Running, new CSettingTypeTempBool(false));
@@ -330,6 +344,7 @@ void CSettings::AddHowToHandleSetting(const char * BaseDirectory)
     AddHandler(Debugger_ShowDListAListCount, new CSettingTypeApplication("Debugger", "Show Dlist Alist Count", false));
     AddHandler(Debugger_ShowRecompMemSize, new CSettingTypeApplication("Debugger", "Show Recompiler Memory size", false));
     AddHandler(Debugger_RecordExecutionTimes, new CSettingTypeApplication("Debugger", "Record Execution Times", false));
+    AddHandler(Debugger_BlockProfiler, new CSettingTypeApplication("Debugger", "Block Profiler", false));
     AddHandler(Debugger_SteppingOps, new CSettingTypeTempBool(false));
     AddHandler(Debugger_SkipOp, new CSettingTypeTempBool(false));
     AddHandler(Debugger_HaveExecutionBP, new CSettingTypeTempBool(false));
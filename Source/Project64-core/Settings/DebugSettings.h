@@ -17,6 +17,7 @@ public:
     static inline bool bShowTLBMisses(void) { return m_bShowTLBMisses; }
     static inline bool bShowDivByZero(void) { return m_bShowDivByZero; }
     static inline bool bRecordExecutionTimes(void) { return m_RecordExecutionTimes; }
+    static inline bool bBlockProfiler(void) { return m_BlockProfiler; }
     static inline bool HaveExecutionBP(void) { return m_HaveExecutionBP; }
     static inline bool HaveWriteBP(void) { return m_HaveWriteBP; }
     static inline bool HaveReadBP(void) { return m_HaveReadBP; }
@@ -45,6 +46,7 @@ private:
     static bool m_bShowTLBMisses;
     static bool m_bShowDivByZero;
     static bool m_RecordExecutionTimes;
+    static bool m_BlockProfiler;
     static bool m_HaveExecutionBP;
     static bool m_HaveWriteBP;
     static bool m_HaveReadBP;
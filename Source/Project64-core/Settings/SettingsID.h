@@ -49,8 +49,19 @@ enum SettingID
     Setting_EraseGameDefaults,
     Setting_ForceInterpreterCPU,
     Setting_FixedRdramAddress,
+    Setting_CodeCacheSize,
+    Setting_BackgroundCompile,
+    Setting_BlockChaining,
+    Setting_BenchmarkFrames,
+    Setting_BenchmarkCycles,
 
     Setting_AutoZipInstantSave,
+    Setting_IncrementalSaveStates,
+    Setting_SaveStateCompression,
+    Setting_Rewind,
+    Setting_RewindInterval,
+    Setting_RewindBufferSize,
+    Setting_MapRomFile,
     Setting_RememberCheats,
     Setting_UniqueSaveDir,
     Setting_LanguageDir,
@@ -232,6 +243,9 @@ enum SettingID
     RomList_ShowFileExtensions,
     RomList_7zipCache,
     RomList_7zipCacheDefault,
+    RomList_RomIndexCache,
+    RomList_RomIndexCacheDefault,
+    RomList_ScanThreads,
 
     // File info
     File_DiskIPLPath,
@@ -252,6 +266,7 @@ enum SettingID
     Debugger_ShowRecompMemSize,
     Debugger_DebugLanguage,
     Debugger_RecordExecutionTimes,
+    Debugger_BlockProfiler,
     Debugger_SteppingOps,
     Debugger_SkipOp,
     Debugger_HaveExecutionBP,
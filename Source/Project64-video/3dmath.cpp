@@ -10,6 +10,12 @@ extern "C" {
 #include <xmmintrin.h>
 #endif
 }
+#if defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#define VERTEX_BATCH_NEON
+#elif !defined(NOSSE) && (defined(__SSE__) || defined(_M_IX86) || defined(_M_X64))
+#define VERTEX_BATCH_SSE
+#endif
 
 #ifdef _WIN32
 #include <Windows.h>
@@ -350,6 +356,258 @@ void MulMatricesSSE(float m1[4][4], float m2[4][4], float r[4][4])
 #endif // _WIN32
 }
 
+void load_vertex_batch(VERTEX_BATCH &batch, uint32_t addr, int n, bool normals)
+{
+    int i;
+    for (i = 0; i < n; i++, addr += 16)
+    {
+        batch.x[i] = (float)((short*)gfx.RDRAM)[((addr >> 1) + 0) ^ 1];
+        batch.y[i] = (float)((short*)gfx.RDRAM)[((addr >> 1) + 1) ^ 1];
+        batch.z[i] = (float)((short*)gfx.RDRAM)[((addr >> 1) + 2) ^ 1];
+        if (normals)
+        {
+            batch.nx[i] = ((char*)gfx.RDRAM)[(addr + 12) ^ 3];
+            batch.ny[i] = ((char*)gfx.RDRAM)[(addr + 13) ^ 3];
+            batch.nz[i] = ((char*)gfx.RDRAM)[(addr + 14) ^ 3];
+        }
+    }
+    // Pad to a whole group of four so the kernels never read uninitialized lanes
+    for (; (i & 3) != 0; i++)
+    {
+        batch.x[i] = batch.y[i] = batch.z[i] = 0.0f;
+        batch.nx[i] = batch.ny[i] = batch.nz[i] = 0.0f;
+    }
+}
+
+void TransformVerticesC(VERTEX_BATCH &batch, int n, float mat[4][4])
+{
+    for (int i = 0; i < n; i++)
+    {
+        float x = batch.x[i], y = batch.y[i], z = batch.z[i];
+        float vx = x*mat[0][0] + y*mat[1][0] + z*mat[2][0] + mat[3][0];
+        float vy = x*mat[0][1] + y*mat[1][1] + z*mat[2][1] + mat[3][1];
+        float vz = x*mat[0][2] + y*mat[1][2] + z*mat[2][2] + mat[3][2];
+        float vw = x*mat[0][3] + y*mat[1][3] + z*mat[2][3] + mat[3][3];
+
+        if (fabs(vw) < 0.001) vw = 0.001f;
+        float oow = 1.0f / vw;
+        batch.vx[i] = vx;
+        batch.vy[i] = vy;
+        batch.vz[i] = vz;
+        batch.vw[i] = vw;
+        batch.oow[i] = oow;
+        batch.x_w[i] = vx * oow;
+        batch.y_w[i] = vy * oow;
+        batch.z_w[i] = vz * oow;
+
+        int scr_off = 0;
+        if (vx < -vw) scr_off |= 1;
+        if (vx > vw) scr_off |= 2;
+        if (vy < -vw) scr_off |= 4;
+        if (vy > vw) scr_off |= 8;
+        if (vw < 0.1f) scr_off |= 16;
+        batch.scr_off[i] = scr_off;
+    }
+}
+
+void LightVerticesC(VERTEX_BATCH &batch, int n)
+{
+    for (int i = 0; i < n; i++)
+    {
+        float vec[3] = { batch.nx[i], batch.ny[i], batch.nz[i] };
+        NormalizeVector(vec);
+        batch.nx[i] = vec[0];
+        batch.ny[i] = vec[1];
+        batch.nz[i] = vec[2];
+
+        float color[3] = { rdp.light[rdp.num_lights].r, rdp.light[rdp.num_lights].g, rdp.light[rdp.num_lights].b };
+        for (uint32_t l = 0; l < rdp.num_lights; l++)
+        {
+            float light_intensity = DotProduct(rdp.light_vector[l], vec);
+            if (light_intensity > 0.0f)
+            {
+                color[0] += rdp.light[l].r * light_intensity;
+                color[1] += rdp.light[l].g * light_intensity;
+                color[2] += rdp.light[l].b * light_intensity;
+            }
+        }
+        batch.r[i] = color[0] > 1.0f ? 1.0f : color[0];
+        batch.g[i] = color[1] > 1.0f ? 1.0f : color[1];
+        batch.b[i] = color[2] > 1.0f ? 1.0f : color[2];
+    }
+}
+
+// The SIMD kernels keep the scalar evaluation order, so they give the same bits as the C versions
+#ifdef VERTEX_BATCH_SSE
+static inline __m128 select_ps(__m128 mask, __m128 a, __m128 b)
+{
+    return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
+
+void TransformVerticesSSE(VERTEX_BATCH &batch, int n, float mat[4][4])
+{
+    const __m128 sign = _mm_set1_ps(-0.0f), min_w = _mm_set1_ps(0.001f), near_w = _mm_set1_ps(0.1f), one = _mm_set1_ps(1.0f);
+    __m128 m[4][4];
+    for (int r = 0; r < 4; r++)
+    {
+        for (int c = 0; c < 4; c++)
+        {
+            m[r][c] = _mm_set1_ps(mat[r][c]);
+        }
+    }
+
+    for (int i = 0; i < n; i += 4)
+    {
+        __m128 x = _mm_load_ps(&batch.x[i]), y = _mm_load_ps(&batch.y[i]), z = _mm_load_ps(&batch.z[i]);
+        __m128 vx = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(x, m[0][0]), _mm_mul_ps(y, m[1][0])), _mm_mul_ps(z, m[2][0])), m[3][0]);
+        __m128 vy = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(x, m[0][1]), _mm_mul_ps(y, m[1][1])), _mm_mul_ps(z, m[2][1])), m[3][1]);
+        __m128 vz = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(x, m[0][2]), _mm_mul_ps(y, m[1][2])), _mm_mul_ps(z, m[2][2])), m[3][2]);
+        __m128 vw = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(x, m[0][3]), _mm_mul_ps(y, m[1][3])), _mm_mul_ps(z, m[2][3])), m[3][3]);
+
+        vw = select_ps(_mm_cmplt_ps(_mm_andnot_ps(sign, vw), min_w), min_w, vw);
+        __m128 oow = _mm_div_ps(one, vw);
+        _mm_store_ps(&batch.vx[i], vx);
+        _mm_store_ps(&batch.vy[i], vy);
+        _mm_store_ps(&batch.vz[i], vz);
+        _mm_store_ps(&batch.vw[i], vw);
+        _mm_store_ps(&batch.oow[i], oow);
+        _mm_store_ps(&batch.x_w[i], _mm_mul_ps(vx, oow));
+        _mm_store_ps(&batch.y_w[i], _mm_mul_ps(vy, oow));
+        _mm_store_ps(&batch.z_w[i], _mm_mul_ps(vz, oow));
+
+        __m128 neg_w = _mm_xor_ps(vw, sign);
+        int left = _mm_movemask_ps(_mm_cmplt_ps(vx, neg_w));
+        int right = _mm_movemask_ps(_mm_cmpgt_ps(vx, vw));
+        int bottom = _mm_movemask_ps(_mm_cmplt_ps(vy, neg_w));
+        int top = _mm_movemask_ps(_mm_cmpgt_ps(vy, vw));
+        int behind = _mm_movemask_ps(_mm_cmplt_ps(vw, near_w));
+        for (int lane = 0; lane < 4; lane++)
+        {
+            batch.scr_off[i + lane] = ((left >> lane) & 1) | (((right >> lane) & 1) << 1) | (((bottom >> lane) & 1) << 2) | (((top >> lane) & 1) << 3) | (((behind >> lane) & 1) << 4);
+        }
+    }
+}
+
+void LightVerticesSSE(VERTEX_BATCH &batch, int n)
+{
+    const __m128 zero = _mm_setzero_ps(), one = _mm_set1_ps(1.0f);
+    for (int i = 0; i < n; i += 4)
+    {
+        __m128 nx = _mm_load_ps(&batch.nx[i]), ny = _mm_load_ps(&batch.ny[i]), nz = _mm_load_ps(&batch.nz[i]);
+        __m128 len = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(nx, nx), _mm_mul_ps(ny, ny)), _mm_mul_ps(nz, nz)));
+        __m128 valid = _mm_cmpgt_ps(len, zero);
+        nx = select_ps(valid, _mm_div_ps(nx, len), nx);
+        ny = select_ps(valid, _mm_div_ps(ny, len), ny);
+        nz = select_ps(valid, _mm_div_ps(nz, len), nz);
+        _mm_store_ps(&batch.nx[i], nx);
+        _mm_store_ps(&batch.ny[i], ny);
+        _mm_store_ps(&batch.nz[i], nz);
+
+        __m128 r = _mm_set1_ps(rdp.light[rdp.num_lights].r);
+        __m128 g = _mm_set1_ps(rdp.light[rdp.num_lights].g);
+        __m128 b = _mm_set1_ps(rdp.light[rdp.num_lights].b);
+        for (uint32_t l = 0; l < rdp.num_lights; l++)
+        {
+            const float * lv = rdp.light_vector[l];
+            __m128 intensity = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(lv[0]), nx), _mm_mul_ps(_mm_set1_ps(lv[1]), ny)), _mm_mul_ps(_mm_set1_ps(lv[2]), nz));
+            __m128 lit = _mm_cmpgt_ps(intensity, zero);
+            r = _mm_add_ps(r, _mm_and_ps(lit, _mm_mul_ps(_mm_set1_ps(rdp.light[l].r), intensity)));
+            g = _mm_add_ps(g, _mm_and_ps(lit, _mm_mul_ps(_mm_set1_ps(rdp.light[l].g), intensity)));
+            b = _mm_add_ps(b, _mm_and_ps(lit, _mm_mul_ps(_mm_set1_ps(rdp.light[l].b), intensity)));
+        }
+        // min(one, x) keeps x when it is NaN, like the scalar clamp
+        _mm_store_ps(&batch.r[i], _mm_min_ps(one, r));
+        _mm_store_ps(&batch.g[i], _mm_min_ps(one, g));
+        _mm_store_ps(&batch.b[i], _mm_min_ps(one, b));
+    }
+}
+#endif
+
+#ifdef VERTEX_BATCH_NEON
+void TransformVerticesNEON(VERTEX_BATCH &batch, int n, float mat[4][4])
+{
+    const float32x4_t min_w = vdupq_n_f32(0.001f), near_w = vdupq_n_f32(0.1f), one = vdupq_n_f32(1.0f);
+    float32x4_t m[4][4];
+    for (int r = 0; r < 4; r++)
+    {
+        for (int c = 0; c < 4; c++)
+        {
+            m[r][c] = vdupq_n_f32(mat[r][c]);
+        }
+    }
+
+    for (int i = 0; i < n; i += 4)
+    {
+        float32x4_t x = vld1q_f32(&batch.x[i]), y = vld1q_f32(&batch.y[i]), z = vld1q_f32(&batch.z[i]);
+        float32x4_t vx = vaddq_f32(vaddq_f32(vaddq_f32(vmulq_f32(x, m[0][0]), vmulq_f32(y, m[1][0])), vmulq_f32(z, m[2][0])), m[3][0]);
+        float32x4_t vy = vaddq_f32(vaddq_f32(vaddq_f32(vmulq_f32(x, m[0][1]), vmulq_f32(y, m[1][1])), vmulq_f32(z, m[2][1])), m[3][1]);
+        float32x4_t vz = vaddq_f32(vaddq_f32(vaddq_f32(vmulq_f32(x, m[0][2]), vmulq_f32(y, m[1][2])), vmulq_f32(z, m[2][2])), m[3][2]);
+        float32x4_t vw = vaddq_f32(vaddq_f32(vaddq_f32(vmulq_f32(x, m[0][3]), vmulq_f32(y, m[1][3])), vmulq_f32(z, m[2][3])), m[3][3]);
+
+        vw = vbslq_f32(vcltq_f32(vabsq_f32(vw), min_w), min_w, vw);
+        float32x4_t oow = vdivq_f32(one, vw);
+        vst1q_f32(&batch.vx[i], vx);
+        vst1q_f32(&batch.vy[i], vy);
+        vst1q_f32(&batch.vz[i], vz);
+        vst1q_f32(&batch.vw[i], vw);
+        vst1q_f32(&batch.oow[i], oow);
+        vst1q_f32(&batch.x_w[i], vmulq_f32(vx, oow));
+        vst1q_f32(&batch.y_w[i], vmulq_f32(vy, oow));
+        vst1q_f32(&batch.z_w[i], vmulq_f32(vz, oow));
+
+        float32x4_t neg_w = vnegq_f32(vw);
+        uint32x4_t scr_off = vandq_u32(vcltq_f32(vx, neg_w), vdupq_n_u32(1));
+        scr_off = vorrq_u32(scr_off, vandq_u32(vcgtq_f32(vx, vw), vdupq_n_u32(2)));
+        scr_off = vorrq_u32(scr_off, vandq_u32(vcltq_f32(vy, neg_w), vdupq_n_u32(4)));
+        scr_off = vorrq_u32(scr_off, vandq_u32(vcgtq_f32(vy, vw), vdupq_n_u32(8)));
+        scr_off = vorrq_u32(scr_off, vandq_u32(vcltq_f32(vw, near_w), vdupq_n_u32(16)));
+        vst1q_s32(&batch.scr_off[i], vreinterpretq_s32_u32(scr_off));
+    }
+}
+
+void LightVerticesNEON(VERTEX_BATCH &batch, int n)
+{
+    const float32x4_t zero = vdupq_n_f32(0.0f), one = vdupq_n_f32(1.0f);
+    for (int i = 0; i < n; i += 4)
+    {
+        float32x4_t nx = vld1q_f32(&batch.nx[i]), ny = vld1q_f32(&batch.ny[i]), nz = vld1q_f32(&batch.nz[i]);
+        float32x4_t len = vsqrtq_f32(vaddq_f32(vaddq_f32(vmulq_f32(nx, nx), vmulq_f32(ny, ny)), vmulq_f32(nz, nz)));
+        uint32x4_t valid = vcgtq_f32(len, zero);
+        nx = vbslq_f32(valid, vdivq_f32(nx, len), nx);
+        ny = vbslq_f32(valid, vdivq_f32(ny, len), ny);
+        nz = vbslq_f32(valid, vdivq_f32(nz, len), nz);
+        vst1q_f32(&batch.nx[i], nx);
+        vst1q_f32(&batch.ny[i], ny);
+        vst1q_f32(&batch.nz[i], nz);
+
+        float32x4_t r = vdupq_n_f32(rdp.light[rdp.num_lights].r);
+        float32x4_t g = vdupq_n_f32(rdp.light[rdp.num_lights].g);
+        float32x4_t b = vdupq_n_f32(rdp.light[rdp.num_lights].b);
+        for (uint32_t l = 0; l < rdp.num_lights; l++)
+        {
+            const float * lv = rdp.light_vector[l];
+            float32x4_t intensity = vaddq_f32(vaddq_f32(vmulq_f32(vdupq_n_f32(lv[0]), nx), vmulq_f32(vdupq_n_f32(lv[1]), ny)), vmulq_f32(vdupq_n_f32(lv[2]), nz));
+            uint32x4_t lit = vcgtq_f32(intensity, zero);
+            r = vaddq_f32(r, vbslq_f32(lit, vmulq_f32(vdupq_n_f32(rdp.light[l].r), intensity), zero));
+            g = vaddq_f32(g, vbslq_f32(lit, vmulq_f32(vdupq_n_f32(rdp.light[l].g), intensity), zero));
+            b = vaddq_f32(b, vbslq_f32(lit, vmulq_f32(vdupq_n_f32(rdp.light[l].b), intensity), zero));
+        }
+        vst1q_f32(&batch.r[i], vbslq_f32(vcgtq_f32(r, one), one, r));
+        vst1q_f32(&batch.g[i], vbslq_f32(vcgtq_f32(g, one), one, g));
+        vst1q_f32(&batch.b[i], vbslq_f32(vcgtq_f32(b, one), one, b));
+    }
+}
+
+TRANSFORMVERTICES TransformVertices = TransformVerticesNEON;
+LIGHTVERTICES LightVertices = LightVerticesNEON;
+#elif defined(VERTEX_BATCH_SSE) && (defined(__x86_64__) || defined(_M_X64))
+TRANSFORMVERTICES TransformVertices = TransformVerticesSSE;
+LIGHTVERTICES LightVertices = LightVerticesSSE;
+#else
+TRANSFORMVERTICES TransformVertices = TransformVerticesC;
+LIGHTVERTICES LightVertices = LightVerticesC;
+#endif
+
 void math_init()
 {
 #ifndef _DEBUG
@@ -416,6 +674,10 @@ void math_init()
     if (IsSSE)
     {
         MulMatrices = MulMatricesSSE;
+#ifdef VERTEX_BATCH_SSE
+        TransformVertices = TransformVerticesSSE;
+        LightVertices = LightVerticesSSE;
+#endif
         WriteTrace(TraceGlide64, TraceDebug, "3DNOW! detected.");
     }
 
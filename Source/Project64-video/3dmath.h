@@ -19,3 +19,34 @@ typedef float(*DOTPRODUCT)(register float *v1, register float *v2);
 extern DOTPRODUCT DotProduct;
 typedef void(*NORMALIZEVECTOR)(float *v);
 extern NORMALIZEVECTOR NormalizeVector;
+
+// Vertex loads are transformed and lit in SoA blocks, so the kernels can work on four vertices at a time
+#define VERTEX_BATCH_SIZE 16
+
+typedef struct
+{
+    DECLAREALIGN16VAR(x[VERTEX_BATCH_SIZE]);    // Object space position
+    DECLAREALIGN16VAR(y[VERTEX_BATCH_SIZE]);
+    DECLAREALIGN16VAR(z[VERTEX_BATCH_SIZE]);
+    DECLAREALIGN16VAR(nx[VERTEX_BATCH_SIZE]);   // Normal, normalized by LightVertices
+    DECLAREALIGN16VAR(ny[VERTEX_BATCH_SIZE]);
+    DECLAREALIGN16VAR(nz[VERTEX_BATCH_SIZE]);
+    DECLAREALIGN16VAR(vx[VERTEX_BATCH_SIZE]);   // Clip space position, w clamped away from 0
+    DECLAREALIGN16VAR(vy[VERTEX_BATCH_SIZE]);
+    DECLAREALIGN16VAR(vz[VERTEX_BATCH_SIZE]);
+    DECLAREALIGN16VAR(vw[VERTEX_BATCH_SIZE]);
+    DECLAREALIGN16VAR(oow[VERTEX_BATCH_SIZE]);
+    DECLAREALIGN16VAR(x_w[VERTEX_BATCH_SIZE]);
+    DECLAREALIGN16VAR(y_w[VERTEX_BATCH_SIZE]);
+    DECLAREALIGN16VAR(z_w[VERTEX_BATCH_SIZE]);
+    DECLAREALIGN16VAR(r[VERTEX_BATCH_SIZE]);    // Directional light color, 0..1
+    DECLAREALIGN16VAR(g[VERTEX_BATCH_SIZE]);
+    DECLAREALIGN16VAR(b[VERTEX_BATCH_SIZE]);
+    int scr_off[VERTEX_BATCH_SIZE];
+} VERTEX_BATCH;
+
+void load_vertex_batch(VERTEX_BATCH &batch, uint32_t addr, int n, bool normals);
+typedef void(*TRANSFORMVERTICES)(VERTEX_BATCH &batch, int n, float mat[4][4]);
+extern TRANSFORMVERTICES TransformVertices;
+typedef void(*LIGHTVERTICES)(VERTEX_BATCH &batch, int n);
+extern LIGHTVERTICES LightVertices;
@@ -4,9 +4,33 @@
 // Copyright(C) 2003-2009 Sergey 'Gonetz' Lipski
 // Copyright(C) 2002 Dave2001
 // GNU/GPLv2 licensed: https://gnu.org/licenses/gpl-2.0.html
+#include <stdint.h>
+#include <string.h>
+#include "CRC.h"
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+#define CRC_X86
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define CRC_TARGET(Target)
+#else
+#include <cpuid.h>
+#define CRC_TARGET(Target) __attribute__((target(Target)))
+#endif
+#elif defined(__ARM_FEATURE_CRC32)
+#define CRC_ARM
+#include <arm_acle.h>
+#endif
+
 #define CRC32_POLYNOMIAL     0x04C11DB7
 
-unsigned int CRCTable[256];
+// CRCTable[0] is the classic byte table, CRCTable[1..7] let CRC32_Slice8 fold in
+// eight bytes per step. Every path gives the same value as the byte at a time loop,
+// the Glide64 texture CRC built on it names the textures in hi-res packs.
+unsigned int CRCTable[8][256];
+
+typedef unsigned int(*CRC32_FUNC)(unsigned int crc, const uint8_t * p, unsigned int count);
 
 unsigned int Reflect(unsigned int ref, char ch)
 {
@@ -23,6 +47,119 @@ unsigned int Reflect(unsigned int ref, char ch)
     return value;
 }
 
+static unsigned int CRC32_Slice8(unsigned int crc, const uint8_t * p, unsigned int count)
+{
+    for (; count >= 8; count -= 8, p += 8)
+    {
+        uint32_t lo, hi;
+        memcpy(&lo, p, 4);
+        memcpy(&hi, p + 4, 4);
+        lo ^= crc;
+        crc = CRCTable[7][lo & 0xFF] ^ CRCTable[6][(lo >> 8) & 0xFF] ^ CRCTable[5][(lo >> 16) & 0xFF] ^ CRCTable[4][lo >> 24] ^
+            CRCTable[3][hi & 0xFF] ^ CRCTable[2][(hi >> 8) & 0xFF] ^ CRCTable[1][(hi >> 16) & 0xFF] ^ CRCTable[0][hi >> 24];
+    }
+    while (count--)
+        crc = (crc >> 8) ^ CRCTable[0][(crc & 0xFF) ^ *p++];
+    return crc;
+}
+
+#ifdef CRC_X86
+// Folds 64 bytes at a time with carry-less multiplies, then a Barrett reduction
+// back to 32 bits. The constants are x^n mod P for the reflected CRC-32 polynomial.
+CRC_TARGET("pclmul,sse4.1") static unsigned int CRC32_Pclmul(unsigned int crc, const uint8_t * p, unsigned int count)
+{
+    if (count < 64)
+    {
+        return CRC32_Slice8(crc, p, count);
+    }
+
+    const __m128i k1k2 = _mm_set_epi64x(0x01c6e41596, 0x0154442bd4);
+    const __m128i k3k4 = _mm_set_epi64x(0x00ccaa009e, 0x01751997d0);
+    const __m128i k5k0 = _mm_set_epi64x(0, 0x0163cd6124);
+    const __m128i poly = _mm_set_epi64x(0x01f7011641, 0x01db710641);
+    const __m128i mask32 = _mm_setr_epi32(~0, 0, ~0, 0);
+
+    __m128i x1 = _mm_loadu_si128((const __m128i *)(p + 0x00));
+    __m128i x2 = _mm_loadu_si128((const __m128i *)(p + 0x10));
+    __m128i x3 = _mm_loadu_si128((const __m128i *)(p + 0x20));
+    __m128i x4 = _mm_loadu_si128((const __m128i *)(p + 0x30));
+    x1 = _mm_xor_si128(x1, _mm_cvtsi32_si128((int)crc));
+    p += 64;
+    count -= 64;
+
+    for (; count >= 64; count -= 64, p += 64)
+    {
+        __m128i x5 = _mm_clmulepi64_si128(x1, k1k2, 0x00);
+        __m128i x6 = _mm_clmulepi64_si128(x2, k1k2, 0x00);
+        __m128i x7 = _mm_clmulepi64_si128(x3, k1k2, 0x00);
+        __m128i x8 = _mm_clmulepi64_si128(x4, k1k2, 0x00);
+        x1 = _mm_clmulepi64_si128(x1, k1k2, 0x11);
+        x2 = _mm_clmulepi64_si128(x2, k1k2, 0x11);
+        x3 = _mm_clmulepi64_si128(x3, k1k2, 0x11);
+        x4 = _mm_clmulepi64_si128(x4, k1k2, 0x11);
+        x1 = _mm_xor_si128(_mm_xor_si128(x1, x5), _mm_loadu_si128((const __m128i *)(p + 0x00)));
+        x2 = _mm_xor_si128(_mm_xor_si128(x2, x6), _mm_loadu_si128((const __m128i *)(p + 0x10)));
+        x3 = _mm_xor_si128(_mm_xor_si128(x3, x7), _mm_loadu_si128((const __m128i *)(p + 0x20)));
+        x4 = _mm_xor_si128(_mm_xor_si128(x4, x8), _mm_loadu_si128((const __m128i *)(p + 0x30)));
+    }
+
+    // Fold the four lanes and any remaining 16 byte blocks into one
+    __m128i x5 = _mm_clmulepi64_si128(x1, k3k4, 0x00);
+    x1 = _mm_xor_si128(_mm_xor_si128(_mm_clmulepi64_si128(x1, k3k4, 0x11), x2), x5);
+    x5 = _mm_clmulepi64_si128(x1, k3k4, 0x00);
+    x1 = _mm_xor_si128(_mm_xor_si128(_mm_clmulepi64_si128(x1, k3k4, 0x11), x3), x5);
+    x5 = _mm_clmulepi64_si128(x1, k3k4, 0x00);
+    x1 = _mm_xor_si128(_mm_xor_si128(_mm_clmulepi64_si128(x1, k3k4, 0x11), x4), x5);
+    for (; count >= 16; count -= 16, p += 16)
+    {
+        x5 = _mm_clmulepi64_si128(x1, k3k4, 0x00);
+        x1 = _mm_xor_si128(_mm_xor_si128(_mm_clmulepi64_si128(x1, k3k4, 0x11), _mm_loadu_si128((const __m128i *)p)), x5);
+    }
+
+    // 128 bits to 64 bits
+    x2 = _mm_clmulepi64_si128(x1, k3k4, 0x10);
+    x1 = _mm_xor_si128(_mm_srli_si128(x1, 8), x2);
+    x2 = _mm_srli_si128(x1, 4);
+    x1 = _mm_xor_si128(_mm_clmulepi64_si128(_mm_and_si128(x1, mask32), k5k0, 0x00), x2);
+
+    // Barrett reduction to 32 bits
+    x2 = _mm_clmulepi64_si128(_mm_and_si128(x1, mask32), poly, 0x10);
+    x2 = _mm_clmulepi64_si128(_mm_and_si128(x2, mask32), poly, 0x00);
+    x1 = _mm_xor_si128(x1, x2);
+    crc = (unsigned int)_mm_extract_epi32(x1, 1);
+
+    return CRC32_Slice8(crc, p, count);
+}
+
+static bool CRC_HasPclmul(void)
+{
+    uint32_t Regs[4];
+#ifdef _MSC_VER
+    __cpuidex((int *)Regs, 1, 0);
+#else
+    __cpuid_count(1, 0, Regs[0], Regs[1], Regs[2], Regs[3]);
+#endif
+    return (Regs[2] & (1 << 1)) != 0 && (Regs[2] & (1 << 19)) != 0;
+}
+#endif
+
+#ifdef CRC_ARM
+static unsigned int CRC32_Arm(unsigned int crc, const uint8_t * p, unsigned int count)
+{
+    for (; count >= 8; count -= 8, p += 8)
+    {
+        uint64_t value;
+        memcpy(&value, p, sizeof(value));
+        crc = __crc32d(crc, value);
+    }
+    while (count--)
+        crc = __crc32b(crc, *p++);
+    return crc;
+}
+#endif
+
+static CRC32_FUNC CRC32_Update = CRC32_Slice8;
+
 void CRC_BuildTable()
 {
     unsigned int crc;
@@ -33,71 +170,22 @@ void CRC_BuildTable()
         for (unsigned j = 0; j < 8; j++)
             crc = (crc << 1) ^ (crc & (1 << 31) ? CRC32_POLYNOMIAL : 0);
 
-        CRCTable[i] = Reflect(crc, 32);
+        CRCTable[0][i] = Reflect(crc, 32);
+    }
+    for (unsigned i = 0; i <= 255; i++)
+    {
+        for (unsigned k = 1; k < 8; k++)
+            CRCTable[k][i] = (CRCTable[k - 1][i] >> 8) ^ CRCTable[0][CRCTable[k - 1][i] & 0xFF];
     }
-}
-//*/
-//*
-unsigned int CRC32(unsigned int crc, void *buffer, unsigned int count)
-{
-    unsigned int orig = crc;
-    unsigned char * p = reinterpret_cast<unsigned char*>(buffer);
-    while (count--)
-        crc = (crc >> 8) ^ CRCTable[(crc & 0xFF) ^ *p++];
-    return crc ^ orig;
-}
-//*/
 
-/*
-uint32_t CRC_Calculate( uint32_t crc, void *buffer, uint32_t count )
-{
-uint32_t Crc32=crc;
-__asm {
-mov	esi, buffer
-mov	ecx, count
-mov	edx, crc
-xor eax, eax
-
-loop1:
-inc	esi
-mov	al, dl
-xor	al, byte ptr [esi]
-shr	edx, 8
-mov	ebx, [CRCTable+eax*4]
-xor	edx, ebx
-
-loop loop1
-
-xor	Crc32, edx
-}
-return Crc32;
+#if defined(CRC_X86)
+    CRC32_Update = CRC_HasPclmul() ? CRC32_Pclmul : CRC32_Slice8;
+#elif defined(CRC_ARM)
+    CRC32_Update = CRC32_Arm;
+#endif
 }
-*/
 
-/*
-unsigned int CRC_Calculate( unsigned int crc, void *buffer, unsigned int count )
+unsigned int CRC32(unsigned int crc, void *buffer, unsigned int count)
 {
-unsigned int Crc32=crc;
-__asm {
-mov	esi, buffer
-mov	edx, count
-add	edx, esi
-mov	ecx, crc
-
-loop1:
-mov	bl, byte ptr [esi]
-movzx	eax, cl
-inc	esi
-xor	al, bl
-shr	ecx, 8
-mov	ebx, [CRCTable+eax*4]
-xor	ecx, ebx
-
-cmp	edx, esi
-jne	loop1
-
-xor	Crc32, ecx
-}
-return Crc32;
+    return CRC32_Update(crc, reinterpret_cast<const uint8_t*>(buffer), count) ^ crc;
 }
-//*/
\ No newline at end of file
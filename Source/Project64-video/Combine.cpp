@@ -15457,71 +15457,47 @@ void CountCombine()
 }
 
 //****************************************************************
-// Main Combine
-//****************************************************************
+// Combiner resolution memo
+//
+// Which handlers a pair of cycle words resolves to depends on nothing else, so the
+// result of the search through color_cmb_list/alpha_cmb_list is kept in a small direct
+// mapped table. The handlers still run on every Combine, they read the current colors,
+// tiles and hacks.
 
-void Combine()
+typedef struct
 {
-    WriteTrace(TraceRDP, TraceDebug, " | |- color combine: %08lx, #1: (%s-%s)*%s+%s, #2: (%s-%s)*%s+%s",
-        ((rdp.cycle1 & 0xFFFF) << 16) | (rdp.cycle2 & 0xFFFF),
-        Mode0[rdp.cycle1 & 0xF], Mode1[(rdp.cycle1 >> 4) & 0xF], Mode2[(rdp.cycle1 >> 8) & 0x1F], Mode3[(rdp.cycle1 >> 13) & 7],
-        Mode0[rdp.cycle2 & 0xF], Mode1[(rdp.cycle2 >> 4) & 0xF], Mode2[(rdp.cycle2 >> 8) & 0x1F], Mode3[(rdp.cycle2 >> 13) & 7]);
-    WriteTrace(TraceRDP, TraceDebug, " | |- alpha combine: %08lx, #1: (%s-%s)*%s+%s, #2: (%s-%s)*%s+%s",
-        (rdp.cycle1 & 0x0FFF0000) | ((rdp.cycle2 & 0x0FFF0000) >> 16),
-        Alpha0[(rdp.cycle1 >> 16) & 7], Alpha1[(rdp.cycle1 >> 19) & 7], Alpha2[(rdp.cycle1 >> 22) & 7], Alpha3[(rdp.cycle1 >> 25) & 7],
-        Alpha0[(rdp.cycle2 >> 16) & 7], Alpha1[(rdp.cycle2 >> 19) & 7], Alpha2[(rdp.cycle2 >> 22) & 7], Alpha3[(rdp.cycle2 >> 25) & 7]);
-    if (!rdp.LOD_en || rdp.cur_tile == rdp.mipmap_level)
-    {
-        lod_frac = rdp.prim_lodfrac;
-    }
-    else if (g_settings->lodmode() == CSettings::LOD_Off)
-    {
-        lod_frac = 0;
-    }
-    else
-    {
-        lod_frac = 10;
-    }
+    uint32_t cycle1, cycle2;
+    cmb_func color_func, alpha_func;
+    uint8_t uncombined;
+    bool valid;
+} COMBINE_MEMO;
 
-    rdp.noise = CRDP::noise_none;
+enum { COMBINE_MEMO_BITS = 10, COMBINE_MEMO_SIZE = 1 << COMBINE_MEMO_BITS };
 
-    uint32_t found = TRUE;
+static COMBINE_MEMO combine_memo[COMBINE_MEMO_SIZE];
 
-    rdp.col[0] = rdp.col[1] = rdp.col[2] = rdp.col[3] =
-        rdp.coladd[0] = rdp.coladd[1] = rdp.coladd[2] = rdp.coladd[3] = 1.0f;
-    rdp.cmb_flags = rdp.cmb_flags_2 = 0;
-
-    rdp.uncombined = 0;
-
-    cmb.tex = 0;
-    cmb.tmu0_func = cmb.tmu1_func = cmb.tmu0_a_func = cmb.tmu1_a_func = GFX_COMBINE_FUNCTION_ZERO;
-    cmb.tmu0_fac = cmb.tmu1_fac = cmb.tmu0_a_fac = cmb.tmu1_a_fac = GFX_COMBINE_FACTOR_NONE;
-    cmb.tmu0_invert = cmb.tmu0_a_invert = cmb.tmu1_invert = cmb.tmu1_a_invert = false;
-
-    cmb.dc0_detailmax = cmb.dc1_detailmax = 0;
-
-    cmb.mod_0 = cmb.mod_1 = 0;    // remove all modifications
-    cmb.modcolor_0 = cmb.modcolor1_0 = cmb.modcolor2_0 = cmb.modcolor_1 = cmb.modcolor1_1 = cmb.modcolor2_1
-        = cmb.modfactor_0 = cmb.modfactor_1 = 0;
-
-    cmb.ccolor = cmb.tex_ccolor = 0;
-    cmb.cmb_ext_use = 0;
-    cmb.tex_cmb_ext_use = 0;
+static inline uint32_t CombineMemoSlot(uint32_t cycle1, uint32_t cycle2)
+{
+    return ((cycle1 * 0x9E3779B1) ^ (cycle2 * 0x85EBCA6B)) >> (32 - COMBINE_MEMO_BITS);
+}
 
+static void ResolveCombine(COMBINE_MEMO & memo)
+{
     uint32_t cmb_mode_c = (rdp.cycle1 << 16) | (rdp.cycle2 & 0xFFFF);
     uint32_t cmb_mode_a = (rdp.cycle1 & 0x0FFF0000) | ((rdp.cycle2 >> 16) & 0x00000FFF);
+    uint32_t found = TRUE;
 
-    cmb.abf1 = GFX_BLEND_SRC_ALPHA;
-    cmb.abf2 = GFX_BLEND_ONE_MINUS_SRC_ALPHA;
+    memo.cycle1 = rdp.cycle1;
+    memo.cycle2 = rdp.cycle2;
+    memo.uncombined = 0;
+    memo.valid = true;
 
-#ifdef FASTSEARCH
     // Fast, ordered search
     int current = 0x7FFFFFFF, last;
-    uint32_t actual_combine, current_combine, color_combine, alpha_combine;
+    uint32_t actual_combine, current_combine;
     int left, right;
 
     actual_combine = current_combine = cmb_mode_c;
-    color_combine = actual_combine;
     if ((rdp.cycle2 & 0xFFFF) == 0x1FFF)
         actual_combine = (rdp.cycle1 << 16) | (rdp.cycle1 & 0xFFFF);
 
@@ -15550,7 +15526,7 @@ void Combine()
     // Check if we didn't find it
     if (actual_combine != current_combine)
     {
-        rdp.uncombined |= 1;
+        memo.uncombined |= 1;
         WriteTrace(TraceUnknown, TraceDebug, "COLOR combine not found: %08x, #1: (%s-%s)*%s+%s, #2: (%s-%s)*%s+%s", actual_combine,
             Mode0[rdp.cycle1 & 0xF], Mode1[(rdp.cycle1 >> 4) & 0xF], Mode2[(rdp.cycle1 >> 8) & 0x1F], Mode3[(rdp.cycle1 >> 13) & 7],
             Mode0[rdp.cycle2 & 0xF], Mode1[(rdp.cycle2 >> 4) & 0xF], Mode2[(rdp.cycle2 >> 8) & 0x1F], Mode3[(rdp.cycle2 >> 13) & 7]);
@@ -15558,17 +15534,14 @@ void Combine()
         //tex |= 3;
 
         // use t0 as default
-        cc_t0();
+        memo.color_func = cc_t0;
     }
     else
-        color_cmb_list[current].func();
-
-    WriteTrace(TraceRDP, TraceDebug, " | |- Color done");
+        memo.color_func = color_cmb_list[current].func;
 
     // Now again for alpha
     current = 0x7FFFFFFF;
     actual_combine = cmb_mode_a;
-    alpha_combine = actual_combine;
     if ((rdp.cycle2 & 0x0FFF0000) == 0x01FF0000)
         actual_combine = (rdp.cycle1 & 0x0FFF0000) | ((rdp.cycle1 >> 16) & 0x00000FFF);
     if ((rdp.cycle1 & 0x0FFF0000) == 0x0FFF0000)
@@ -15598,18 +15571,89 @@ void Combine()
     {
         if (actual_combine != current_combine)
         {
-            rdp.uncombined |= 2;
+            memo.uncombined |= 2;
             WriteTrace(TraceUnknown, TraceDebug, "ALPHA combine not found: %08x, #1: (%s-%s)*%s+%s, #2: (%s-%s)*%s+%s", actual_combine,
                 Alpha0[(rdp.cycle1 >> 16) & 7], Alpha1[(rdp.cycle1 >> 19) & 7], Alpha2[(rdp.cycle1 >> 22) & 7], Alpha3[(rdp.cycle1 >> 25) & 7],
                 Alpha0[(rdp.cycle2 >> 16) & 7], Alpha1[(rdp.cycle2 >> 19) & 7], Alpha2[(rdp.cycle2 >> 22) & 7], Alpha3[(rdp.cycle2 >> 25) & 7]);
         }
         // use full alpha as default
-        ac_t0();
+        memo.alpha_func = ac_t0;
     }
     else
     {
-        alpha_cmb_list[current].func();
+        memo.alpha_func = alpha_cmb_list[current].func;
     }
+}
+
+//****************************************************************
+// Main Combine
+//****************************************************************
+
+void Combine()
+{
+    WriteTrace(TraceRDP, TraceDebug, " | |- color combine: %08lx, #1: (%s-%s)*%s+%s, #2: (%s-%s)*%s+%s",
+        ((rdp.cycle1 & 0xFFFF) << 16) | (rdp.cycle2 & 0xFFFF),
+        Mode0[rdp.cycle1 & 0xF], Mode1[(rdp.cycle1 >> 4) & 0xF], Mode2[(rdp.cycle1 >> 8) & 0x1F], Mode3[(rdp.cycle1 >> 13) & 7],
+        Mode0[rdp.cycle2 & 0xF], Mode1[(rdp.cycle2 >> 4) & 0xF], Mode2[(rdp.cycle2 >> 8) & 0x1F], Mode3[(rdp.cycle2 >> 13) & 7]);
+    WriteTrace(TraceRDP, TraceDebug, " | |- alpha combine: %08lx, #1: (%s-%s)*%s+%s, #2: (%s-%s)*%s+%s",
+        (rdp.cycle1 & 0x0FFF0000) | ((rdp.cycle2 & 0x0FFF0000) >> 16),
+        Alpha0[(rdp.cycle1 >> 16) & 7], Alpha1[(rdp.cycle1 >> 19) & 7], Alpha2[(rdp.cycle1 >> 22) & 7], Alpha3[(rdp.cycle1 >> 25) & 7],
+        Alpha0[(rdp.cycle2 >> 16) & 7], Alpha1[(rdp.cycle2 >> 19) & 7], Alpha2[(rdp.cycle2 >> 22) & 7], Alpha3[(rdp.cycle2 >> 25) & 7]);
+    if (!rdp.LOD_en || rdp.cur_tile == rdp.mipmap_level)
+    {
+        lod_frac = rdp.prim_lodfrac;
+    }
+    else if (g_settings->lodmode() == CSettings::LOD_Off)
+    {
+        lod_frac = 0;
+    }
+    else
+    {
+        lod_frac = 10;
+    }
+
+    rdp.noise = CRDP::noise_none;
+
+    rdp.col[0] = rdp.col[1] = rdp.col[2] = rdp.col[3] =
+        rdp.coladd[0] = rdp.coladd[1] = rdp.coladd[2] = rdp.coladd[3] = 1.0f;
+    rdp.cmb_flags = rdp.cmb_flags_2 = 0;
+
+    rdp.uncombined = 0;
+
+    cmb.tex = 0;
+    cmb.tmu0_func = cmb.tmu1_func = cmb.tmu0_a_func = cmb.tmu1_a_func = GFX_COMBINE_FUNCTION_ZERO;
+    cmb.tmu0_fac = cmb.tmu1_fac = cmb.tmu0_a_fac = cmb.tmu1_a_fac = GFX_COMBINE_FACTOR_NONE;
+    cmb.tmu0_invert = cmb.tmu0_a_invert = cmb.tmu1_invert = cmb.tmu1_a_invert = false;
+
+    cmb.dc0_detailmax = cmb.dc1_detailmax = 0;
+
+    cmb.mod_0 = cmb.mod_1 = 0;    // remove all modifications
+    cmb.modcolor_0 = cmb.modcolor1_0 = cmb.modcolor2_0 = cmb.modcolor_1 = cmb.modcolor1_1 = cmb.modcolor2_1
+        = cmb.modfactor_0 = cmb.modfactor_1 = 0;
+
+    cmb.ccolor = cmb.tex_ccolor = 0;
+    cmb.cmb_ext_use = 0;
+    cmb.tex_cmb_ext_use = 0;
+
+    uint32_t cmb_mode_c = (rdp.cycle1 << 16) | (rdp.cycle2 & 0xFFFF);
+    uint32_t cmb_mode_a = (rdp.cycle1 & 0x0FFF0000) | ((rdp.cycle2 >> 16) & 0x00000FFF);
+
+    cmb.abf1 = GFX_BLEND_SRC_ALPHA;
+    cmb.abf2 = GFX_BLEND_ONE_MINUS_SRC_ALPHA;
+
+#ifdef FASTSEARCH
+    uint32_t color_combine = cmb_mode_c, alpha_combine = cmb_mode_a;
+    COMBINE_MEMO & memo = combine_memo[CombineMemoSlot(rdp.cycle1, rdp.cycle2)];
+    if (!memo.valid || memo.cycle1 != rdp.cycle1 || memo.cycle2 != rdp.cycle2)
+    {
+        ResolveCombine(memo);
+    }
+    rdp.uncombined = memo.uncombined;
+
+    memo.color_func();
+    WriteTrace(TraceRDP, TraceDebug, " | |- Color done");
+
+    memo.alpha_func();
 
     if (color_combine == 0x69351fff) //text, PD, need to change texture alpha
     {
@@ -0,0 +1,750 @@
+// Project64 - A Nintendo 64 emulator
+// https://www.pj64-emu.com/
+// Copyright(C) 2001-2021 Project64
+// Copyright(C) 2003-2009 Sergey 'Gonetz' Lipski
+// Copyright(C) 2002 Dave2001
+// GNU/GPLv2 licensed: https://gnu.org/licenses/gpl-2.0.html
+
+// Renderer without a GPU. Every gfx call is folded into a per frame checksum and
+// counted, so the display list pipeline can be benchmarked and regression tested
+// on machines with no GL context. The frame checksums, and at verbose Glitch log
+// level every call, are written as fixed size records to Glide64.trace in the log dir.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <Common/path.h>
+#include <Project64-video/trace.h>
+#include <Project64-video/Settings.h>
+#include <Project64-video/Renderer/Renderer.h>
+
+#ifdef ANDROID
+extern uint32_t g_ScreenWidth, g_ScreenHeight;
+#endif
+
+int g_width, g_height, g_viewport_offset = 0;
+
+enum
+{
+    HEADLESS_TRACE_VERSION = 1,
+    HEADLESS_TMU_SIZE = 8 * 2048 * 2048,
+    HEADLESS_DEFAULT_WIDTH = 640,
+    HEADLESS_DEFAULT_HEIGHT = 480,
+};
+
+enum HEADLESS_OP
+{
+    HeadlessOp_Frame = 1,
+    HeadlessOp_FrameStats,
+    HeadlessOp_ClipWindow,
+    HeadlessOp_ColorMask,
+    HeadlessOp_TextureBuffer,
+    HeadlessOp_ConstantColor,
+    HeadlessOp_ColorCombine,
+    HeadlessOp_AlphaCombine,
+    HeadlessOp_TexCombine,
+    HeadlessOp_AlphaBlend,
+    HeadlessOp_AlphaTestReference,
+    HeadlessOp_AlphaTestFunction,
+    HeadlessOp_FogMode,
+    HeadlessOp_FogTable,
+    HeadlessOp_FogColor,
+    HeadlessOp_ChromakeyMode,
+    HeadlessOp_ChromakeyValue,
+    HeadlessOp_StippleMode,
+    HeadlessOp_ColorCombineExt,
+    HeadlessOp_AlphaCombineExt,
+    HeadlessOp_TexColorCombineExt,
+    HeadlessOp_TexAlphaCombineExt,
+    HeadlessOp_ConstantColorExt,
+    HeadlessOp_CullMode,
+    HeadlessOp_DepthBufferMode,
+    HeadlessOp_DepthBufferFunction,
+    HeadlessOp_DepthMask,
+    HeadlessOp_DepthBias,
+    HeadlessOp_Triangle,
+    HeadlessOp_Line,
+    HeadlessOp_VertexArray,
+    HeadlessOp_AuxBuffer,
+    HeadlessOp_RenderBuffer,
+    HeadlessOp_BufferClear,
+    HeadlessOp_LfbLock,
+    HeadlessOp_LfbRead,
+    HeadlessOp_LfbWrite,
+    HeadlessOp_TexDownload,
+    HeadlessOp_TexSource,
+    HeadlessOp_TexDetail,
+    HeadlessOp_TexClamp,
+    HeadlessOp_TexFilter,
+};
+
+// Every trace entry, the file header included, is one of these
+typedef struct
+{
+    uint32_t op;
+    uint32_t arg[3];
+} HEADLESS_RECORD;
+
+typedef struct
+{
+    uint32_t state_changes;
+    uint32_t state_flushes;
+    uint32_t batches;
+    uint32_t triangles;
+    uint32_t lines;
+    uint32_t tex_sources;
+    uint32_t tex_uploads;
+    uint32_t tex_upload_bytes;
+    uint32_t lfb_reads;
+    uint32_t lfb_writes;
+    uint32_t clears;
+} HEADLESS_STATS;
+
+static HEADLESS_STATS frame_stats, last_frame_stats, run_stats;
+static uint32_t frame_checksum, run_checksum, frame_number;
+static bool state_dirty;
+
+static FILE * trace_file = nullptr;
+static bool trace_calls = false;
+static HEADLESS_RECORD * trace_buffer = nullptr;
+static uint32_t trace_count = 0, trace_size = 0;
+
+static uint16_t * color_buffer = nullptr;
+static uint16_t * depth_buffer = nullptr;
+
+static inline uint32_t fnv1a(uint32_t hash, const void * data, size_t len)
+{
+    const uint8_t * p = (const uint8_t *)data;
+    for (size_t i = 0; i < len; i++)
+    {
+        hash = (hash ^ p[i]) * 16777619u;
+    }
+    return hash;
+}
+
+static inline uint32_t float_bits(float value)
+{
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+static void record(uint32_t op, uint32_t arg0, uint32_t arg1, uint32_t arg2)
+{
+    HEADLESS_RECORD rec = { op, { arg0, arg1, arg2 } };
+    frame_checksum = fnv1a(frame_checksum, &rec, sizeof(rec));
+
+    if (!trace_calls)
+    {
+        return;
+    }
+    if (trace_count == trace_size)
+    {
+        uint32_t new_size = trace_size != 0 ? trace_size * 2 : 4096;
+        HEADLESS_RECORD * new_buffer = (HEADLESS_RECORD *)realloc(trace_buffer, new_size * sizeof(HEADLESS_RECORD));
+        if (new_buffer == nullptr)
+        {
+            return;
+        }
+        trace_buffer = new_buffer;
+        trace_size = new_size;
+    }
+    trace_buffer[trace_count++] = rec;
+}
+
+static void record_state(uint32_t op, uint32_t arg0, uint32_t arg1, uint32_t arg2)
+{
+    frame_stats.state_changes += 1;
+    state_dirty = true;
+    record(op, arg0, arg1, arg2);
+}
+
+// Positions and texture coordinates are snapped to 1/16 so the checksum survives
+// float rounding differences between compilers
+static inline int32_t snap(float value)
+{
+    return (int32_t)lrintf(value * 16.0f);
+}
+
+static uint32_t vertex_hash(uint32_t hash, const gfxVERTEX * v)
+{
+    int32_t pos[8] = { snap(v->x), snap(v->y), snap(v->z), (int32_t)lrintf(v->q * 65536.0f), snap(v->coord[0]), snap(v->coord[1]), snap(v->coord[2]), snap(v->coord[3]) };
+    uint8_t color[5] = { v->r, v->g, v->b, v->a, (uint8_t)lrintf(v->f * 255.0f) };
+    hash = fnv1a(hash, pos, sizeof(pos));
+    return fnv1a(hash, color, sizeof(color));
+}
+
+static void record_draw(uint32_t op, uint32_t mode, uint32_t count, uint32_t hash, uint32_t triangles)
+{
+    if (state_dirty)
+    {
+        frame_stats.state_flushes += 1;
+        state_dirty = false;
+    }
+    frame_stats.batches += 1;
+    frame_stats.triangles += triangles;
+    record(op, mode, count, hash);
+}
+
+static uint32_t mode_triangles(gfxDrawMode_t mode, uint32_t Count)
+{
+    switch (mode)
+    {
+    case GFX_TRIANGLES:
+        return Count / 3;
+    case GFX_TRIANGLE_STRIP:
+    case GFX_TRIANGLE_FAN:
+    case GFX_POLYGON:
+        return Count > 2 ? Count - 2 : 0;
+    case GFX_TRIANGLE_STRIP_CONTINUE:
+    case GFX_TRIANGLE_FAN_CONTINUE:
+        return Count;
+    default:
+        return 0;
+    }
+}
+
+static void add_stats(HEADLESS_STATS & total, const HEADLESS_STATS & frame)
+{
+    total.state_changes += frame.state_changes;
+    total.state_flushes += frame.state_flushes;
+    total.batches += frame.batches;
+    total.triangles += frame.triangles;
+    total.lines += frame.lines;
+    total.tex_sources += frame.tex_sources;
+    total.tex_uploads += frame.tex_uploads;
+    total.tex_upload_bytes += frame.tex_upload_bytes;
+    total.lfb_reads += frame.lfb_reads;
+    total.lfb_writes += frame.lfb_writes;
+    total.clears += frame.clears;
+}
+
+static void trace_write(const HEADLESS_RECORD * recs, uint32_t count)
+{
+    if (trace_file != nullptr && count != 0 && fwrite(recs, sizeof(HEADLESS_RECORD), count, trace_file) != count)
+    {
+        WriteTrace(TraceGlitch, TraceError, "Failed to write headless trace");
+        fclose(trace_file);
+        trace_file = nullptr;
+    }
+}
+
+static void trace_open()
+{
+    const char * log_dir = g_settings ? g_settings->log_dir() : nullptr;
+    if (log_dir == nullptr || log_dir[0] == '\0')
+    {
+        return;
+    }
+
+    CPath TraceFilePath(log_dir, "Glide64.trace");
+    if (!TraceFilePath.DirectoryExists())
+    {
+        TraceFilePath.DirectoryCreate();
+    }
+    trace_file = fopen(TraceFilePath, "wb");
+    if (trace_file == nullptr)
+    {
+        WriteTrace(TraceGlitch, TraceWarning, "Failed to open %s", (const char *)TraceFilePath);
+        return;
+    }
+    trace_calls = g_ModuleLogLevel[TraceGlitch] >= TraceVerbose;
+
+    HEADLESS_RECORD header = { 0x524C4448, { HEADLESS_TRACE_VERSION, (uint32_t)g_width, (uint32_t)g_height } }; // "HDLR"
+    trace_write(&header, 1);
+}
+
+static void end_frame()
+{
+    record(HeadlessOp_FrameStats, frame_stats.batches, frame_stats.triangles, frame_stats.tex_upload_bytes);
+    HEADLESS_RECORD frame = { HeadlessOp_Frame, { frame_number, frame_stats.state_changes, frame_checksum } };
+    trace_write(trace_buffer, trace_count);
+    trace_write(&frame, 1);
+    trace_count = 0;
+
+    WriteTrace(TraceGlitch, TraceDebug, "frame %d: %d batches, %d triangles, %d uploads, checksum %08X", frame_number, frame_stats.batches, frame_stats.triangles, frame_stats.tex_uploads, frame_checksum);
+    run_checksum = fnv1a(run_checksum, &frame_checksum, sizeof(frame_checksum));
+    add_stats(run_stats, frame_stats);
+    last_frame_stats = frame_stats;
+    memset(&frame_stats, 0, sizeof(frame_stats));
+    frame_checksum = 2166136261u;
+    state_dirty = false;
+    frame_number += 1;
+}
+
+void setPattern()
+{
+}
+
+#ifdef ANDROID
+void vbo_disable()
+{
+}
+#endif
+
+void gfxGetDrawStats(gfxDrawStats_t *stats)
+{
+    stats->batches = last_frame_stats.batches;
+    stats->triangles = last_frame_stats.triangles;
+    stats->state_flushes = last_frame_stats.state_flushes;
+}
+
+bool gfxSstWinOpen(gfxColorFormat_t color_format, gfxOriginLocation_t origin_location, int nColBuffers, int nAuxBuffers)
+{
+    WriteTrace(TraceGlitch, TraceDebug, "color_format: %d, origin_location: %d, nColBuffers: %d, nAuxBuffers: %d", color_format, origin_location, nColBuffers, nAuxBuffers);
+
+    // No surface ever reports a size when running headless
+    if (g_width <= 0 || g_height <= 0)
+    {
+        g_width = HEADLESS_DEFAULT_WIDTH;
+        g_height = HEADLESS_DEFAULT_HEIGHT;
+#ifdef ANDROID
+        g_ScreenWidth = g_width;
+        g_ScreenHeight = g_height;
+#endif
+        g_scr_res_x = g_res_x = g_width;
+        g_scr_res_y = g_res_y = g_height;
+    }
+    g_viewport_offset = 0;
+    nbTextureUnits = 4;
+
+    free(color_buffer);
+    free(depth_buffer);
+    color_buffer = (uint16_t *)calloc(g_width * g_height * 2, sizeof(uint16_t)); // Room for a 32 bit lock
+    depth_buffer = (uint16_t *)calloc(g_width * g_height, sizeof(uint16_t));
+    if (color_buffer == nullptr || depth_buffer == nullptr)
+    {
+        return false;
+    }
+
+    memset(&frame_stats, 0, sizeof(frame_stats));
+    memset(&last_frame_stats, 0, sizeof(last_frame_stats));
+    memset(&run_stats, 0, sizeof(run_stats));
+    frame_checksum = run_checksum = 2166136261u;
+    frame_number = 0;
+    state_dirty = false;
+    trace_open();
+    printf("(II) Headless renderer %dx%d\n", g_width, g_height);
+    return true;
+}
+
+bool gfxSstWinClose()
+{
+    WriteTrace(TraceGlitch, TraceDebug, "-");
+    if (color_buffer == nullptr)
+    {
+        return true;
+    }
+
+    printf("(II) Headless renderer: %d frames, %d batches, %d triangles, %d state changes, %d texture uploads (%d KB), checksum %08X\n",
+        frame_number, run_stats.batches, run_stats.triangles, run_stats.state_changes, run_stats.tex_uploads, run_stats.tex_upload_bytes / 1024, run_checksum);
+    WriteTrace(TraceGlitch, TraceInfo, "%d frames, %d batches, %d triangles, %d lines, %d state changes (%d flushes), %d texture sources, %d texture uploads (%d bytes), %d lfb reads, %d lfb writes, %d clears, checksum %08X",
+        frame_number, run_stats.batches, run_stats.triangles, run_stats.lines, run_stats.state_changes, run_stats.state_flushes, run_stats.tex_sources, run_stats.tex_uploads, run_stats.tex_upload_bytes,
+        run_stats.lfb_reads, run_stats.lfb_writes, run_stats.clears, run_checksum);
+
+    if (trace_file != nullptr)
+    {
+        fclose(trace_file);
+        trace_file = nullptr;
+    }
+    free(trace_buffer);
+    trace_buffer = nullptr;
+    trace_count = trace_size = 0;
+    free(color_buffer);
+    free(depth_buffer);
+    color_buffer = depth_buffer = nullptr;
+    return true;
+}
+
+void gfxClipWindow(uint32_t minx, uint32_t miny, uint32_t maxx, uint32_t maxy)
+{
+    record_state(HeadlessOp_ClipWindow, minx | (miny << 16), maxx | (maxy << 16), 0);
+}
+
+void gfxColorMask(bool rgb, bool a)
+{
+    record_state(HeadlessOp_ColorMask, rgb, a, 0);
+}
+
+void gfxTextureBufferExt(gfxChipID_t tmu, uint32_t startAddress, gfxLOD_t lodmin, gfxLOD_t lodmax, gfxAspectRatio_t aspect, gfxTextureFormat_t fmt, uint32_t evenOdd)
+{
+    record_state(HeadlessOp_TextureBuffer, tmu | (evenOdd << 8), startAddress, (lodmin & 0xFF) | ((lodmax & 0xFF) << 8) | ((aspect & 0xFF) << 16) | ((fmt & 0xFF) << 24));
+}
+
+uint32_t gfxTexMinAddress(gfxChipID_t /*tmu*/)
+{
+    return 0;
+}
+
+uint32_t gfxTexMaxAddress(gfxChipID_t /*tmu*/)
+{
+    return HEADLESS_TMU_SIZE * 2 - 1;
+}
+
+static uint32_t tex_mem_required(gfxLOD_t lod, gfxAspectRatio_t aspect, gfxTextureFormat_t fmt)
+{
+    int width, height;
+    if (aspect < 0)
+    {
+        height = 1 << lod;
+        width = height >> -aspect;
+    }
+    else
+    {
+        width = 1 << lod;
+        height = width >> aspect;
+    }
+
+    switch (fmt)
+    {
+    case GFX_TEXFMT_ALPHA_8:
+    case GFX_TEXFMT_INTENSITY_8:
+    case GFX_TEXFMT_ALPHA_INTENSITY_44:
+        return width*height;
+    case GFX_TEXFMT_ARGB_1555:
+    case GFX_TEXFMT_ARGB_4444:
+    case GFX_TEXFMT_ALPHA_INTENSITY_88:
+    case GFX_TEXFMT_RGB_565:
+        return (width*height) << 1;
+    case GFX_TEXFMT_ARGB_8888:
+        return (width*height) << 2;
+    case GFX_TEXFMT_ARGB_CMP_DXT1:
+        return ((((width + 0x3)&~0x3)*((height + 0x3)&~0x3)) >> 1);
+    case GFX_TEXFMT_ARGB_CMP_DXT3:
+    case GFX_TEXFMT_ARGB_CMP_DXT5:
+        return ((width + 0x3)&~0x3)*((height + 0x3)&~0x3);
+    case GFX_TEXFMT_ARGB_CMP_FXT1:
+        return ((((width + 0x7)&~0x7)*((height + 0x3)&~0x3)) >> 1);
+    default:
+        WriteTrace(TraceGlitch, TraceWarning, "Unknown texture format: %x", fmt);
+    }
+    return 0;
+}
+
+uint32_t gfxTexTextureMemRequired(uint32_t /*evenOdd*/, gfxTexInfo *info)
+{
+    return tex_mem_required(info->largeLodLog2, info->aspectRatioLog2, info->format);
+}
+
+uint32_t gfxTexCalcMemRequired(gfxLOD_t /*lodmin*/, gfxLOD_t lodmax, gfxAspectRatio_t aspect, gfxTextureFormat_t fmt)
+{
+    return tex_mem_required(lodmax, aspect, fmt);
+}
+
+void gfxConstantColorValue(gfxColor_t value)
+{
+    record_state(HeadlessOp_ConstantColor, value, 0, 0);
+}
+
+void gfxColorCombine(gfxCombineFunction_t function, gfxCombineFactor_t factor, gfxCombineLocal_t local, gfxCombineOther_t other, bool invert)
+{
+    record_state(HeadlessOp_ColorCombine, function, factor, (local & 0xFF) | ((other & 0xFF) << 8) | (invert << 16));
+}
+
+void gfxAlphaCombine(gfxCombineFunction_t function, gfxCombineFactor_t factor, gfxCombineLocal_t local, gfxCombineOther_t other, bool invert)
+{
+    record_state(HeadlessOp_AlphaCombine, function, factor, (local & 0xFF) | ((other & 0xFF) << 8) | (invert << 16));
+}
+
+void gfxTexCombine(gfxChipID_t tmu, gfxCombineFunction_t rgb_function, gfxCombineFactor_t rgb_factor, gfxCombineFunction_t alpha_function, gfxCombineFactor_t alpha_factor, bool rgb_invert, bool alpha_invert)
+{
+    record_state(HeadlessOp_TexCombine, tmu | (rgb_invert << 8) | (alpha_invert << 9), (rgb_function & 0xFFFF) | (rgb_factor << 16), (alpha_function & 0xFFFF) | (alpha_factor << 16));
+}
+
+void gfxAlphaBlendFunction(gfxAlphaBlendFnc_t rgb_sf, gfxAlphaBlendFnc_t rgb_df, gfxAlphaBlendFnc_t alpha_sf, gfxAlphaBlendFnc_t alpha_df)
+{
+    record_state(HeadlessOp_AlphaBlend, (rgb_sf & 0xFFFF) | (rgb_df << 16), (alpha_sf & 0xFFFF) | (alpha_df << 16), 0);
+}
+
+void gfxAlphaTestReferenceValue(gfxAlpha_t value)
+{
+    record_state(HeadlessOp_AlphaTestReference, value, 0, 0);
+}
+
+void gfxAlphaTestFunction(gfxCmpFnc_t function)
+{
+    record_state(HeadlessOp_AlphaTestFunction, function, 0, 0);
+}
+
+void gfxFogMode(gfxFogMode_t mode)
+{
+    record_state(HeadlessOp_FogMode, mode, 0, 0);
+}
+
+void gfxFogGenerateLinear(float nearZ, float farZ)
+{
+    record_state(HeadlessOp_FogTable, float_bits(nearZ), float_bits(farZ), 0);
+}
+
+void gfxFogColorValue(gfxColor_t fogcolor)
+{
+    record_state(HeadlessOp_FogColor, fogcolor, 0, 0);
+}
+
+void gfxChromakeyMode(gfxChromakeyMode_t mode)
+{
+    record_state(HeadlessOp_ChromakeyMode, mode, 0, 0);
+}
+
+void gfxChromakeyValue(gfxColor_t value)
+{
+    record_state(HeadlessOp_ChromakeyValue, value, 0, 0);
+}
+
+void gfxStippleMode(gfxStippleMode_t mode)
+{
+    record_state(HeadlessOp_StippleMode, mode, 0, 0);
+}
+
+static inline uint32_t pack_combine_ext(uint32_t a, uint32_t a_mode, uint32_t b, uint32_t b_mode)
+{
+    return (a & 0xFF) | ((a_mode & 0xFF) << 8) | ((b & 0xFF) << 16) | ((b_mode & 0xFF) << 24);
+}
+
+void gfxColorCombineExt(gfxCCUColor_t a, gfxCombineMode_t a_mode, gfxCCUColor_t b, gfxCombineMode_t b_mode, gfxCCUColor_t c, bool c_invert, gfxCCUColor_t d, bool d_invert, uint32_t shift, bool invert)
+{
+    record_state(HeadlessOp_ColorCombineExt, pack_combine_ext(a, a_mode, b, b_mode), pack_combine_ext(c, c_invert, d, d_invert), shift | (invert << 8));
+}
+
+void gfxAlphaCombineExt(gfxACUColor_t a, gfxCombineMode_t a_mode, gfxACUColor_t b, gfxCombineMode_t b_mode, gfxACUColor_t c, bool c_invert, gfxACUColor_t d, bool d_invert, uint32_t shift, bool invert)
+{
+    record_state(HeadlessOp_AlphaCombineExt, pack_combine_ext(a, a_mode, b, b_mode), pack_combine_ext(c, c_invert, d, d_invert), shift | (invert << 8));
+}
+
+void gfxTexColorCombineExt(gfxChipID_t tmu, gfxTCCUColor_t a, gfxCombineMode_t a_mode, gfxTCCUColor_t b, gfxCombineMode_t b_mode, gfxTCCUColor_t c, bool c_invert, gfxTCCUColor_t d, bool d_invert, uint32_t shift, bool invert)
+{
+    record_state(HeadlessOp_TexColorCombineExt, pack_combine_ext(a, a_mode, b, b_mode), pack_combine_ext(c, c_invert, d, d_invert), shift | (invert << 8) | (tmu << 16));
+}
+
+void gfxTexAlphaCombineExt(gfxChipID_t tmu, gfxTACUColor_t a, gfxCombineMode_t a_mode, gfxTACUColor_t b, gfxCombineMode_t b_mode, gfxTACUColor_t c, bool c_invert, gfxTACUColor_t d, bool d_invert, uint32_t shift, bool invert)
+{
+    record_state(HeadlessOp_TexAlphaCombineExt, pack_combine_ext(a, a_mode, b, b_mode), pack_combine_ext(c, c_invert, d, d_invert), shift | (invert << 8) | (tmu << 16));
+}
+
+void gfxConstantColorValueExt(gfxChipID_t tmu, gfxColor_t value)
+{
+    record_state(HeadlessOp_ConstantColorExt, tmu, value, 0);
+}
+
+void gfxCullMode(gfxCullMode_t mode)
+{
+    record_state(HeadlessOp_CullMode, mode, 0, 0);
+}
+
+void gfxDepthBufferMode(gfxDepthBufferMode_t mode)
+{
+    record_state(HeadlessOp_DepthBufferMode, mode, 0, 0);
+}
+
+void gfxDepthBufferFunction(gfxCmpFnc_t function)
+{
+    record_state(HeadlessOp_DepthBufferFunction, function, 0, 0);
+}
+
+void gfxDepthMask(bool mask)
+{
+    record_state(HeadlessOp_DepthMask, mask, 0, 0);
+}
+
+void gfxDepthBiasLevel(int32_t level)
+{
+    record_state(HeadlessOp_DepthBias, (uint32_t)level, 0, 0);
+}
+
+void gfxDrawTriangle(const gfxVERTEX *a, const gfxVERTEX *b, const gfxVERTEX *c)
+{
+    uint32_t hash = vertex_hash(vertex_hash(vertex_hash(2166136261u, a), b), c);
+    record_draw(HeadlessOp_Triangle, GFX_TRIANGLES, 3, hash, 1);
+}
+
+void gfxDrawLine(const gfxVERTEX *a, const gfxVERTEX *b)
+{
+    uint32_t hash = vertex_hash(vertex_hash(2166136261u, a), b);
+    frame_stats.lines += 1;
+    record_draw(HeadlessOp_Line, GFX_LINES, 2, hash, 0);
+}
+
+void gfxDrawVertexArray(gfxDrawMode_t mode, uint32_t Count, void *pointers2)
+{
+    gfxVERTEX **pointers = (gfxVERTEX **)pointers2;
+    uint32_t hash = 2166136261u;
+    for (uint32_t i = 0; i < Count; i++)
+    {
+        hash = vertex_hash(hash, pointers[i]);
+    }
+    record_draw(HeadlessOp_VertexArray, mode, Count, hash, mode_triangles(mode, Count));
+}
+
+void gfxDrawVertexArrayContiguous(gfxDrawMode_t mode, uint32_t Count, void *pointers, uint32_t stride)
+{
+    const uint8_t *vertex = (const uint8_t *)pointers;
+    uint32_t hash = 2166136261u;
+    for (uint32_t i = 0; i < Count; i++, vertex += stride)
+    {
+        hash = vertex_hash(hash, (const gfxVERTEX *)vertex);
+    }
+    record_draw(HeadlessOp_VertexArray, mode, Count, hash, mode_triangles(mode, Count));
+}
+
+void gfxAuxBufferExt(gfxBuffer_t buffer)
+{
+    record_state(HeadlessOp_AuxBuffer, buffer, 0, 0);
+}
+
+void gfxRenderBuffer(gfxBuffer_t buffer)
+{
+    record_state(HeadlessOp_RenderBuffer, buffer, 0, 0);
+}
+
+void gfxBufferClear(gfxColor_t color, gfxAlpha_t alpha, uint32_t depth)
+{
+    // Clears come in as RGBA, the lfb keeps 565
+    uint16_t color565 = (uint16_t)((((color >> 24) & 0xF8) << 8) | (((color >> 16) & 0xFC) << 3) | ((color >> 11) & 0x1F));
+    for (int i = 0, n = g_width * g_height; i < n; i++)
+    {
+        color_buffer[i] = color565;
+        depth_buffer[i] = (uint16_t)depth;
+    }
+    frame_stats.clears += 1;
+    record(HeadlessOp_BufferClear, color, alpha, depth);
+}
+
+void gfxBufferSwap(uint32_t swap_interval)
+{
+    WriteTrace(TraceGlitch, TraceDebug, "swap_interval: %d", swap_interval);
+    end_frame();
+}
+
+bool gfxLfbLock(gfxLock_t type, gfxBuffer_t buffer, gfxLfbWriteMode_t writeMode, gfxOriginLocation_t origin, bool pixelPipeline, gfxLfbInfo_t *info)
+{
+    WriteTrace(TraceGlitch, TraceDebug, "type: %d buffer: %d writeMode: %d origin: %d pixelPipeline: %d", type, buffer, writeMode, origin, pixelPipeline);
+    if (buffer == GFX_BUFFER_AUXBUFFER)
+    {
+        info->lfbPtr = depth_buffer;
+        info->strideInBytes = g_width * 2;
+        info->writeMode = GFX_LFBWRITEMODE_ZA16;
+    }
+    else
+    {
+        info->lfbPtr = color_buffer;
+        info->strideInBytes = writeMode == GFX_LFBWRITEMODE_888 ? g_width * 4 : g_width * 2;
+        info->writeMode = writeMode == GFX_LFBWRITEMODE_888 ? GFX_LFBWRITEMODE_888 : GFX_LFBWRITEMODE_565;
+    }
+    info->origin = origin;
+    record(HeadlessOp_LfbLock, type, buffer, writeMode);
+    return true;
+}
+
+bool gfxLfbUnlock(gfxLock_t type, gfxBuffer_t buffer)
+{
+    WriteTrace(TraceGlitch, TraceDebug, "type: %d, buffer: %d", type, buffer);
+    return true;
+}
+
+bool gfxLfbReadRegion(gfxBuffer_t src_buffer, uint32_t src_x, uint32_t src_y, uint32_t src_width, uint32_t src_height, uint32_t dst_stride, void *dst_data)
+{
+    WriteTrace(TraceGlitch, TraceDebug, "src_buffer: %d src_x: %d src_y: %d src_width: %d src_height: %d dst_stride: %d", src_buffer, src_x, src_y, src_width, src_height, dst_stride);
+    const uint16_t * src = src_buffer == GFX_BUFFER_AUXBUFFER ? depth_buffer : color_buffer;
+    uint8_t * dst = (uint8_t *)dst_data;
+    for (uint32_t j = 0; j < src_height; j++, dst += dst_stride)
+    {
+        uint32_t y = src_y + j;
+        uint32_t width = src_x < (uint32_t)g_width ? src_width : 0;
+        if (src_x + width > (uint32_t)g_width)
+        {
+            width = g_width - src_x;
+        }
+        if (y >= (uint32_t)g_height)
+        {
+            width = 0;
+        }
+        memcpy(dst, &src[y * g_width + src_x], width * 2);
+        memset(dst + width * 2, 0, (src_width - width) * 2);
+    }
+    frame_stats.lfb_reads += 1;
+    record(HeadlessOp_LfbRead, src_buffer, src_x | (src_y << 16), src_width | (src_height << 16));
+    return true;
+}
+
+bool gfxLfbWriteRegion(gfxBuffer_t dst_buffer, uint32_t dst_x, uint32_t dst_y, gfxLfbSrcFmt_t src_format, uint32_t src_width, uint32_t src_height, bool pixelPipeline, int32_t src_stride, void *src_data)
+{
+    WriteTrace(TraceGlitch, TraceDebug, "dst_buffer: %d dst_x: %d dst_y: %d src_format: %d src_width: %d src_height: %d pixelPipeline: %d src_stride: %d", dst_buffer, dst_x, dst_y, src_format, src_width, src_height, pixelPipeline, src_stride);
+    uint16_t * dst = dst_buffer == GFX_BUFFER_AUXBUFFER ? depth_buffer : color_buffer;
+    bool wide = src_format == GFX_LFB_SRC_FMT_888 || src_format == GFX_LFB_SRC_FMT_8888;
+    const uint8_t * src = (const uint8_t *)src_data;
+    uint32_t hash = 2166136261u;
+    for (uint32_t j = 0; j < src_height; j++, src += src_stride)
+    {
+        hash = fnv1a(hash, src, src_width * (wide ? 4 : 2));
+        uint32_t y = dst_y + j;
+        if (y >= (uint32_t)g_height)
+        {
+            continue;
+        }
+        for (uint32_t i = 0; i < src_width && dst_x + i < (uint32_t)g_width; i++)
+        {
+            uint16_t pixel;
+            if (wide)
+            {
+                uint32_t col;
+                memcpy(&col, src + i * 4, sizeof(col));
+                pixel = (uint16_t)((((col >> 16) & 0xF8) << 8) | (((col >> 8) & 0xFC) << 3) | ((col & 0xF8) >> 3));
+            }
+            else
+            {
+                memcpy(&pixel, src + i * 2, sizeof(pixel));
+            }
+            dst[y * g_width + dst_x + i] = pixel;
+        }
+    }
+    frame_stats.lfb_writes += 1;
+    record(HeadlessOp_LfbWrite, dst_buffer | (src_format << 8), dst_x | (dst_y << 16), hash);
+    return true;
+}
+
+void gfxLoadGammaTable(uint32_t /*nentries*/, uint32_t * /*red*/, uint32_t * /*green*/, uint32_t * /*blue*/)
+{
+}
+
+void gfxGetGammaTableExt(uint32_t nentries, uint32_t *red, uint32_t *green, uint32_t *blue)
+{
+    for (uint32_t i = 0; i < nentries; i++)
+    {
+        red[i] = green[i] = blue[i] = nentries > 1 ? i * 255 / (nentries - 1) : 0;
+    }
+}
+
+void gfxGammaCorrectionRGB(float /*gammaR*/, float /*gammaG*/, float /*gammaB*/)
+{
+}
+
+void gfxTexDownloadMipMap(gfxChipID_t tmu, uint32_t startAddress, gfxMipMapLevelMask_t evenOdd, gfxTexInfo *info)
+{
+    uint32_t size = gfxTexTextureMemRequired(evenOdd, info);
+    uint32_t hash = fnv1a(2166136261u, info->data, size);
+    frame_stats.tex_uploads += 1;
+    frame_stats.tex_upload_bytes += size;
+    record(HeadlessOp_TexDownload, tmu | ((info->format & 0xFF) << 8) | ((info->largeLodLog2 & 0xFF) << 16) | ((info->aspectRatioLog2 & 0xFF) << 24), startAddress, hash);
+}
+
+void gfxTexSource(gfxChipID_t tmu, uint32_t startAddress, uint32_t evenOdd, gfxTexInfo *info)
+{
+    frame_stats.tex_sources += 1;
+    record_state(HeadlessOp_TexSource, tmu | (evenOdd << 8), startAddress, (info->format & 0xFF) | ((info->largeLodLog2 & 0xFF) << 8) | ((info->aspectRatioLog2 & 0xFF) << 16));
+}
+
+void gfxTexDetailControl(gfxChipID_t tmu, int lod_bias, uint8_t detail_scale, float detail_max)
+{
+    record_state(HeadlessOp_TexDetail, tmu | (detail_scale << 8), (uint32_t)lod_bias, float_bits(detail_max));
+}
+
+void gfxTexClampMode(gfxChipID_t tmu, gfxTextureClampMode_t s_clampmode, gfxTextureClampMode_t t_clampmode)
+{
+    record_state(HeadlessOp_TexClamp, tmu, s_clampmode, t_clampmode);
+}
+
+void gfxTexFilterMode(gfxChipID_t tmu, gfxTextureFilterMode_t minfilter_mode, gfxTextureFilterMode_t magfilter_mode)
+{
+    record_state(HeadlessOp_TexFilter, tmu, minfilter_mode, magfilter_mode);
+}
@@ -475,6 +475,8 @@ void disable_textureSizes()
 
 void compile_shader()
 {
+    // Switching program and setting its uniforms both apply to the triangles still buffered
+    vbo_draw();
     need_to_compile = 0;
 
     for (size_t i = 0; i < g_shader_programs.size(); i++)
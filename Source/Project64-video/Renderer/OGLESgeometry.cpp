@@ -26,38 +26,97 @@ static gfxVERTEX vertex_buffer[VERTEX_BUFFER_SIZE];
 static int vertex_buffer_count = 0;
 static GLenum vertex_draw_mode;
 static bool vertex_buffer_enabled = false;
+static gfxDrawStats_t draw_stats, frame_draw_stats;
 
-void vbo_draw()
+static void vbo_flush()
 {
     if (vertex_buffer_count)
     {
         WriteTrace(TraceGlide64, TraceDebug, "Vertex_draw_mode: %d vertex_buffer_count: %d", vertex_draw_mode, vertex_buffer_count);
         glDrawArrays(vertex_draw_mode, 0, vertex_buffer_count);
+        draw_stats.batches++;
+        draw_stats.triangles += vertex_draw_mode == GL_TRIANGLES ? vertex_buffer_count / 3 : vertex_buffer_count - 2;
         vertex_buffer_count = 0;
         WriteTrace(TraceGlide64, TraceDebug, "Done (glGetError() = %X)", glGetError());
     }
 }
 
-// Buffer vertices instead of glDrawArrays(...)
-void vbo_buffer(GLenum mode, GLint first, GLsizei count, void* pointers)
+// Called before any render state changes, the triangles buffered so far were
+// set up for the old state
+void vbo_draw()
 {
-    if ((count != 3 && mode != GL_TRIANGLES) || vertex_buffer_count + count > VERTEX_BUFFER_SIZE)
+    if (vertex_buffer_count)
     {
-        vbo_draw();
+        draw_stats.state_flushes++;
+        vbo_flush();
     }
+}
+
+void end_frame_geometry()
+{
+    vbo_flush();
+    frame_draw_stats = draw_stats;
+    memset(&draw_stats, 0, sizeof(draw_stats));
+}
 
-    memcpy(&vertex_buffer[vertex_buffer_count], pointers, count * VERTEX_SIZE);
-    vertex_buffer_count += count;
+void gfxGetDrawStats(gfxDrawStats_t *stats)
+{
+    *stats = frame_draw_stats;
+}
 
-    if (count == 3 || mode == GL_TRIANGLES)
+// Buffer vertices instead of glDrawArrays(...). Fans and strips are split into
+// separate triangles so they join the same batch as the triangles around them.
+void vbo_buffer(GLenum mode, GLint first, GLsizei count, void* pointers)
+{
+    const gfxVERTEX * v = (const gfxVERTEX *)pointers + first;
+    int triangles = mode == GL_TRIANGLES ? count / 3 : count - 2;
+    if (triangles <= 0)
     {
-        vertex_draw_mode = GL_TRIANGLES;
+        return;
     }
-    else
+
+    if (triangles * 3 > VERTEX_BUFFER_SIZE)
     {
+        // Too big to split, draw it on its own
+        vbo_flush();
+        memcpy(&vertex_buffer[0], v, count * VERTEX_SIZE);
+        vertex_buffer_count = count;
         vertex_draw_mode = mode;
-        vbo_draw(); // Triangle fans and strips can't be joined as easily, just draw them straight away
+        vbo_flush();
+        return;
+    }
+
+    if (vertex_buffer_count + triangles * 3 > VERTEX_BUFFER_SIZE)
+    {
+        vbo_flush();
+    }
+    vertex_draw_mode = GL_TRIANGLES;
+
+    gfxVERTEX * out = &vertex_buffer[vertex_buffer_count];
+    switch (mode)
+    {
+    case GL_TRIANGLE_FAN:
+        for (int i = 0; i < triangles; i++, out += 3)
+        {
+            memcpy(&out[0], &v[0], VERTEX_SIZE);
+            memcpy(&out[1], &v[i + 1], VERTEX_SIZE);
+            memcpy(&out[2], &v[i + 2], VERTEX_SIZE);
+        }
+        break;
+    case GL_TRIANGLE_STRIP:
+        // Every other triangle of a strip is wound the other way round
+        for (int i = 0; i < triangles; i++, out += 3)
+        {
+            memcpy(&out[0], &v[(i & 1) ? i + 1 : i], VERTEX_SIZE);
+            memcpy(&out[1], &v[(i & 1) ? i : i + 1], VERTEX_SIZE);
+            memcpy(&out[2], &v[i + 2], VERTEX_SIZE);
+        }
+        break;
+    default:
+        memcpy(out, v, triangles * 3 * VERTEX_SIZE);
+        break;
     }
+    vertex_buffer_count += triangles * 3;
 }
 
 void vbo_enable()
@@ -271,7 +330,7 @@ void gfxDrawTriangle(const gfxVERTEX *a, const gfxVERTEX *b, const gfxVERTEX *c)
 
     if (vertex_buffer_count + 3 > VERTEX_BUFFER_SIZE)
     {
-        vbo_draw();
+        vbo_flush();
     }
     vertex_draw_mode = GL_TRIANGLES;
     memcpy(&vertex_buffer[vertex_buffer_count], a, VERTEX_SIZE);
@@ -1182,7 +1182,7 @@ void gfxBufferSwap(uint32_t swap_interval)
 {
     //   GLuint program;
 
-    vbo_draw();
+    end_frame_geometry();
     //	glFinish();
     //  printf("rendercallback is %p\n", renderCallback);
     //if (renderCallback) {
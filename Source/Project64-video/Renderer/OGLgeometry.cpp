@@ -9,6 +9,7 @@
 #include <Project64-video/rdp.h>
 #include <Project64-video/Settings.h>
 #include <stdio.h>
+#include <string.h>
 #ifdef _WIN32
 #include <windows.h>
 #endif // _WIN32
@@ -30,6 +31,9 @@ int inverted_culling;
 gfxCullMode_t culling_mode;
 extern int fog_enabled;
 
+// Immediate mode, every draw is its own batch
+static gfxDrawStats_t draw_stats, frame_draw_stats;
+
 inline float ZCALC(const float & z, const float & q) {
     float res = ((z) / Z_MAX) / (q);
     return res;
@@ -60,6 +64,17 @@ void init_geometry()
     grDisplayGLError("init_geometry");
 }
 
+void end_frame_geometry()
+{
+    frame_draw_stats = draw_stats;
+    memset(&draw_stats, 0, sizeof(draw_stats));
+}
+
+void gfxGetDrawStats(gfxDrawStats_t *stats)
+{
+    *stats = frame_draw_stats;
+}
+
 void gfxCullMode(gfxCullMode_t mode)
 {
     WriteTrace(TraceGlitch, TraceDebug, "mode: %d", mode);
@@ -304,6 +319,8 @@ void gfxDrawTriangle(const gfxVERTEX *a, const gfxVERTEX *b, const gfxVERTEX *c)
     if (need_to_compile) compile_shader();
 
     glBegin(GL_TRIANGLES);
+    draw_stats.batches++;
+    draw_stats.triangles++;
 
     if (nbTextureUnits > 2)
     {
@@ -477,6 +494,8 @@ void gfxDrawVertexArray(gfxDrawMode_t mode, uint32_t Count, void *pointers2)
     default:
         WriteTrace(TraceGlitch, TraceWarning, "gfxDrawVertexArray: Unknown mode : %x", mode);
     }
+    draw_stats.batches++;
+    draw_stats.triangles += Count > 2 ? Count - 2 : 0;
 
     for (i = 0; i < Count; i++)
     {
@@ -544,6 +563,8 @@ void gfxDrawVertexArrayContiguous(gfxDrawMode_t mode, uint32_t Count, void *poin
     default:
         WriteTrace(TraceGlitch, TraceWarning, "gfxDrawVertexArrayContiguous: Unknown mode : %x", mode);
     }
+    draw_stats.batches++;
+    draw_stats.triangles += Count > 2 ? Count - 2 : 0;
 
     for (i = 0; i < Count; i++)
     {
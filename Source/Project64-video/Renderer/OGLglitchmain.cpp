@@ -1460,6 +1460,7 @@ void gfxBufferSwap(uint32_t swap_interval)
         WriteTrace(TraceGlitch, TraceWarning, "Swap while render_to_texture\n");
         return;
     }
+    end_frame_geometry();
 
 #ifdef _WIN32
     SwapBuffers(wglGetCurrentDC());
@@ -42,6 +42,7 @@ void gfxDepthBiasLevel(int32_t level);
 void gfxDrawLine(const gfxVERTEX *a, const gfxVERTEX *b);
 void gfxDrawVertexArray(gfxDrawMode_t mode, uint32_t Count, void *pointers2);
 void gfxDrawVertexArrayContiguous(gfxDrawMode_t mode, uint32_t Count, void *pointers, uint32_t stride);
+void gfxGetDrawStats(gfxDrawStats_t *stats); // Counts for the last frame swapped
 
 bool gfxSstWinOpen(gfxColorFormat_t color_format, gfxOriginLocation_t origin_location, int nColBuffers, int nAuxBuffers);
 void gfxAuxBufferExt(gfxBuffer_t buffer);
@@ -88,6 +88,7 @@ extern "C" {
 #endif
 
 void init_geometry();
+void end_frame_geometry();
 void init_textures();
 void init_combiner();
 void free_textures();
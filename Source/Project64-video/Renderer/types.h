@@ -398,4 +398,11 @@ typedef struct
 
     int   number;   // Way to identify it
     int   scr_off, z_off; // Off the screen?
-} gfxVERTEX;
\ No newline at end of file
+} gfxVERTEX;
+
+typedef struct
+{
+    uint32_t batches;       // Draw calls handed to the driver
+    uint32_t triangles;     // Triangles in those draw calls
+    uint32_t state_flushes; // Batches ended early because render state changed
+} gfxDrawStats_t;
\ No newline at end of file
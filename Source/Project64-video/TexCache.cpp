@@ -55,47 +55,52 @@ typedef struct HIRESTEX_t
 } HIRESTEX;
 
 //****************************************************************
-// List functions
+// Cache index
+//
+// Open addressed on the texture CRC with linear probing. Entries are only added until
+// ClearCache empties the index, which it does by moving to the next generation rather
+// than touching every slot. The index holds at most MAX_CACHE entries so it never gets
+// more than a quarter full.
 
 typedef struct NODE_t {
     uint32_t	crc;
+    uint32_t	generation;
     uintptr_t	data;
     int		tmu;
     int		number;
-    NODE_t	*pNext;
 } NODE;
 
-NODE *cachelut[65536];
+enum { CACHE_INDEX_BITS = 14, CACHE_INDEX_SIZE = 1 << CACHE_INDEX_BITS };
 
-void AddToList(NODE **list, uint32_t crc, uintptr_t data, int tmu, int number)
+NODE cache_index[CACHE_INDEX_SIZE];
+uint32_t cache_generation = 1;
+
+static inline uint32_t CacheIndexSlot(uint32_t crc)
+{
+    return (crc * 0x9E3779B1) >> (32 - CACHE_INDEX_BITS);
+}
+
+void AddToList(uint32_t crc, uintptr_t data, int tmu, int number)
 {
-    NODE *node = new NODE;
+    uint32_t slot = CacheIndexSlot(crc);
+    while (cache_index[slot].generation == cache_generation)
+    {
+        slot = (slot + 1) & (CACHE_INDEX_SIZE - 1);
+    }
+    NODE *node = &cache_index[slot];
     node->crc = crc;
+    node->generation = cache_generation;
     node->data = data;
     node->tmu = tmu;
     node->number = number;
-    node->pNext = *list;
-    *list = node;
     rdp.n_cached[tmu] ++;
     rdp.n_cached[tmu ^ 1] = rdp.n_cached[tmu];
 }
 
-void DeleteList(NODE **list)
-{
-    while (*list)
-    {
-        NODE *next = (*list)->pNext;
-        delete (*list);
-        *list = next;
-    }
-}
-
 void TexCacheInit()
 {
-    for (int i = 0; i < 65536; i++)
-    {
-        cachelut[i] = nullptr;
-    }
+    memset(cache_index, 0, sizeof(cache_index));
+    cache_generation = 1;
 }
 
 //****************************************************************
@@ -108,9 +113,9 @@ void ClearCache()
     voodoo.tmem_ptr[1] = offset_textures;
     rdp.n_cached[1] = 0;
 
-    for (int i = 0; i < 65536; i++)
+    if (++cache_generation == 0)
     {
-        DeleteList(&cachelut[i]);
+        TexCacheInit();
     }
 }
 
@@ -422,10 +427,13 @@ void GetTexInfo(int id, int tile)
         modfactor = cmb.modfactor_1;
     }
 
-    NODE *node = cachelut[crc >> 16];
+    // Later entries in a probe run are newer, keep the last match so the most recently
+    // loaded copy of a texture is used
+    NODE *found = nullptr;
     uint32_t mod_mask = (rdp.tiles(tile).format == 2) ? 0xFFFFFFFF : 0xF0F0F0F0;
-    while (node)
+    for (uint32_t slot = CacheIndexSlot(crc); cache_index[slot].generation == cache_generation; slot = (slot + 1) & (CACHE_INDEX_SIZE - 1))
     {
+        NODE *node = &cache_index[slot];
         if (node->crc == crc)
         {
             cache = (CACHE_LUT*)node->data;
@@ -443,14 +451,17 @@ void GetTexInfo(int id, int tile)
                     (cache->mod_color2&mod_mask) == (modcolor2&mod_mask) &&
                     abs((int)(cache->mod_factor - modfactor)) < 8))
                 {
-                    WriteTrace(TraceRDP, TraceDebug, " | | | |- Texture found in cache (tmu=%d).", node->tmu);
-                    tex_found[id][node->tmu] = node->number;
-                    tex_found[id][node->tmu ^ 1] = node->number;
-                    return;
+                    found = node;
                 }
             }
         }
-        node = node->pNext;
+    }
+    if (found)
+    {
+        WriteTrace(TraceRDP, TraceDebug, " | | | |- Texture found in cache (tmu=%d).", found->tmu);
+        tex_found[id][found->tmu] = found->number;
+        tex_found[id][found->tmu ^ 1] = found->number;
+        return;
     }
 
     WriteTrace(TraceRDP, TraceDebug, " | | | +- Done.\n | | +- GetTexInfo end");
@@ -969,7 +980,7 @@ void LoadTex(int id, gfxChipID_t tmu)
     cache->ricecrc = texinfo[id].ricecrc;
 
     // Add this cache to the list
-    AddToList(&cachelut[cache->crc >> 16], cache->crc, uintptr_t(cache), tmu, rdp.n_cached[tmu]);
+    AddToList(cache->crc, uintptr_t(cache), tmu, rdp.n_cached[tmu]);
 
     // temporary
     cache->t_info.format = GFX_TEXFMT_ARGB_1555;
@@ -16,7 +16,6 @@ void rsp_vertex(int v0, int n)
 {
     uint32_t addr = segoffset(rdp.cmd1) & 0x00FFFFFF;
     int i;
-    float x, y, z;
 
     rdp.v0 = v0; // Current vertex
     rdp.vn = n;  // Number to copy
@@ -45,65 +44,73 @@ void rsp_vertex(int v0, int n)
 
     WriteTrace(TraceRDP, TraceDebug, "rsp:vertex v0:%d, n:%d, from: %08lx", v0, n, addr);
 
-    for (i = 0; i < (n << 4); i += 16)
+    // Positions, clip flags and directional lighting are worked out a batch at a time,
+    // the per vertex pass below only copies them out and handles fog and texgen
+    bool lighting = (rdp.geom_mode & 0x00020000) != 0;
+    VERTEX_BATCH batch;
+    for (int base = 0; base < n; base += VERTEX_BATCH_SIZE)
     {
-        gfxVERTEX &v = rdp.vtx(v0 + (i >> 4));
-        x = (float)((short*)gfx.RDRAM)[(((addr + i) >> 1) + 0) ^ 1];
-        y = (float)((short*)gfx.RDRAM)[(((addr + i) >> 1) + 1) ^ 1];
-        z = (float)((short*)gfx.RDRAM)[(((addr + i) >> 1) + 2) ^ 1];
-        v.flags = ((uint16_t*)gfx.RDRAM)[(((addr + i) >> 1) + 3) ^ 1];
-        v.ou = (float)((short*)gfx.RDRAM)[(((addr + i) >> 1) + 4) ^ 1];
-        v.ov = (float)((short*)gfx.RDRAM)[(((addr + i) >> 1) + 5) ^ 1];
-        v.uv_scaled = 0;
-        v.a = ((uint8_t*)gfx.RDRAM)[(addr + i + 15) ^ 3];
-
-        v.x = x*rdp.combined[0][0] + y*rdp.combined[1][0] + z*rdp.combined[2][0] + rdp.combined[3][0];
-        v.y = x*rdp.combined[0][1] + y*rdp.combined[1][1] + z*rdp.combined[2][1] + rdp.combined[3][1];
-        v.z = x*rdp.combined[0][2] + y*rdp.combined[1][2] + z*rdp.combined[2][2] + rdp.combined[3][2];
-        v.w = x*rdp.combined[0][3] + y*rdp.combined[1][3] + z*rdp.combined[2][3] + rdp.combined[3][3];
-
-        if (fabs(v.w) < 0.001) v.w = 0.001f;
-        v.oow = 1.0f / v.w;
-        v.x_w = v.x * v.oow;
-        v.y_w = v.y * v.oow;
-        v.z_w = v.z * v.oow;
-        CalculateFog(v);
-
-        v.uv_calculated = 0xFFFFFFFF;
-        v.screen_translated = 0;
-        v.shade_mod = 0;
-
-        v.scr_off = 0;
-        if (v.x < -v.w) v.scr_off |= 1;
-        if (v.x > v.w) v.scr_off |= 2;
-        if (v.y < -v.w) v.scr_off |= 4;
-        if (v.y > v.w) v.scr_off |= 8;
-        if (v.w < 0.1f) v.scr_off |= 16;
-        //    if (v.z_w > 1.0f) v.scr_off |= 32;
+        int count = minval(n - base, VERTEX_BATCH_SIZE);
+        load_vertex_batch(batch, addr + (base << 4), count, lighting);
+        TransformVertices(batch, count, rdp.combined);
+        if (lighting)
+        {
+            LightVertices(batch, count);
+        }
 
-        if (rdp.geom_mode & 0x00020000)
+        for (int j = 0; j < count; j++)
         {
-            v.vec[0] = ((char*)gfx.RDRAM)[(addr + i + 12) ^ 3];
-            v.vec[1] = ((char*)gfx.RDRAM)[(addr + i + 13) ^ 3];
-            v.vec[2] = ((char*)gfx.RDRAM)[(addr + i + 14) ^ 3];
-            if (rdp.geom_mode & 0x40000)
+            i = (base + j) << 4;
+            gfxVERTEX &v = rdp.vtx(v0 + base + j);
+            v.flags = ((uint16_t*)gfx.RDRAM)[(((addr + i) >> 1) + 3) ^ 1];
+            v.ou = (float)((short*)gfx.RDRAM)[(((addr + i) >> 1) + 4) ^ 1];
+            v.ov = (float)((short*)gfx.RDRAM)[(((addr + i) >> 1) + 5) ^ 1];
+            v.uv_scaled = 0;
+            v.a = ((uint8_t*)gfx.RDRAM)[(addr + i + 15) ^ 3];
+
+            v.x = batch.vx[j];
+            v.y = batch.vy[j];
+            v.z = batch.vz[j];
+            v.w = batch.vw[j];
+            v.oow = batch.oow[j];
+            v.x_w = batch.x_w[j];
+            v.y_w = batch.y_w[j];
+            v.z_w = batch.z_w[j];
+            CalculateFog(v);
+
+            v.uv_calculated = 0xFFFFFFFF;
+            v.screen_translated = 0;
+            v.shade_mod = 0;
+            v.scr_off = batch.scr_off[j];
+
+            if (lighting)
             {
-                if (rdp.geom_mode & 0x80000)
-                    calc_linear(v);
-                else
-                    calc_sphere(v);
+                if (rdp.geom_mode & 0x40000)
+                {
+                    // Texgen works from the normal before it is normalized
+                    v.vec[0] = ((char*)gfx.RDRAM)[(addr + i + 12) ^ 3];
+                    v.vec[1] = ((char*)gfx.RDRAM)[(addr + i + 13) ^ 3];
+                    v.vec[2] = ((char*)gfx.RDRAM)[(addr + i + 14) ^ 3];
+                    if (rdp.geom_mode & 0x80000)
+                        calc_linear(v);
+                    else
+                        calc_sphere(v);
+                }
+                v.vec[0] = batch.nx[j];
+                v.vec[1] = batch.ny[j];
+                v.vec[2] = batch.nz[j];
+                v.r = (uint8_t)(batch.r[j] * 255.0f);
+                v.g = (uint8_t)(batch.g[j] * 255.0f);
+                v.b = (uint8_t)(batch.b[j] * 255.0f);
             }
-            NormalizeVector(v.vec);
-
-            calc_light(v);
-        }
-        else
-        {
-            v.r = ((uint8_t*)gfx.RDRAM)[(addr + i + 12) ^ 3];
-            v.g = ((uint8_t*)gfx.RDRAM)[(addr + i + 13) ^ 3];
-            v.b = ((uint8_t*)gfx.RDRAM)[(addr + i + 14) ^ 3];
+            else
+            {
+                v.r = ((uint8_t*)gfx.RDRAM)[(addr + i + 12) ^ 3];
+                v.g = ((uint8_t*)gfx.RDRAM)[(addr + i + 13) ^ 3];
+                v.b = ((uint8_t*)gfx.RDRAM)[(addr + i + 14) ^ 3];
+            }
+            WriteTrace(TraceRDP, TraceVerbose, "v%d - x: %f, y: %f, z: %f, w: %f, u: %f, v: %f, f: %f, z_w: %f, r=%d, g=%d, b=%d, a=%d", i >> 4, v.x, v.y, v.z, v.w, v.ou*rdp.tiles(rdp.cur_tile).s_scale, v.ov*rdp.tiles(rdp.cur_tile).t_scale, v.f, v.z_w, v.r, v.g, v.b, v.a);
         }
-        WriteTrace(TraceRDP, TraceVerbose, "v%d - x: %f, y: %f, z: %f, w: %f, u: %f, v: %f, f: %f, z_w: %f, r=%d, g=%d, b=%d, a=%d", i >> 4, v.x, v.y, v.z, v.w, v.ou*rdp.tiles(rdp.cur_tile).s_scale, v.ov*rdp.tiles(rdp.cur_tile).t_scale, v.f, v.z_w, v.r, v.g, v.b, v.a);
     }
 }
 